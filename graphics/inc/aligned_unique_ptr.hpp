@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>  // For SIZE_MAX, std::uintptr_t
 #include <memory>
 #include <new>  // For std::bad_alloc
 #include <type_traits>
@@ -13,18 +14,122 @@
     #define aligned_free                      std::free
 #endif
 
+#if defined( __linux__ )
+    #include <sys/mman.h>  // For mmap, munmap, madvise
+#endif
+
+/// <summary>
+/// The size of a huge page (2 MB on x86-64 and most AArch64 systems).
+/// </summary>
+inline constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+/// <summary>
+/// The default allocation policy: all buffers are allocated with aligned_malloc.
+/// </summary>
+struct default_alloc_policy
+{
+    static constexpr std::size_t huge_page_threshold = SIZE_MAX;
+};
+
+/// <summary>
+/// An allocation policy that backs large buffers (framebuffers, textures, atlases) with 2 MB huge pages, which reduces
+/// the TLB misses when they are traversed. Buffers of at least Threshold bytes use reserved huge pages (MAP_HUGETLB)
+/// if the system has them, and otherwise a 2 MB aligned mapping with a transparent huge page hint (MADV_HUGEPAGE).
+/// Smaller buffers, and platforms without huge page support, fall back to aligned_malloc.
+/// Note: The size of a huge page buffer is rounded up to a multiple of 2 MB.
+/// </summary>
+template<std::size_t Threshold = huge_page_size>
+struct huge_page_alloc_policy
+{
+    static constexpr std::size_t huge_page_threshold = Threshold;
+};
+
+namespace detail
+{
+struct aligned_allocation
+{
+    void*       p      = nullptr;
+    std::size_t mapped = 0;  // The size of the mapping, or 0 if the memory was allocated with aligned_malloc.
+};
+
+inline std::size_t round_up( std::size_t size, std::size_t alignment ) noexcept
+{
+    return ( size + alignment - 1 ) / alignment * alignment;
+}
+
+inline aligned_allocation allocate_aligned( std::size_t size, std::size_t alignment, std::size_t hugePageThreshold ) noexcept
+{
+#if defined( __linux__ )
+    if ( size >= hugePageThreshold && alignment <= huge_page_size )
+    {
+        const std::size_t mapped = round_up( size, huge_page_size );
+
+    #ifdef MAP_HUGETLB
+        // Use the reserved huge pages if there are enough.
+        if ( void* p = mmap( nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 ); p != MAP_FAILED )
+            return { p, mapped };
+    #endif
+
+        // Otherwise, map a range that is aligned to a huge page (so the kernel can back it with transparent huge pages) and unmap the excess.
+        const std::size_t reserved = mapped + huge_page_size;
+
+        void* p = mmap( nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if ( p != MAP_FAILED )
+        {
+            auto* const       base    = static_cast<unsigned char*>( p );
+            const std::size_t head    = round_up( reinterpret_cast<std::uintptr_t>( base ), huge_page_size ) - reinterpret_cast<std::uintptr_t>( base );
+            auto* const       aligned = base + head;
+            const std::size_t tail    = reserved - head - mapped;
+
+            if ( head > 0 )
+                munmap( base, head );
+            if ( tail > 0 )
+                munmap( aligned + mapped, tail );
+
+    #ifdef MADV_HUGEPAGE
+            madvise( aligned, mapped, MADV_HUGEPAGE );  // Only a hint: the allocation succeeds without transparent huge pages.
+    #endif
+
+            return { aligned, mapped };
+        }
+    }
+#else
+    (void)hugePageThreshold;
+#endif
+
+    // The size must be a multiple of the alignment.
+    return { aligned_malloc( round_up( size, alignment ), alignment ), 0 };
+}
+
+inline void free_aligned( void* p, std::size_t mapped ) noexcept
+{
+#if defined( __linux__ )
+    if ( mapped > 0 )
+    {
+        munmap( p, mapped );
+        return;
+    }
+#else
+    (void)mapped;
+#endif
+
+    aligned_free( p );
+}
+}  // namespace detail
+
 template<typename T>
 struct aligned_deleter
 {
     using T2 = std::remove_extent_t<T>;
-    size_t n = 1;
+    size_t n      = 1;
+    size_t mapped = 0;  // The size of the huge page mapping, or 0 if the memory was allocated with aligned_malloc.
 
     void operator()( T2* p ) const
     {
         for ( std::size_t i = 0; i < n; ++i )
             p[i].~T2();
 
-        aligned_free( p );
+        detail::free_aligned( p, mapped );
     }
 };
 
@@ -55,33 +160,34 @@ public:
     }
 };
 
-template<typename T, std::size_t Align, typename... Args>
+template<typename T, std::size_t Align, typename Policy = default_alloc_policy, typename... Args>
 std::enable_if_t<!std::is_array_v<T>, aligned_unique_ptr<T>>
     make_aligned_unique( Args&&... args )
 {
     static_assert( ( Align & ( Align - 1 ) ) == 0 );  // Alignment must be a power of 2.
     static_assert( Align >= alignof( T ) );           // Make sure alignment is at least as big as the alignment requirement of the type.
 
-    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T*>( aligned_malloc( sizeof( T ), Align ) ), aligned_deleter<T> {} );
+    const detail::aligned_allocation allocation = detail::allocate_aligned( sizeof( T ), Align, Policy::huge_page_threshold );
 
-    if ( !ptr )
+    if ( !allocation.p )
         throw bad_aligned_alloc();
 
     try
     {
-        new ( ptr.get() ) T( std::forward<Args>( args )... );  // The constructor might throw.
+        new ( allocation.p ) T( std::forward<Args>( args )... );  // The constructor might throw.
     }
     catch ( ... )
     {
         // Free the memory before propagating the exception.
-        aligned_free( ptr );
+        detail::free_aligned( allocation.p, allocation.mapped );
         // Propagate the exception.
         throw;
     }
-    return ptr;
+
+    return aligned_unique_ptr<T>( static_cast<T*>( allocation.p ), aligned_deleter<T> { 1, allocation.mapped } );
 }
 
-template<typename T, std::size_t Align>
+template<typename T, std::size_t Align, typename Policy = default_alloc_policy>
 std::enable_if_t<detail::is_unbounded_array_v<T> && std::is_default_constructible_v<std::remove_extent_t<T>>, aligned_unique_ptr<T>>
     make_aligned_unique( std::size_t n )
 {
@@ -90,13 +196,13 @@ std::enable_if_t<detail::is_unbounded_array_v<T> && std::is_default_constructibl
     static_assert( ( Align & ( Align - 1 ) ) == 0 );  // Alignment must be a power of 2.
     static_assert( Align >= alignof( T2 ) );          // Make sure alignment is at least as big as the alignment requirement of the element type.
 
-    aligned_unique_ptr<T> ptr = aligned_unique_ptr<T>( static_cast<T2*>( aligned_malloc( sizeof( T2 ) * n, Align ) ), aligned_deleter<T> { n } );
+    const detail::aligned_allocation allocation = detail::allocate_aligned( sizeof( T2 ) * n, Align, Policy::huge_page_threshold );
 
-    if ( !ptr )
+    if ( !allocation.p )
         throw bad_aligned_alloc();
 
     // Default construct the elements.
-    T2* p = ptr.get();
+    T2* p = static_cast<T2*>( allocation.p );
     for ( std::size_t i = 0; i < n; ++i )
     {
         try
@@ -107,16 +213,16 @@ std::enable_if_t<detail::is_unbounded_array_v<T> && std::is_default_constructibl
         {
             // Deconstruct the already constructed elements.
             for ( std::size_t j = 0; j < i; ++j )
-                p[i].~T2();
+                p[j].~T2();
 
             // Free the allocation.
-            aligned_free( p );
+            detail::free_aligned( allocation.p, allocation.mapped );
             // Propagate the exception.
             throw;
         }
     }
 
-    return ptr;
+    return aligned_unique_ptr<T>( p, aligned_deleter<T> { n, allocation.mapped } );
 }
 
 template<typename T, typename... Args>
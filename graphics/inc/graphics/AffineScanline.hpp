@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/mat3x3.hpp>
+#include <glm/vec2.hpp>
+
+#include <cmath>  // For std::sin, std::cos
+#include <optional>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// The mapping of a single row of the color target to texture coordinates: an affine transform that is only evaluated
+/// once per row. The texture coordinates of the pixels of the row are stepped incrementally from the first pixel.
+/// Changing the transform from row to row (like the scanline effects of the SNES "Mode 7") produces perspective
+/// floor planes, waves, and other raster effects without any per-pixel projection.
+/// </summary>
+struct AffineScanline
+{
+    glm::vec2 origin { 0.0f };  ///< The texture coordinates at the center of the pixel in column 0 of the row.
+    glm::vec2 step { 0.0f };    ///< The change of the texture coordinates per pixel to the right.
+
+    /// <summary>
+    /// Get the scanline of a row from an affine transform of the whole color target.
+    /// </summary>
+    /// <param name="transform">The 2D affine transform (in homogeneous coordinates) from the color target to texture coordinates.</param>
+    /// <param name="y">The row on the color target.</param>
+    /// <returns>The scanline of the row.</returns>
+    static AffineScanline fromTransform( const glm::mat3& transform, int y ) noexcept
+    {
+        const glm::vec3 p = transform * glm::vec3 { 0.5f, static_cast<float>( y ) + 0.5f, 1.0f };
+        return { { p.x, p.y }, { transform[0][0], transform[0][1] } };
+    }
+};
+
+/// <summary>
+/// A camera above a textured ground plane, that generates the scanlines of a perspective floor (a "Mode 7" camera).
+/// The texture lies in the ground plane, one texel per world unit. Rows below the horizon are mapped to the plane,
+/// rows at or above the horizon do not intersect it.
+/// </summary>
+struct PlaneCamera
+{
+    glm::vec2 position { 0.0f };      ///< The position of the camera over the plane (in texels).
+    float     height      = 32.0f;    ///< The height of the camera above the plane (in texels).
+    float     angle       = 0.0f;     ///< The heading of the camera (in radians). At 0 the camera looks towards -v (up on the texture), increasing angles turn right.
+    float     focalLength = 256.0f;   ///< The distance from the camera to the projection plane (in pixels). Larger values give a narrower field of view.
+    float     horizon     = 0.0f;     ///< The row of the horizon on the color target. Can be negative to look down at the plane.
+    float     centerX     = 0.0f;     ///< The column of the center of projection on the color target (usually half the width).
+
+    /// <summary>
+    /// Get the scanline of a row of the color target.
+    /// </summary>
+    /// <param name="y">The row on the color target.</param>
+    /// <returns>The scanline of the row, or an empty optional if the row is at or above the horizon.</returns>
+    std::optional<AffineScanline> getScanline( int y ) const noexcept
+    {
+        const float dy = static_cast<float>( y ) + 0.5f - horizon;
+        if ( dy <= 0.0f || height <= 0.0f )
+            return {};
+
+        const glm::vec2 forward { std::sin( angle ), -std::cos( angle ) };
+        const glm::vec2 right { std::cos( angle ), std::sin( angle ) };
+
+        // The distance along the view direction to the point of the plane that is seen by the row,
+        // and the distance on the plane between two pixels of the row.
+        const float distance = height * focalLength / dy;
+        const float scale    = distance / focalLength;
+
+        return AffineScanline {
+            position + forward * distance + right * ( ( 0.5f - centerX ) * scale ),
+            right * scale,
+        };
+    }
+};
+}  // namespace graphics
+}  // namespace cpprast
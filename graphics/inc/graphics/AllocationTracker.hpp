@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// Counts heap allocations per frame and per subsystem, to verify that steady-state frames do not allocate.
+///
+/// Tracking is enabled with the CPPRAST_TRACK_ALLOCATIONS CMake option, which replaces the global operator new.
+/// Without the option, the scopes do nothing and all counters stay zero.
+///
+/// Allocations are attributed to the subsystem of the innermost <see cref="SubsystemScope"/> on the allocating thread
+/// (or <see cref="Subsystem::Other"/> outside of a subsystem scope). Code that must not allocate (for example, the frame loop)
+/// is marked with a <see cref="HotScope"/>: allocations inside a hot scope are logged or asserted, depending on the <see cref="HotScopeMode"/>.
+/// </summary>
+class AllocationTracker
+{
+public:
+    /// <summary>
+    /// True if allocation tracking is compiled in.
+    /// </summary>
+#if CPPRAST_TRACK_ALLOCATIONS
+    static constexpr bool Enabled = true;
+#else
+    static constexpr bool Enabled = false;
+#endif
+
+    /// <summary>
+    /// The subsystems that allocations are attributed to.
+    /// </summary>
+    enum class Subsystem
+    {
+        Other,            ///< Allocations outside of a subsystem scope.
+        Rasterizer,       ///< Allocations by the rasterizer.
+        ResourceManager,  ///< Allocations by the resource manager (loading and caching resources).
+        Image,            ///< Allocations of image pixels, depth buffers, and multisample targets.
+        Count
+    };
+
+    /// <summary>
+    /// What happens when memory is allocated inside a hot scope.
+    /// </summary>
+    enum class HotScopeMode
+    {
+        Ignore,  ///< Only count the allocation.
+        Log,     ///< Print the allocation (and the name of the hot scope) to stderr.
+        Assert   ///< Print the allocation, and assert (in debug builds).
+    };
+
+    /// <summary>
+    /// The number of allocations and the number of allocated bytes.
+    /// </summary>
+    struct Stats
+    {
+        uint64_t allocations = 0u;
+        uint64_t bytes       = 0u;
+    };
+
+    /// <summary>
+    /// Attributes the allocations on the calling thread to a subsystem while the scope exists.
+    /// </summary>
+    class SubsystemScope
+    {
+    public:
+        explicit SubsystemScope( Subsystem subsystem ) noexcept;
+        ~SubsystemScope();
+
+        SubsystemScope( const SubsystemScope& )            = delete;
+        SubsystemScope& operator=( const SubsystemScope& ) = delete;
+
+    private:
+        Subsystem m_Previous;
+    };
+
+    /// <summary>
+    /// Marks code on the calling thread that must not allocate while the scope exists.
+    /// </summary>
+    class HotScope
+    {
+    public:
+        /// <param name="name">The name of the scope that is reported with the allocations. Must outlive the scope.</param>
+        explicit HotScope( const char* name ) noexcept;
+        ~HotScope();
+
+        HotScope( const HotScope& )            = delete;
+        HotScope& operator=( const HotScope& ) = delete;
+
+    private:
+        const char* m_Previous;
+    };
+
+    /// <summary>
+    /// Start a new frame: reset the frame counters.
+    /// </summary>
+    static void beginFrame() noexcept;
+
+    /// <summary>
+    /// Get the allocations of a subsystem since the start of the frame.
+    /// </summary>
+    static Stats getFrameStats( Subsystem subsystem ) noexcept;
+
+    /// <summary>
+    /// Get the allocations of all subsystems since the start of the frame.
+    /// </summary>
+    static Stats getFrameStats() noexcept;
+
+    /// <summary>
+    /// Get the number of allocations inside hot scopes since the start of the frame.
+    /// </summary>
+    static uint64_t getHotAllocations() noexcept;
+
+    /// <summary>
+    /// Set what happens when memory is allocated inside a hot scope. Default: <see cref="HotScopeMode::Assert"/>.
+    /// </summary>
+    static void setHotScopeMode( HotScopeMode mode ) noexcept;
+
+    /// <summary>
+    /// Record an allocation. This is called by the global operator new, and by allocations that bypass it (such as aligned image pixels).
+    /// </summary>
+    /// <param name="bytes">The size of the allocation (in bytes).</param>
+    static void recordAllocation( size_t bytes ) noexcept;
+};
+}  // namespace graphics
+}  // namespace cpprast
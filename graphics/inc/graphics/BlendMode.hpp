@@ -125,6 +125,14 @@ struct BlendMode
     static const BlendMode Disable;
     static const BlendMode AlphaDiscard;
     static const BlendMode AlphaBlend;
+
+    /// <summary>
+    /// Alpha blending for drawing into a transparent layer (see <see cref="Compositor"/>).
+    /// The colors are blended like <see cref="AlphaBlend"/>, and the alpha accumulates ( As + Ad * ( 1 - As ) ),
+    /// so the layer ends up with premultiplied colors and the combined coverage of everything drawn into it.
+    /// </summary>
+    static const BlendMode AlphaBlendLayer;
+    static const BlendMode PremultipliedAlphaBlend;
     static const BlendMode AdditiveBlend;
     static const BlendMode SubtractiveBlend;
     static const BlendMode MultiplicativeBlend;
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <math/Viewport.hpp>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <span>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A vertex of a clipped triangle.
+/// </summary>
+struct ClipVertex
+{
+    glm::vec4 position;     ///< The clip-space position.
+    glm::vec3 barycentric;  ///< The weights of the vertices of the original triangle, used to interpolate the vertex attributes.
+};
+
+/// <summary>
+/// Clips triangles in homogeneous clip space.
+///
+/// Only the near plane and a guard band are clipped against. The guard band is a region around the viewport that is
+/// large enough that most triangles that cross the edges of the viewport are inside of it. Those triangles are not split,
+/// the rasterizer only visits the pixels inside the viewport (scissoring). Only the rare triangles that cross the near plane
+/// or leave the guard band are clipped, which keeps the number of triangles generated by clipping to a minimum.
+///
+/// Triangles that are completely outside of one of the planes of the view frustum are rejected.
+/// The clip space follows the Direct3D convention: a vertex is inside the view frustum if -w &lt;= x, y &lt;= w and 0 &lt;= z &lt;= w.
+/// </summary>
+class Clipper
+{
+public:
+    /// <summary>
+    /// Clip codes: a bit is set if a vertex is outside of a plane.
+    /// </summary>
+    static constexpr uint32_t Left        = 1u << 0;  ///< x < -w
+    static constexpr uint32_t Right       = 1u << 1;  ///< x > w
+    static constexpr uint32_t Bottom      = 1u << 2;  ///< y < -w
+    static constexpr uint32_t Top         = 1u << 3;  ///< y > w
+    static constexpr uint32_t Near        = 1u << 4;  ///< z < 0
+    static constexpr uint32_t Far         = 1u << 5;  ///< z > w
+    static constexpr uint32_t GuardLeft   = 1u << 6;  ///< Left of the guard band.
+    static constexpr uint32_t GuardRight  = 1u << 7;  ///< Right of the guard band.
+    static constexpr uint32_t GuardBottom = 1u << 8;  ///< Below the guard band.
+    static constexpr uint32_t GuardTop    = 1u << 9;  ///< Above the guard band.
+
+    /// <summary>
+    /// The planes of the view frustum. A triangle is rejected if all of its vertices are outside of one of these planes.
+    /// </summary>
+    static constexpr uint32_t FrustumPlanes = Left | Right | Bottom | Top | Near | Far;
+
+    /// <summary>
+    /// The planes that triangles are clipped against.
+    /// </summary>
+    static constexpr uint32_t ClipPlanes = Near | GuardLeft | GuardRight | GuardBottom | GuardTop;
+
+    /// <summary>
+    /// The maximum number of vertices of a clipped triangle: every clip plane can add one vertex.
+    /// </summary>
+    static constexpr size_t MaxVertices = 8;
+
+    /// <summary>
+    /// The default size of the guard band (in pixels on each side of the viewport).
+    /// Screen positions inside the guard band are well within the range of the fixed-point rasterizer.
+    /// </summary>
+    static constexpr float DefaultGuardBand = 8192.0f;
+
+    /// <summary>
+    /// Create a clipper for a viewport.
+    /// </summary>
+    /// <param name="viewport">The viewport that triangles are rasterized to.</param>
+    /// <param name="guardBand">(Optional) The size of the guard band in pixels on each side of the viewport.</param>
+    explicit Clipper( const Viewport& viewport, float guardBand = DefaultGuardBand ) noexcept;
+
+    /// <summary>
+    /// Compute the clip code of a clip-space position.
+    /// </summary>
+    /// <param name="p">The clip-space position.</param>
+    /// <returns>The planes the position is outside of.</returns>
+    uint32_t getClipCode( const glm::vec4& p ) const noexcept
+    {
+        uint32_t code = 0u;
+
+        code |= p.x < -p.w ? Left : 0u;
+        code |= p.x > p.w ? Right : 0u;
+        code |= p.y < -p.w ? Bottom : 0u;
+        code |= p.y > p.w ? Top : 0u;
+        code |= p.z < 0.0f ? Near : 0u;
+        code |= p.z > p.w ? Far : 0u;
+        code |= p.x < -m_GuardX * p.w ? GuardLeft : 0u;
+        code |= p.x > m_GuardX * p.w ? GuardRight : 0u;
+        code |= p.y < -m_GuardY * p.w ? GuardBottom : 0u;
+        code |= p.y > m_GuardY * p.w ? GuardTop : 0u;
+
+        return code;
+    }
+
+    /// <summary>
+    /// Check if a triangle can be rejected without clipping (all of its vertices are outside of the same frustum plane).
+    /// </summary>
+    static constexpr bool isRejected( uint32_t code0, uint32_t code1, uint32_t code2 ) noexcept
+    {
+        return ( code0 & code1 & code2 & FrustumPlanes ) != 0u;
+    }
+
+    /// <summary>
+    /// Check if a triangle needs to be clipped (it crosses the near plane or leaves the guard band).
+    /// </summary>
+    static constexpr bool needsClipping( uint32_t code0, uint32_t code1, uint32_t code2 ) noexcept
+    {
+        return ( ( code0 | code1 | code2 ) & ClipPlanes ) != 0u;
+    }
+
+    /// <summary>
+    /// Clip a triangle against the near plane and the guard band (Sutherland-Hodgman).
+    /// The result is a convex polygon that can be drawn as a triangle fan.
+    /// </summary>
+    /// <param name="p0">The clip-space position of the first vertex.</param>
+    /// <param name="p1">The clip-space position of the second vertex.</param>
+    /// <param name="p2">The clip-space position of the third vertex.</param>
+    /// <param name="polygon">Receives the vertices of the clipped polygon.</param>
+    /// <returns>The number of vertices of the clipped polygon, or 0 if the triangle is completely clipped.</returns>
+    size_t clip( const glm::vec4& p0, const glm::vec4& p1, const glm::vec4& p2, std::span<ClipVertex, MaxVertices> polygon ) const noexcept;
+
+private:
+    // The guard band in normalized device coordinates.
+    float m_GuardX = 1.0f;
+    float m_GuardY = 1.0f;
+};
+}  // namespace graphics
+}  // namespace cpprast
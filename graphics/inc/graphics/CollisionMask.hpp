@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Image.hpp"
+#include "Sprite.hpp"
+
+#include <math/BitGrid.hpp>
+#include <math/Rect.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A 1-bit mask of the solid pixels of a sprite, used for pixel-perfect collision tests.
+/// A pixel is solid if its alpha value is at least the alpha threshold.
+///
+/// The rows of the mask are packed into 64-bit words, so two masks are tested 64 pixels at a time.
+/// Use <see cref="ResourceManager::getCollisionMask"/> to share the masks of sprites that use the same image region.
+/// </summary>
+class CollisionMask
+{
+public:
+    /// <summary>
+    /// Default constructor. Creates an empty mask.
+    /// </summary>
+    CollisionMask() = default;
+
+    /// <summary>
+    /// Create a collision mask from a region of an image.
+    /// </summary>
+    /// <param name="image">The image to create the mask from.</param>
+    /// <param name="rect">The region of the image. The parts of the region outside of the image are not solid.</param>
+    /// <param name="alphaThreshold">(Optional) The minimum alpha value of a solid pixel. Default: 128.</param>
+    CollisionMask( const Image& image, const math::RectI& rect, uint8_t alphaThreshold = 128u );
+
+    /// <summary>
+    /// Create a collision mask from a sprite.
+    /// </summary>
+    /// <param name="sprite">The sprite to create the mask from.</param>
+    /// <param name="alphaThreshold">(Optional) The minimum alpha value of a solid pixel. Default: 128.</param>
+    explicit CollisionMask( const Sprite& sprite, uint8_t alphaThreshold = 128u );
+
+    /// <summary>
+    /// Check if a pixel of the mask is solid.
+    /// </summary>
+    /// <param name="x">The x-coordinate of the pixel.</param>
+    /// <param name="y">The y-coordinate of the pixel.</param>
+    /// <returns>true if the pixel is solid. Pixels outside of the mask are not solid.</returns>
+    bool isSolid( int x, int y ) const noexcept
+    {
+        return m_Bits.get( x, y );
+    }
+
+    /// <summary>
+    /// Check if the solid pixels of two masks overlap.
+    /// The bounds of the masks are intersected first, then only the overlapping rows are tested 64 pixels at a time.
+    /// </summary>
+    /// <param name="a">The first mask.</param>
+    /// <param name="positionA">The position of the top-left corner of the first mask.</param>
+    /// <param name="b">The second mask.</param>
+    /// <param name="positionB">The position of the top-left corner of the second mask.</param>
+    /// <returns>true if at least one solid pixel of both masks is at the same position.</returns>
+    static bool overlaps( const CollisionMask& a, const glm::ivec2& positionA, const CollisionMask& b, const glm::ivec2& positionB ) noexcept;
+
+    /// <summary>
+    /// Get the width of the mask.
+    /// </summary>
+    uint32_t getWidth() const noexcept
+    {
+        return m_Bits.getWidth();
+    }
+
+    /// <summary>
+    /// Get the height of the mask.
+    /// </summary>
+    uint32_t getHeight() const noexcept
+    {
+        return m_Bits.getHeight();
+    }
+
+    /// <summary>
+    /// Get the packed bits of the mask.
+    /// </summary>
+    const BitGrid& getBits() const noexcept
+    {
+        return m_Bits;
+    }
+
+private:
+    BitGrid m_Bits;
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "BlendMode.hpp"
+#include "Image.hpp"
+#include "Rasterizer.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A retained compositor that splits the scene into layers (for example, background, world, effects, and UI).
+///
+/// Every layer renders into its own cached image, which is only re-rendered when the layer is marked dirty or its content
+/// version changes. Layers whose content did not change (static backgrounds, UI that is not updated) cost nothing to render.
+/// The cached images are composited from back to front with the blend mode and the opacity of every layer, in a single pass
+/// over the color target: every row is composited from all layers while it is in the cache.
+///
+/// The layers are drawn over transparent black. Translucent content must be drawn with <see cref="BlendMode::AlphaBlendLayer"/>:
+/// the colors end up premultiplied by their alpha in the cached image, and the alpha of the cached image is the accumulated
+/// coverage of the layer. That is why layers are composited with premultiplied alpha blending by default.
+/// (<see cref="BlendMode::AlphaBlend"/> overwrites the alpha of the cached image with the alpha of the last draw, so content
+/// behind a translucent draw would be composited with the wrong coverage.)
+/// </summary>
+class Compositor
+{
+public:
+    /// <summary>
+    /// The function that renders the content of a layer. The color target of the rasterizer is the cached image of the layer,
+    /// which is cleared to transparent black before the function is called. Draw translucent content with <see cref="BlendMode::AlphaBlendLayer"/>.
+    /// </summary>
+    using DrawFunc = std::function<void( Rasterizer& rasterizer )>;
+
+    /// <summary>
+    /// A layer of the compositor.
+    /// </summary>
+    class Layer
+    {
+    public:
+        /// <summary>
+        /// Mark the layer as dirty, so it is re-rendered on the next composite.
+        /// </summary>
+        void setDirty() noexcept
+        {
+            m_Dirty = true;
+        }
+
+        /// <summary>
+        /// Set the version of the content of the layer. The layer is re-rendered on the next composite if the version
+        /// is different from the version of the last render (for example, a counter that is incremented when the content changes).
+        /// </summary>
+        void setVersion( uint64_t version ) noexcept
+        {
+            m_Version = version;
+        }
+
+        uint64_t getVersion() const noexcept
+        {
+            return m_Version;
+        }
+
+        /// <summary>
+        /// Set the blend mode that is used to composite the layer over the layers behind it.
+        /// </summary>
+        void setBlendMode( const BlendMode& blendMode ) noexcept
+        {
+            m_BlendMode = blendMode;
+        }
+
+        const BlendMode& getBlendMode() const noexcept
+        {
+            return m_BlendMode;
+        }
+
+        /// <summary>
+        /// Set the opacity of the layer (in the range [0..1]). The (premultiplied) colors of the layer are multiplied by the opacity when it is composited.
+        /// Changing the opacity does not re-render the layer.
+        /// </summary>
+        void setOpacity( float opacity ) noexcept
+        {
+            m_Opacity = opacity;
+        }
+
+        float getOpacity() const noexcept
+        {
+            return m_Opacity;
+        }
+
+        /// <summary>
+        /// Show or hide the layer. Hidden layers are neither rendered nor composited.
+        /// </summary>
+        void setVisible( bool visible ) noexcept
+        {
+            m_Visible = visible;
+        }
+
+        bool isVisible() const noexcept
+        {
+            return m_Visible;
+        }
+
+        /// <summary>
+        /// Get the cached image of the layer.
+        /// </summary>
+        const Image& getImage() const noexcept
+        {
+            return m_Image;
+        }
+
+    private:
+        friend class Compositor;
+
+        DrawFunc  m_Draw;
+        BlendMode m_BlendMode;
+        float     m_Opacity         = 1.0f;
+        bool      m_Visible         = true;
+        bool      m_Dirty           = true;
+        uint64_t  m_Version         = 0u;
+        uint64_t  m_RenderedVersion = 0u;
+        Image     m_Image;  // The cached content of the layer.
+    };
+
+    /// <summary>
+    /// Add a layer in front of the existing layers.
+    /// Note: References to the layers are invalidated when a layer is added.
+    /// </summary>
+    /// <param name="draw">The function that renders the content of the layer.</param>
+    /// <param name="blendMode">(Optional) The blend mode that is used to composite the layer. Default: Premultiplied alpha blending.</param>
+    /// <param name="opacity">(Optional) The opacity of the layer. Default: 1 (opaque).</param>
+    /// <returns>The index of the layer.</returns>
+    size_t addLayer( DrawFunc draw, const BlendMode& blendMode = BlendMode::PremultipliedAlphaBlend, float opacity = 1.0f );
+
+    /// <summary>
+    /// Get a layer by its index.
+    /// </summary>
+    Layer& getLayer( size_t index ) noexcept
+    {
+        return m_Layers[index];
+    }
+
+    const Layer& getLayer( size_t index ) const noexcept
+    {
+        return m_Layers[index];
+    }
+
+    /// <summary>
+    /// Get the number of layers.
+    /// </summary>
+    size_t getNumLayers() const noexcept
+    {
+        return m_Layers.size();
+    }
+
+    /// <summary>
+    /// Re-render the layers that changed, and composite all visible layers to the color target.
+    /// The cached images of the layers are resized to the color target (which re-renders them).
+    /// </summary>
+    /// <param name="target">The color target.</param>
+    /// <param name="clearColor">(Optional) The color behind all layers. Default: Black.</param>
+    void composite( Image& target, const Color& clearColor = Color::Black );
+
+private:
+    std::vector<Layer> m_Layers;      // The layers from back to front.
+    Rasterizer         m_Rasterizer;  // The rasterizer that renders the layers.
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "TileMap.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A horizontal run of identical tiles in a row of a compressed tile map.
+/// </summary>
+struct TileRun
+{
+    uint32_t column;    ///< The first column of the run.
+    uint32_t length;    ///< The number of tiles in the run.
+    int32_t  spriteId;  ///< The sprite index of every tile in the run (-1 for empty tiles).
+};
+
+/// <summary>
+/// A read-only, run-length encoded copy of a tile map.
+/// Each row is stored as a sequence of runs of identical tiles. Rows never share runs,
+/// so any row can be iterated without decoding the rows before it.
+/// Maps with long runs of the same tile (sky, ground, walls) compress very well and
+/// drawing them only requires a single sprite lookup per run.
+/// </summary>
+class CompressedTileMap
+{
+public:
+    /// <summary>
+    /// Default constructor. Creates an empty compressed tile map.
+    /// </summary>
+    CompressedTileMap() = default;
+
+    /// <summary>
+    /// Compress a tile map.
+    /// </summary>
+    /// <param name="tileMap">The tile map to compress.</param>
+    explicit CompressedTileMap( const TileMap& tileMap );
+
+    /// <summary>
+    /// Access a tile in the tile map by its coordinates.
+    /// Note: This requires a binary search through the runs of the row. Use <see cref="getRow"/> to iterate the tiles of a row.
+    /// </summary>
+    /// <param name="x">The x-coordinate (column) of the tile.</param>
+    /// <param name="y">The y-coordinate (row) of the tile.</param>
+    /// <returns>The sprite index at the specified coordinates, or -1 if the coordinates are out of bounds.</returns>
+    int operator[]( size_t x, size_t y ) const noexcept;
+
+    /// <summary>
+    /// Get the runs of a single row of the tile map.
+    /// The runs are sorted by column and cover every column of the row.
+    /// </summary>
+    /// <param name="y">The row to retrieve.</param>
+    /// <returns>The runs of tiles in the row.</returns>
+    std::span<const TileRun> getRow( size_t y ) const noexcept
+    {
+        assert( y < m_Rows );
+
+        return { m_Runs.data() + m_RowOffsets[y], m_Runs.data() + m_RowOffsets[y + 1] };
+    }
+
+    /// <summary>
+    /// Decompress this tile map.
+    /// </summary>
+    /// <returns>The decompressed tile map.</returns>
+    TileMap decompress() const;
+
+    /// <summary>
+    /// Gets the number of columns in the tile map.
+    /// </summary>
+    /// <returns>The number of columns in the tile map.</returns>
+    uint32_t getColumns() const noexcept
+    {
+        return m_Columns;
+    }
+
+    /// <summary>
+    /// Gets the number of rows in the tile map.
+    /// </summary>
+    /// <returns>The number of rows in the tile map.</returns>
+    uint32_t getRows() const noexcept
+    {
+        return m_Rows;
+    }
+
+    /// <summary>
+    /// Gets the total number of runs used to encode the tile map.
+    /// </summary>
+    /// <returns>The number of runs in the tile map.</returns>
+    size_t getNumRuns() const noexcept
+    {
+        return m_Runs.size();
+    }
+
+    /// <summary>
+    /// Gets the sprite sheet used by this tile map.
+    /// </summary>
+    /// <returns>A shared pointer to the sprite sheet.</returns>
+    std::shared_ptr<SpriteSheet> getSpriteSheet() const noexcept
+    {
+        return m_SpriteSheet;
+    }
+
+    /// <summary>
+    /// Gets the width of sprites used in this tile map.
+    /// </summary>
+    /// <returns>The width of each sprite in pixels.</returns>
+    uint32_t getSpriteWidth() const noexcept;
+
+    /// <summary>
+    /// Gets the height of sprites used in this tile map.
+    /// </summary>
+    /// <returns>The height of each sprite in pixels.</returns>
+    uint32_t getSpriteHeight() const noexcept;
+
+    /// <summary>
+    /// Gets the total width of the tile map in pixels.
+    /// </summary>
+    /// <returns>The total width of the tile map in pixels.</returns>
+    uint32_t getWidth() const noexcept
+    {
+        return m_Columns * getSpriteWidth();
+    }
+
+    /// <summary>
+    /// Gets the total height of the tile map in pixels.
+    /// </summary>
+    /// <returns>The total height of the tile map in pixels.</returns>
+    uint32_t getHeight() const noexcept
+    {
+        return m_Rows * getSpriteHeight();
+    }
+
+private:
+    uint32_t m_Columns = 0u;
+    uint32_t m_Rows    = 0u;
+
+    std::shared_ptr<SpriteSheet> m_SpriteSheet;
+    std::vector<TileRun>         m_Runs;        // The runs of all rows.
+    std::vector<uint32_t>        m_RowOffsets;  // The index of the first run of each row (rows + 1 entries).
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "aligned_unique_ptr.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <utility>  // For std::cmp_less
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A buffer of depth values, used for depth testing when drawing triangles.
+/// Depth values are in the depth range of the viewport, smaller values are closer to the viewer.
+/// </summary>
+class DepthBuffer final
+{
+public:
+    /// <summary>
+    /// Default construct an empty 0x0 depth buffer.
+    /// </summary>
+    DepthBuffer() = default;
+
+    /// <summary>
+    /// Create a depth buffer.
+    /// </summary>
+    /// <param name="width">The width of the depth buffer (in pixels).</param>
+    /// <param name="height">The height of the depth buffer (in pixels).</param>
+    /// <param name="depth">(Optional) The depth value to fill the buffer with. Default: 1 (the far plane).</param>
+    DepthBuffer( uint32_t width, uint32_t height, float depth = 1.0f );
+
+    /// <summary>
+    /// Resize the depth buffer. The contents of the buffer are undefined after resizing.
+    /// Note: This function does nothing if the buffer is already the requested size.
+    /// </summary>
+    /// <param name="width">The new width (in pixels).</param>
+    /// <param name="height">The new height (in pixels).</param>
+    void resize( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Clear the depth buffer.
+    /// </summary>
+    /// <param name="depth">(Optional) The depth value to clear the buffer to. Default: 1 (the far plane).</param>
+    void clear( float depth = 1.0f ) noexcept;
+
+    /// <summary>
+    /// Access a depth value by its 2D coordinates.
+    /// </summary>
+    float& operator()( size_t x, size_t y ) noexcept
+    {
+        assert( std::cmp_less( x, m_Width ) );
+        assert( std::cmp_less( y, m_Height ) );
+
+        return m_Depth[y * m_Width + x];
+    }
+
+    /// <summary>
+    /// Access a depth value by its 2D coordinates.
+    /// </summary>
+    float operator()( size_t x, size_t y ) const noexcept
+    {
+        assert( std::cmp_less( x, m_Width ) );
+        assert( std::cmp_less( y, m_Height ) );
+
+        return m_Depth[y * m_Width + x];
+    }
+
+    /// <summary>
+    /// Get the width of the depth buffer (in pixels).
+    /// </summary>
+    int getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    /// <summary>
+    /// Get the height of the depth buffer (in pixels).
+    /// </summary>
+    int getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Get a pointer to the depth values.
+    /// </summary>
+    float* data() noexcept
+    {
+        return m_Depth.get();
+    }
+
+    /// <summary>
+    /// Get a read-only pointer to the depth values.
+    /// </summary>
+    const float* data() const noexcept
+    {
+        return m_Depth.get();
+    }
+
+private:
+    int                         m_Width  = 0;
+    int                         m_Height = 0;
+    aligned_unique_ptr<float[]> m_Depth;
+};
+}  // namespace graphics
+}  // namespace cpprast
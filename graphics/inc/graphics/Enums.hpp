@@ -17,6 +17,15 @@ enum class AddressMode
     Border   ///< Use border color for out-of-range texture coordinates.
 };
 
+/// <summary>
+/// The memory layout of the rows of an image.
+/// </summary>
+enum class ImageLayout
+{
+    Packed,  ///< The rows are tightly packed (the pitch is width * 4 bytes). The pixel at (x, y) is at index y * width + x.
+    Padded   ///< Every row starts on a 64-byte boundary (the pitch is rounded up to a multiple of 64 bytes). Use it for render targets.
+};
+
 /// <summary>
 /// FillMode determines how primitives are rendered.
 /// * FillMode::WireFrame: Primitives are rendered as lines.
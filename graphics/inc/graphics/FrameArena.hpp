@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A linear (bump) allocator for transient data that only lives for a frame, such as scratch buffers and temporary lists.
+/// Use it through the std::pmr::memory_resource interface, for example with std::pmr::vector.
+///
+/// Allocating is a pointer increment, and deallocating does nothing: all memory is released at once when the arena is reset
+/// (at the end of the frame) or rewound to a marker (at the end of a scope). The memory blocks are kept for the next frame,
+/// and when a frame needed more than one block, they are merged into a single block on reset. After a few frames,
+/// the arena does not allocate from the upstream resource anymore.
+///
+/// An arena is not thread-safe. Every thread has its own arena (see <see cref="getThreadArena"/>).
+///
+/// The library allocates its own transient data from the arena of the calling thread, inside a <see cref="Scope"/>:
+/// the parsed attributes of OBJ meshes, the working arrays of the vertex cache optimization, and the tileset ranges
+/// and pending layers of Tiled maps.
+/// </summary>
+class FrameArena final : public std::pmr::memory_resource
+{
+public:
+    /// <summary>
+    /// The default size of the memory blocks (in bytes).
+    /// </summary>
+    static constexpr size_t DefaultBlockSize = 256 * 1024;
+
+    /// <summary>
+    /// A position in the arena. Rewinding to a marker releases everything that was allocated after it.
+    /// </summary>
+    struct Marker
+    {
+        size_t block  = 0;  ///< The index of the current block.
+        size_t offset = 0;  ///< The offset in the current block.
+    };
+
+    /// <summary>
+    /// Rewinds an arena to the position it had when the scope was created.
+    /// Use it for transient data that does not outlive a function, so the function does not depend on the arena being reset.
+    /// </summary>
+    class Scope
+    {
+    public:
+        explicit Scope( FrameArena& arena ) noexcept
+        : m_Arena { arena }
+        , m_Marker { arena.getMarker() }
+        {}
+
+        ~Scope()
+        {
+            m_Arena.rewind( m_Marker );
+        }
+
+        Scope( const Scope& )            = delete;
+        Scope& operator=( const Scope& ) = delete;
+
+        /// <summary>
+        /// Get the arena of the scope.
+        /// </summary>
+        FrameArena& getArena() const noexcept
+        {
+            return m_Arena;
+        }
+
+    private:
+        FrameArena& m_Arena;
+        Marker      m_Marker;
+    };
+
+    /// <summary>
+    /// Create an arena. No memory is allocated until the first allocation.
+    /// </summary>
+    /// <param name="blockSize">(Optional) The minimum size of the memory blocks (in bytes).</param>
+    /// <param name="upstream">(Optional) The resource the memory blocks are allocated from. Default: The default memory resource.</param>
+    explicit FrameArena( size_t blockSize = DefaultBlockSize, std::pmr::memory_resource* upstream = std::pmr::get_default_resource() ) noexcept;
+
+    ~FrameArena() override;
+
+    FrameArena( const FrameArena& )            = delete;
+    FrameArena& operator=( const FrameArena& ) = delete;
+
+    /// <summary>
+    /// Get the arena of the calling thread. Reset it at the end of every frame of the thread.
+    /// </summary>
+    static FrameArena& getThreadArena();
+
+    /// <summary>
+    /// Release all allocations. Call this at the end of the frame, when no transient data is referenced anymore.
+    /// </summary>
+    void reset();
+
+    /// <summary>
+    /// Get the current position of the arena.
+    /// </summary>
+    Marker getMarker() const noexcept
+    {
+        return { m_Block, m_Offset };
+    }
+
+    /// <summary>
+    /// Release all allocations that were made after a marker.
+    /// </summary>
+    void rewind( const Marker& marker ) noexcept;
+
+    /// <summary>
+    /// Get the number of bytes that were allocated since the last reset (including alignment padding).
+    /// </summary>
+    size_t getUsedBytes() const noexcept;
+
+    /// <summary>
+    /// Get the total size of the memory blocks (in bytes).
+    /// </summary>
+    size_t getCapacity() const noexcept;
+
+protected:
+    void* do_allocate( size_t bytes, size_t alignment ) override;
+    void  do_deallocate( void* p, size_t bytes, size_t alignment ) override;
+    bool  do_is_equal( const std::pmr::memory_resource& other ) const noexcept override;
+
+private:
+    struct Block
+    {
+        std::byte* data;
+        size_t     size;
+    };
+
+    // Allocate a block from the upstream resource, and make it the current block.
+    void addBlock( size_t size );
+
+    std::pmr::memory_resource* m_Upstream;
+    size_t                     m_BlockSize;
+    std::vector<Block>         m_Blocks;
+    size_t                     m_Block  = 0;  // The index of the block that is allocated from.
+    size_t                     m_Offset = 0;  // The offset of the next allocation in the current block.
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -18,6 +18,11 @@ inline namespace graphics
 {
 struct Image final
 {
+    /// <summary>
+    /// The alignment of the rows of a padded image (in bytes).
+    /// </summary>
+    static constexpr int RowAlignment = 64;
+
     /// <summary>
     /// Default construct an empty 0x0 image.
     /// </summary>
@@ -48,7 +53,8 @@ struct Image final
     /// <param name="width">The image width (in pixels).</param>
     /// <param name="height">The image height (in pixels).</param>
     /// <param name="color">Optional color to fill the texture with.</param>
-    Image( uint32_t width, uint32_t height, std::optional<Color> color = {} );
+    /// <param name="layout">(Optional) The memory layout of the rows. Default: Packed. Render targets should use Padded, so every row starts on a cache line.</param>
+    Image( uint32_t width, uint32_t height, std::optional<Color> color = {}, ImageLayout layout = ImageLayout::Packed );
 
     /// <summary>
     /// Copy another image to this one.
@@ -65,24 +71,26 @@ struct Image final
     Image& operator=( Image&& other ) noexcept;
 
     /// <summary>
-    /// Access a pixel in the image by its linear index.
+    /// Access a pixel in the image by its index in the pixel buffer (y * getStride() + x).
+    /// For Packed images (the default), this is y * getWidth() + x.
     /// </summary>
-    /// <param name="i">The linear index of the pixel.</param>
+    /// <param name="i">The index of the pixel.</param>
     /// <returns>A constant reference to the color of the pixel at the given index.</returns>
     const Color& operator[]( size_t i ) const
     {
-        assert( std::cmp_less( i, m_Width * m_Height ) );
+        assert( std::cmp_less( i, static_cast<size_t>( m_Stride ) * m_Height ) );
         return m_Pixels[i];
     }
 
     /// <summary>
-    /// Access a pixel in the image by its linear index.
+    /// Access a pixel in the image by its index in the pixel buffer (y * getStride() + x).
+    /// For Packed images (the default), this is y * getWidth() + x.
     /// </summary>
-    /// <param name="i">The linear index of the pixel.</param>
+    /// <param name="i">The index of the pixel.</param>
     /// <returns>A reference to the color of the pixel at the given index.</returns>
     Color& operator[]( size_t i )
     {
-        assert( std::cmp_less( i, m_Width * m_Height ) );
+        assert( std::cmp_less( i, static_cast<size_t>( m_Stride ) * m_Height ) );
         return m_Pixels[i];
     }
 
@@ -91,7 +99,7 @@ struct Image final
         assert( std::cmp_less( x, m_Width ) );
         assert( std::cmp_less( y, m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Pixels[y * m_Stride + x];
     }
 
     Color& operator[]( size_t x, size_t y )
@@ -99,7 +107,7 @@ struct Image final
         assert( std::cmp_less( x, m_Width ) );
         assert( std::cmp_less( y, m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Pixels[y * m_Stride + x];
     }
 
     /// <summary>
@@ -113,7 +121,7 @@ struct Image final
         assert( std::cmp_less( x, m_Width ) );
         assert( std::cmp_less( y, m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Pixels[y * m_Stride + x];
     }
 
     /// <summary>
@@ -127,7 +135,7 @@ struct Image final
         assert( std::cmp_less( x, m_Width ) );
         assert( std::cmp_less( y, m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Pixels[y * m_Stride + x];
     }
 
     /// <summary>
@@ -208,7 +216,7 @@ struct Image final
             assert( std::cmp_less( y, m_Height ) );
         }
 
-        Color& dst = m_Pixels[y * m_Width + x];
+        Color& dst = m_Pixels[y * m_Stride + x];
         if constexpr ( Blending )
         {
             dst = blendMode.Blend( src, dst );
@@ -230,6 +238,12 @@ struct Image final
     /// <param name="file">The name of the file to save this image to.</param>
     void save( const std::filesystem::path& file ) const;
 
+    /// <summary>
+    /// Get a copy of the image with tightly packed rows, for example, to pass the pixels to a library that does not support a pitch.
+    /// </summary>
+    /// <returns>A copy of the image with the Packed layout.</returns>
+    Image packed() const;
+
     /// <summary>
     /// Clear the image to a single color.
     /// </summary>
@@ -238,11 +252,12 @@ struct Image final
 
     /// <summary>
     /// Resize this image.
-    /// Note: This function does nothing if the image is already the requested size.
+    /// Note: This function does nothing if the image already has the requested size and layout.
     /// </summary>
     /// <param name="width">The new image width (in pixels).</param>
     /// <param name="height">The new image height (in pixels).</param>
-    void resize( uint32_t width, uint32_t height );
+    /// <param name="layout">(Optional) The memory layout of the rows. Default: The current layout of the image (Packed for an empty image).</param>
+    void resize( uint32_t width, uint32_t height, std::optional<ImageLayout> layout = {} );
 
     /// <summary>
     /// Get the width of the image (in pixels).
@@ -268,7 +283,25 @@ struct Image final
     /// <returns>The distance in bytes between the rows of pixels.</returns>
     int getPitch() const noexcept
     {
-        return m_Width * static_cast<int>( sizeof( Color ) );
+        return m_Stride * static_cast<int>( sizeof( Color ) );
+    }
+
+    /// <summary>
+    /// Get the distance in pixels between rows of pixels.
+    /// The pixel at (x, y) is at index y * getStride() + x of the pixel buffer.
+    /// </summary>
+    /// <returns>The distance in pixels between the rows of pixels.</returns>
+    int getStride() const noexcept
+    {
+        return m_Stride;
+    }
+
+    /// <summary>
+    /// Get the memory layout of the rows of the image.
+    /// </summary>
+    ImageLayout getLayout() const noexcept
+    {
+        return m_Layout;
     }
 
     /// <summary>
@@ -331,6 +364,16 @@ private:
     /// </summary>
     int m_Height = 0;
 
+    /// <summary>
+    /// The distance between rows of pixels (in pixels).
+    /// </summary>
+    int m_Stride = 0;
+
+    /// <summary>
+    /// The memory layout of the rows.
+    /// </summary>
+    ImageLayout m_Layout = ImageLayout::Packed;
+
     /// <summary>
     /// The pixel buffer.
     /// </summary>
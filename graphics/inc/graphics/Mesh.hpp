@@ -0,0 +1,114 @@
+#pragma once
+
+#include "VertexProcessor.hpp"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// An indexed triangle mesh with texture coordinates, stored as a structure of arrays
+/// so it can be passed to the vertex processor and the rasterizer directly.
+/// </summary>
+class Mesh
+{
+public:
+    /// <summary>
+    /// The number of entries of the vertex cache that is modeled by <see cref="optimize"/>.
+    /// </summary>
+    static constexpr int CacheSize = 32;
+
+    /// <summary>
+    /// Default constructor. Creates an empty mesh.
+    /// </summary>
+    Mesh() = default;
+
+    /// <summary>
+    /// Load a mesh from a Wavefront OBJ file, and optimize it for the vertex cache.
+    /// Vertices with the same position and texture coordinates are merged, and polygons are triangulated as triangle fans.
+    /// The texture coordinates are normalized, with v pointing down (the v-axis of OBJ files points up).
+    /// Normals, materials, and groups are ignored.
+    /// </summary>
+    /// <param name="fileName">The path to the OBJ file to load.</param>
+    explicit Mesh( const std::filesystem::path& fileName );
+
+    /// <summary>
+    /// Create a mesh from vertex and index data.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="texCoords">The texture coordinates of the vertices. Either empty or the same size as positions.</param>
+    /// <param name="indices">The indices of the vertices, 3 per triangle.</param>
+    Mesh( std::span<const glm::vec3> positions, std::span<const glm::vec2> texCoords, std::vector<uint32_t> indices );
+
+    /// <summary>
+    /// Reorder the triangles for the locality of their vertices (Forsyth's linear-speed vertex cache optimization),
+    /// and reorder the vertices in the order they are first referenced, so the vertex streams are read sequentially.
+    /// Vertices that are not referenced by any triangle are moved to the end.
+    /// </summary>
+    void optimize();
+
+    /// <summary>
+    /// Compute the average cache miss ratio (the number of vertex transforms per triangle) of a FIFO vertex cache
+    /// of the specified size. This is between 0.5 (optimal) and 3 (no reuse).
+    /// </summary>
+    /// <param name="cacheSize">(Optional) The size of the vertex cache.</param>
+    float getAverageCacheMissRatio( int cacheSize = CacheSize ) const;
+
+    /// <summary>
+    /// Get the vertex positions.
+    /// </summary>
+    VertexPositions getPositions() const noexcept
+    {
+        return { m_X, m_Y, m_Z };
+    }
+
+    /// <summary>
+    /// Get the vertex attributes (texture coordinates).
+    /// </summary>
+    VertexAttributes getAttributes() const noexcept
+    {
+        return { m_U, m_V, {} };
+    }
+
+    /// <summary>
+    /// Get the indices of the vertices, 3 per triangle.
+    /// </summary>
+    std::span<const uint32_t> getIndices() const noexcept
+    {
+        return m_Indices;
+    }
+
+    /// <summary>
+    /// Get the number of vertices.
+    /// </summary>
+    size_t getNumVertices() const noexcept
+    {
+        return m_X.size();
+    }
+
+    /// <summary>
+    /// Get the number of triangles.
+    /// </summary>
+    size_t getNumTriangles() const noexcept
+    {
+        return m_Indices.size() / 3;
+    }
+
+private:
+    std::vector<float>    m_X;
+    std::vector<float>    m_Y;
+    std::vector<float>    m_Z;
+    std::vector<float>    m_U;
+    std::vector<float>    m_V;
+    std::vector<uint32_t> m_Indices;
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "BlendMode.hpp"
+#include "Image.hpp"
+
+#include "aligned_unique_ptr.hpp"
+
+#include <math/BitGrid.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// The samples of 4x multisample anti-aliasing (MSAA) for a color target.
+///
+/// The coverage of triangles is evaluated at 4 samples per pixel, but the color of a pixel is only computed once.
+/// Pixels whose samples are all covered by the same triangle (the interior of triangles) are written to the color target
+/// directly, and only the pixels with partial coverage (along the edges of triangles) store their samples here.
+/// Those pixels are tracked in a bitmap, so resolving the samples to the color target only touches the edge pixels.
+///
+/// Every sample has its own depth value, so intersecting triangles are anti-aliased too.
+/// </summary>
+class MultisampleTarget final
+{
+public:
+    /// <summary>
+    /// The number of samples per pixel.
+    /// </summary>
+    static constexpr int NumSamples = 4;
+
+    /// <summary>
+    /// The coverage mask of a pixel with all samples covered.
+    /// </summary>
+    static constexpr uint32_t FullCoverage = ( 1u << NumSamples ) - 1u;
+
+    /// <summary>
+    /// The positions of the samples relative to the pixel center, in 1/16 pixels (the rotated grid pattern of Direct3D).
+    /// </summary>
+    static constexpr std::array<int, NumSamples> SampleOffsetX { -2, 6, -6, 2 };
+    static constexpr std::array<int, NumSamples> SampleOffsetY { -6, -2, 2, 6 };
+
+    /// <summary>
+    /// Default construct an empty 0x0 multisample target.
+    /// </summary>
+    MultisampleTarget() = default;
+
+    /// <summary>
+    /// Create a multisample target. The target is cleared.
+    /// </summary>
+    /// <param name="width">The width of the color target (in pixels).</param>
+    /// <param name="height">The height of the color target (in pixels).</param>
+    /// <param name="depth">(Optional) Store a depth value per sample and depth test the samples. Default: true.</param>
+    MultisampleTarget( uint32_t width, uint32_t height, bool depth = true );
+
+    /// <summary>
+    /// Resize the multisample target. The target is cleared.
+    /// Note: This function does nothing if the target is already the requested size.
+    /// </summary>
+    /// <param name="width">The new width (in pixels).</param>
+    /// <param name="height">The new height (in pixels).</param>
+    void resize( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Clear the depth of every sample, and discard the samples of the pixels with partial coverage.
+    /// Call this when the color target is cleared.
+    /// </summary>
+    /// <param name="depth">(Optional) The depth value to clear the samples to. Default: 1 (the far plane).</param>
+    void clear( float depth = 1.0f ) noexcept;
+
+    /// <summary>
+    /// Resolve the pixels with partial coverage to the color target (the average of their samples).
+    /// After resolving, every pixel of the color target is fully covered again.
+    /// </summary>
+    /// <param name="image">The color target. Must be the same size as the multisample target.</param>
+    void resolve( Image& image );
+
+    /// <summary>
+    /// Depth test the covered samples of a pixel, and update the depth of the samples that pass.
+    /// </summary>
+    /// <param name="x">The x-coordinate of the pixel.</param>
+    /// <param name="y">The y-coordinate of the pixel.</param>
+    /// <param name="coverage">The covered samples.</param>
+    /// <param name="depth">The depth at the pixel center.</param>
+    /// <param name="dzdx">The change of the depth per pixel along the x-axis.</param>
+    /// <param name="dzdy">The change of the depth per pixel along the y-axis.</param>
+    /// <param name="maxDepth">The maximum depth. Samples beyond it are discarded.</param>
+    /// <returns>The covered samples that pass the depth test.</returns>
+    uint32_t depthTest( int x, int y, uint32_t coverage, float depth, float dzdx, float dzdy, float maxDepth ) noexcept
+    {
+        assert( x >= 0 && x < m_Width && y >= 0 && y < m_Height );
+
+        float*   samples = m_Depth ? m_Depth.get() + ( static_cast<size_t>( y ) * m_Width + x ) * NumSamples : nullptr;
+        uint32_t passed  = 0u;
+
+        for ( int s = 0; s < NumSamples; ++s )
+        {
+            if ( ( coverage & ( 1u << s ) ) == 0u )
+                continue;
+
+            const float z = depth + ( dzdx * static_cast<float>( SampleOffsetX[s] ) + dzdy * static_cast<float>( SampleOffsetY[s] ) ) * ( 1.0f / 16.0f );
+            if ( z > maxDepth || ( samples && z >= samples[s] ) )
+                continue;
+
+            if ( samples )
+                samples[s] = z;
+
+            passed |= 1u << s;
+        }
+
+        return passed;
+    }
+
+    /// <summary>
+    /// Write the color of a pixel to its covered samples.
+    /// </summary>
+    /// <param name="image">The color target.</param>
+    /// <param name="x">The x-coordinate of the pixel.</param>
+    /// <param name="y">The y-coordinate of the pixel.</param>
+    /// <param name="coverage">The covered samples.</param>
+    /// <param name="color">The color of the pixel.</param>
+    /// <param name="blendMode">The blend mode to apply to every covered sample.</param>
+    void write( Image& image, int x, int y, uint32_t coverage, const Color& color, const BlendMode& blendMode ) noexcept
+    {
+        assert( x >= 0 && x < m_Width && y >= 0 && y < m_Height );
+        assert( image.getWidth() == m_Width && image.getHeight() == m_Height );
+
+        Color&     pixel   = image.data()[static_cast<size_t>( y ) * image.getStride() + x];
+        Color*     samples = m_Samples.get() + ( static_cast<size_t>( y ) * m_Width + x ) * NumSamples;
+        const auto px      = static_cast<uint32_t>( x );
+        const auto py      = static_cast<uint32_t>( y );
+        const bool partial = m_Partial.get( x, y );
+
+        if ( !partial )
+        {
+            // All samples of the pixel are equal to the color target.
+            if ( coverage == FullCoverage )
+            {
+                pixel = blendMode.Blend( color, pixel );
+                return;
+            }
+
+            m_Partial.set( px, py, true );
+            for ( int s = 0; s < NumSamples; ++s )
+                samples[s] = pixel;
+        }
+        else if ( coverage == FullCoverage && !blendMode.blendEnable )
+        {
+            // The pixel is completely overwritten, so its samples are equal again.
+            m_Partial.set( px, py, false );
+            pixel = color;
+            return;
+        }
+
+        for ( int s = 0; s < NumSamples; ++s )
+        {
+            if ( coverage & ( 1u << s ) )
+                samples[s] = blendMode.Blend( color, samples[s] );
+        }
+    }
+
+    /// <summary>
+    /// Check if a pixel has partial coverage (its samples are stored in the multisample target).
+    /// </summary>
+    bool isPartial( int x, int y ) const noexcept
+    {
+        return m_Partial.get( x, y );
+    }
+
+    /// <summary>
+    /// Check if the samples have depth values.
+    /// </summary>
+    bool hasDepth() const noexcept
+    {
+        return m_HasDepth;
+    }
+
+    /// <summary>
+    /// Get the width of the multisample target (in pixels).
+    /// </summary>
+    int getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    /// <summary>
+    /// Get the height of the multisample target (in pixels).
+    /// </summary>
+    int getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+private:
+    int                         m_Width    = 0;
+    int                         m_Height   = 0;
+    bool                        m_HasDepth = true;
+    aligned_unique_ptr<Color[]> m_Samples;  // The samples of the pixels with partial coverage, NumSamples per pixel.
+    aligned_unique_ptr<float[]> m_Depth;    // The depth of every sample, NumSamples per pixel.
+    BitGrid                     m_Partial;  // The pixels with partial coverage.
+};
+}  // namespace graphics
+}  // namespace cpprast
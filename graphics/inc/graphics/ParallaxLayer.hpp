@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BlendMode.hpp"
+#include "Image.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <cmath>  // For std::floor
+#include <memory>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A layer of a scrolling background that repeats infinitely in both directions.
+/// Layers that are further away scroll slower than the camera (a parallax factor below 1), closer layers scroll faster.
+/// </summary>
+struct ParallaxLayer
+{
+    std::shared_ptr<Image> image;              ///< The image of the layer. It is repeated to fill the destination rectangle.
+    glm::vec2              parallax { 1.0f };  ///< The scroll speed relative to the camera. 0 is fixed to the screen, 1 moves with the world.
+    glm::ivec2             offset { 0 };       ///< The scroll offset (in pixels) when the camera is at the origin.
+    BlendMode              blendMode {};       ///< The blend mode of the layer. Layers in front of other layers usually use alpha blending.
+
+    /// <summary>
+    /// Get the scroll offset of the layer for a camera position.
+    /// </summary>
+    /// <param name="camera">The position of the camera (in pixels).</param>
+    /// <returns>The scroll offset of the layer (in pixels).</returns>
+    glm::ivec2 getScrollOffset( const glm::vec2& camera ) const noexcept
+    {
+        return offset + glm::ivec2 { static_cast<int>( std::floor( camera.x * parallax.x ) ), static_cast<int>( std::floor( camera.y * parallax.y ) ) };
+    }
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "TileCollisionMap.hpp"
+
+#include <math/BitGrid.hpp>
+#include <math/WorkerPool.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// The search algorithm used by the path finder.
+/// </summary>
+enum class PathAlgorithm : uint8_t
+{
+    AStar,      ///< A* over the 8 neighbors of every cell. The path contains every cell that is visited.
+    JumpPoint,  ///< Jump point search. Much faster on open grids. The path only contains the turning points.
+};
+
+/// <summary>
+/// A single path finding query for <see cref="findPaths"/>.
+/// </summary>
+struct PathQuery
+{
+    glm::ivec2              start;          ///< The cell to start the search from.
+    glm::ivec2              goal;           ///< The cell to find a path to.
+    std::vector<glm::ivec2> path;           ///< The resulting path. Reuse the query to avoid reallocating the path.
+    bool                    found = false;  ///< Whether a path was found.
+};
+
+/// <summary>
+/// Create a walkability grid from a collision map. Every cell that is not solid is walkable.
+/// </summary>
+/// <param name="collisionMap">The collision map of the tile map.</param>
+/// <returns>A grid where the set cells are walkable.</returns>
+BitGrid getWalkableGrid( const TileCollisionMap& collisionMap );
+
+/// <summary>
+/// Finds the shortest path between two cells of a walkability grid.
+///
+/// Movement is allowed to the 8 neighbors of a cell. Diagonal moves cost sqrt(2) and are only allowed
+/// if both adjacent orthogonal cells are walkable (paths never cut corners).
+///
+/// A path finder holds the search state (node table and open list) which is reused by every query.
+/// Once it has grown to the size of the largest grid it's used with, a query doesn't allocate memory
+/// (as long as the output path has enough capacity). Path finders are not thread safe, use one per thread.
+/// </summary>
+class PathFinder
+{
+public:
+    PathFinder() = default;
+
+    /// <summary>
+    /// Create a path finder with preallocated storage for a grid.
+    /// </summary>
+    /// <param name="width">The width of the largest grid the path finder is used with.</param>
+    /// <param name="height">The height of the largest grid the path finder is used with.</param>
+    PathFinder( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Find the shortest path between two cells.
+    /// </summary>
+    /// <param name="walkable">The walkability grid. Set cells are walkable.</param>
+    /// <param name="start">The cell to start the search from.</param>
+    /// <param name="goal">The cell to find a path to.</param>
+    /// <param name="path">Receives the cells of the path from start to goal (inclusive). Cleared if no path is found.</param>
+    /// <param name="algorithm">(Optional) The search algorithm. Default: Jump point search.</param>
+    /// <returns>true if a path was found.</returns>
+    bool findPath( const BitGrid& walkable, const glm::ivec2& start, const glm::ivec2& goal, std::vector<glm::ivec2>& path, PathAlgorithm algorithm = PathAlgorithm::JumpPoint );
+
+    /// <summary>
+    /// Get the number of nodes that were expanded by the last query.
+    /// </summary>
+    size_t getNumExpanded() const noexcept
+    {
+        return m_NumExpanded;
+    }
+
+private:
+    struct Node
+    {
+        float    g;               // The cost of the best known path from the start to this node.
+        uint32_t parent;          // The index of the previous node on the path.
+        uint32_t generation = 0;  // The query that last touched this node. The node is unvisited if it doesn't match the current generation.
+        uint32_t heapIndex;       // The position of the node in the open list (while it's open).
+        bool     closed;          // The node was expanded.
+    };
+
+    struct OpenNode
+    {
+        float    f;  // The estimated cost of the path through this node.
+        uint32_t index;
+    };
+
+    void reserve( uint32_t width, uint32_t height );
+
+    // Begin a new query. Invalidates every node without touching the node table.
+    void beginQuery();
+
+    // Add a node to the open list (or update it if a shorter path was found).
+    void open( uint32_t index, uint32_t parent, float g, const glm::ivec2& cell, const glm::ivec2& goal );
+
+    // Pop the node with the lowest cost from the open list. Returns false if the open list is empty.
+    bool popOpen( uint32_t& index );
+
+    // Restore the heap order by moving an entry of the open list up or down.
+    void siftUp( size_t i ) noexcept;
+    void siftDown( size_t i ) noexcept;
+
+    void expandAStar( const BitGrid& walkable, const glm::ivec2& cell, uint32_t index, const glm::ivec2& goal );
+    void expandJumpPoint( const BitGrid& walkable, const glm::ivec2& cell, uint32_t index, const glm::ivec2& goal );
+
+    void buildPath( uint32_t goalIndex, uint32_t width, std::vector<glm::ivec2>& path ) const;
+
+    std::vector<Node>     m_Nodes;
+    std::vector<OpenNode> m_Open;  // Indexed binary min-heap. Every node is in it at most once, nodes whose cost was improved are moved up in place.
+    uint32_t              m_Generation  = 0u;
+    uint32_t              m_Width       = 0u;
+    size_t                m_NumExpanded = 0u;
+};
+
+/// <summary>
+/// Find many paths in parallel.
+/// The queries are distributed over the path finders and every path finder runs on a thread of the worker pool
+/// (the first one on the calling thread). Keep the worker pool, the path finders, and the queries between calls:
+/// once they have grown to the largest batch, a call doesn't start threads or allocate memory.
+/// </summary>
+/// <param name="walkable">The walkability grid. Set cells are walkable.</param>
+/// <param name="queries">The queries to solve. The results are written to the path and found members of each query.</param>
+/// <param name="pathFinders">The path finders to use. One thread is used per path finder.</param>
+/// <param name="workers">The worker pool that runs the path finders. It grows to the number of path finders.</param>
+/// <param name="algorithm">(Optional) The search algorithm. Default: Jump point search.</param>
+void findPaths( const BitGrid& walkable, std::span<PathQuery> queries, std::span<PathFinder> pathFinders, WorkerPool& workers, PathAlgorithm algorithm = PathAlgorithm::JumpPoint );
+
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "Color.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>  // For std::min
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// The inputs that a pixel shader can read.
+/// A shader declares the inputs it reads with a static constexpr member `inputs`, and the rasterizer only computes those.
+/// Shaders without this member (for example, lambdas) receive all inputs.
+/// </summary>
+struct PixelInput
+{
+    static constexpr uint32_t None        = 0u;
+    static constexpr uint32_t UV          = 1u << 0;  ///< The texture coordinates.
+    static constexpr uint32_t Position    = 1u << 1;  ///< The position of the pixel on the color target.
+    static constexpr uint32_t SourceColor = 1u << 2;  ///< The source color: the texel multiplied by the sprite color or the vertex color.
+    static constexpr uint32_t All         = UV | Position | SourceColor;
+};
+
+/// <summary>
+/// The inputs of a pixel shader for a single pixel. Inputs that the shader does not read are not initialized.
+/// </summary>
+struct Fragment
+{
+    glm::vec2  uv;        ///< The texture coordinates (texels for sprites, the interpolated vertex texture coordinates for triangles).
+    glm::ivec2 position;  ///< The position of the pixel on the color target.
+    Color      color;     ///< The source color.
+};
+
+/// <summary>
+/// The inputs of a pixel shader for a block of N consecutive pixels of a row, stored as a structure of arrays
+/// so the shader can process all pixels of the block with SIMD instructions.
+/// The inputs of the pixels that are not drawn (not set in the mask) are zero.
+/// </summary>
+template<size_t N>
+struct FragmentBlock
+{
+    std::array<float, N> u;         ///< The texture coordinates.
+    std::array<float, N> v;         ///< The texture coordinates.
+    std::array<Color, N> color;     ///< The source colors.
+    glm::ivec2           position;  ///< The position of the first pixel of the block on the color target.
+    uint32_t             mask;      ///< Bit i is set if pixel i of the block is drawn.
+};
+
+/// <summary>
+/// A pixel shader that is called for every pixel: Color shader( const Fragment& ).
+/// </summary>
+template<typename Shader>
+concept ScalarPixelShader = requires( Shader& shader, const Fragment& fragment ) {
+    { shader( fragment ) } -> std::convertible_to<Color>;
+};
+
+/// <summary>
+/// A pixel shader that is called for blocks of 4 or 8 pixels: std::array<Color, N> shader( const FragmentBlock<N>& ).
+/// The width of the blocks is declared with a static constexpr member `blockWidth` (usually CPPRAST_SIMD_WIDTH).
+/// </summary>
+template<typename Shader>
+concept BlockPixelShader = requires {
+    { Shader::blockWidth } -> std::convertible_to<size_t>;
+} && ( Shader::blockWidth == 4 || Shader::blockWidth == 8 ) && requires( Shader& shader, const FragmentBlock<Shader::blockWidth>& block ) {
+    { shader( block ) } -> std::convertible_to<std::array<Color, Shader::blockWidth>>;
+};
+
+/// <summary>
+/// A pixel shader: a functor that computes the color of a pixel (or a block of pixels) before it is blended with the color target.
+/// The shader is a template parameter of the draw functions, so it is inlined into the span loops.
+/// </summary>
+template<typename Shader>
+concept PixelShader = ScalarPixelShader<std::remove_cvref_t<Shader>> || BlockPixelShader<std::remove_cvref_t<Shader>>;
+
+/// <summary>
+/// Get the inputs that a pixel shader reads.
+/// </summary>
+template<typename Shader>
+constexpr uint32_t getPixelInputs() noexcept
+{
+    if constexpr ( requires { std::remove_cvref_t<Shader>::inputs; } )
+        return std::remove_cvref_t<Shader>::inputs;
+    else
+        return PixelInput::All;
+}
+
+/// <summary>
+/// The pixel shader that outputs the source color. This is the shader of the draw functions without a shader parameter.
+/// </summary>
+struct SourceColorShader
+{
+    static constexpr uint32_t inputs = PixelInput::SourceColor;
+
+    Color operator()( const Fragment& fragment ) const noexcept
+    {
+        return fragment.color;
+    }
+};
+
+/// <summary>
+/// The pixel shader that outputs a constant color.
+/// </summary>
+struct ConstantColorShader
+{
+    static constexpr uint32_t inputs = PixelInput::None;
+
+    Color color;
+
+    Color operator()( const Fragment& ) const noexcept
+    {
+        return color;
+    }
+};
+
+namespace detail
+{
+// Shade the pixels first..last (inclusive) of a row.
+// fetch( x, fragment ) computes the inputs of the pixel at x, and returns false if the pixel is not drawn.
+// It is called exactly once for every pixel of the span, in order, so it can step its inputs across the span.
+// output( x, color ) is called with the color of every pixel that is drawn.
+template<typename Shader, typename FetchFunc, typename OutputFunc>
+void shadeSpan( Shader& shader, int y, int first, int last, FetchFunc&& fetch, OutputFunc&& output )
+{
+    using ShaderType = std::remove_cvref_t<Shader>;
+
+    if constexpr ( BlockPixelShader<ShaderType> )
+    {
+        constexpr int N = static_cast<int>( ShaderType::blockWidth );
+
+        for ( int x0 = first; x0 <= last; x0 += N )
+        {
+            const int count = std::min( N, last - x0 + 1 );
+
+            FragmentBlock<ShaderType::blockWidth> block {};
+            block.position = { x0, y };
+
+            for ( int i = 0; i < count; ++i )
+            {
+                Fragment fragment { {}, { x0 + i, y }, {} };
+                if ( fetch( x0 + i, fragment ) )
+                {
+                    block.u[i]     = fragment.uv.x;
+                    block.v[i]     = fragment.uv.y;
+                    block.color[i] = fragment.color;
+                    block.mask |= 1u << i;
+                }
+            }
+
+            if ( block.mask == 0u )
+                continue;
+
+            const std::array<Color, ShaderType::blockWidth> colors = shader( block );
+            for ( int i = 0; i < count; ++i )
+            {
+                if ( block.mask & ( 1u << i ) )
+                    output( x0 + i, colors[i] );
+            }
+        }
+    }
+    else
+    {
+        for ( int x = first; x <= last; ++x )
+        {
+            Fragment fragment { {}, { x, y }, {} };
+            if ( fetch( x, fragment ) )
+                output( x, shader( fragment ) );
+        }
+    }
+}
+}  // namespace detail
+}  // namespace graphics
+}  // namespace cpprast
@@ -1,7 +1,28 @@
 #pragma once
 
+#include "AffineScanline.hpp"
+#include "Clipper.hpp"
+#include "CompressedTileMap.hpp"
+#include "DepthBuffer.hpp"
+#include "Mesh.hpp"
+#include "MultisampleTarget.hpp"
+#include "ParallaxLayer.hpp"
+#include "PixelShader.hpp"
+#include "RaycastCamera.hpp"
 #include "Sprite.hpp"
+#include "TileMap.hpp"
+#include "VertexProcessor.hpp"
+#include <math/FixedPoint.hpp>
 #include <math/Rect.hpp>
+#include <math/WorkerPool.hpp>
+
+#include <glm/mat3x3.hpp>
+
+#include <array>
+#include <cmath>  // For std::abs
+#include <memory>   // For std::unique_ptr
+#include <utility>  // For std::forward
+#include <vector>
 
 namespace cpprast
 {
@@ -15,8 +36,11 @@ public:
     /// </summary>
     struct State
     {
-        Image* colorTarget = nullptr;                    ///< The image to draw to.
-        RectUI clipRect { 0u, 0u, UINT_MAX, UINT_MAX };  ///< The clipping rectangle that restricts drawing to a specific region of the color target.
+        Image*             colorTarget       = nullptr;              ///< The image to draw to.
+        DepthBuffer*       depthTarget       = nullptr;              ///< (Optional) The depth buffer for depth testing of triangles. Must be the same size as the color target.
+        MultisampleTarget* multisampleTarget = nullptr;              ///< (Optional) Anti-alias triangles with 4x multisampling. Must be the same size as the color target. Replaces the depth target.
+        RectUI             clipRect { 0u, 0u, UINT_MAX, UINT_MAX };  ///< The clipping rectangle that restricts drawing to a specific region of the color target.
+        CullMode           cullMode = CullMode::Back;                ///< The triangles to cull. Front-facing triangles are clockwise on the color target.
     } state;
 
     /// <summary>
@@ -25,6 +49,12 @@ public:
     /// <param name="color">The color to clear the color target to. Default: Black.</param>
     void clear( const Color& color = Color::Black );
 
+    /// <summary>
+    /// Resolve the multisample target (if it is set) to the color target.
+    /// Call this after drawing anti-aliased triangles, before the color target is presented or sampled.
+    /// </summary>
+    void resolve();
+
     /// <summary>
     /// Draw a sprite to the color target at the specified screen position.
     /// The sprite is clipped to the viewport and destination image bounds.
@@ -34,7 +64,438 @@ public:
     /// <param name="x">The x-coordinate of the top-left corner of the sprite on the color target.</param>
     /// <param name="y">The y-coordinate of the top-left corner of the sprite on the color target.</param>
     void drawSprite( const Sprite& sprite, int x, int y );
+
+    /// <summary>
+    /// Draw a sprite to the color target at the specified screen position with a pixel shader.
+    /// The shader computes the color of every pixel before it is blended with the sprite's blend mode.
+    /// Its source color is the texel multiplied by the sprite's color, and its texture coordinates are the texel coordinates in the sprite's image.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="x">The x-coordinate of the top-left corner of the sprite on the color target.</param>
+    /// <param name="y">The y-coordinate of the top-left corner of the sprite on the color target.</param>
+    /// <param name="shader">The pixel shader (see <see cref="PixelShader"/>).</param>
+    template<PixelShader Shader>
+    void drawSprite( const Sprite& sprite, int x, int y, Shader&& shader );
+
+    /// <summary>
+    /// Draw a sprite with an affine transform (for example, rotated, scaled, or at a sub-pixel position).
+    /// The transform maps sprite space (the top-left corner of the sprite is at (0, 0)) to the color target.
+    /// Pixels are drawn if their center is inside the transformed sprite, and the sprite is sampled with nearest filtering.
+    ///
+    /// The destination bounds are computed with 28.4 fixed-point sub-pixel precision, and the texture coordinates are
+    /// stepped across the pixels in 16.16 fixed-point, so the result is bit-reproducible across compilers and machines.
+    /// Sprites are not drawn if the transform exceeds these ranges: if the sprite is moved too far off the color target,
+    /// or the texture coordinates of the drawn pixels (or their gradients) are 16384 or more.
+    /// </summary>
+    /// <param name="sprite">The sprite to draw.</param>
+    /// <param name="transform">The 2D affine transform (in homogeneous coordinates) from sprite space to the color target.</param>
+    void drawSprite( const Sprite& sprite, const glm::mat3& transform );
+
+    /// <summary>
+    /// Draw a tile map to the color target at the specified screen position.
+    /// Only the tiles that overlap the clipping rectangle are drawn. Empty tiles (-1) are skipped.
+    /// </summary>
+    /// <param name="tileMap">The tile map to draw.</param>
+    /// <param name="x">The x-coordinate of the top-left corner of the tile map on the color target.</param>
+    /// <param name="y">The y-coordinate of the top-left corner of the tile map on the color target.</param>
+    void drawTileMap( const TileMap& tileMap, int x, int y );
+
+    /// <summary>
+    /// Draw a compressed tile map to the color target at the specified screen position.
+    /// The tiles are drawn run by run, so the sprite of a run is only looked up once and runs of empty tiles are skipped entirely.
+    /// </summary>
+    /// <param name="tileMap">The compressed tile map to draw.</param>
+    /// <param name="x">The x-coordinate of the top-left corner of the tile map on the color target.</param>
+    /// <param name="y">The y-coordinate of the top-left corner of the tile map on the color target.</param>
+    void drawTileMap( const CompressedTileMap& tileMap, int x, int y );
+
+    /// <summary>
+    /// Fill a rectangle of the color target with an image that repeats infinitely in both directions (for example, a scrolling background).
+    /// The wrapping is resolved once per row, so every repetition of the image on a row is a single contiguous copy
+    /// (or a single blended span), and only the first and the last repetition are partial.
+    /// </summary>
+    /// <param name="image">The image to repeat.</param>
+    /// <param name="scrollOffset">The pixel of the image that is drawn at the top-left corner of the destination rectangle (can be negative or larger than the image).</param>
+    /// <param name="destRect">The rectangle of the color target to fill.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawTiledImage( const Image& image, const glm::ivec2& scrollOffset, const RectI& destRect, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw the layers of a parallax background, from back to front. Every layer is repeated to fill the destination rectangle,
+    /// and scrolled by the camera position multiplied by its parallax factor.
+    /// </summary>
+    /// <param name="layers">The layers to draw, from back to front. Layers without an image are skipped.</param>
+    /// <param name="camera">The position of the camera (in pixels).</param>
+    /// <param name="destRect">The rectangle of the color target to fill.</param>
+    void drawParallaxLayers( std::span<const ParallaxLayer> layers, const glm::vec2& camera, const RectI& destRect );
+
+    /// <summary>
+    /// Draw an image with a separate affine transform for every row of the color target (for example, a "Mode 7" floor plane).
+    /// The texture coordinates are computed once per row, and stepped across the pixels in 16.16 fixed-point.
+    /// Out-of-bounds texture coordinates are resolved with the address mode of the sampler, and wrapping power-of-2 images
+    /// only mask the texture coordinates. Normalized texture coordinates are mapped to texels like <see cref="Image::sample"/>.
+    /// </summary>
+    /// <param name="image">The image to sample.</param>
+    /// <param name="scanlines">The scanlines of consecutive rows of the color target, starting at row top.</param>
+    /// <param name="top">(Optional) The row of the color target of the first scanline.</param>
+    /// <param name="samplerState">(Optional) Determines how the image is sampled.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawAffineScanlines( const Image& image, std::span<const AffineScanline> scanlines, int top = 0, const SamplerState& samplerState = SamplerState {},
+                              const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw an image as a perspective ground plane seen from a camera. Only the rows below the horizon are drawn.
+    /// </summary>
+    /// <param name="image">The image to sample.</param>
+    /// <param name="camera">The camera that generates the scanlines of the rows.</param>
+    /// <param name="samplerState">(Optional) Determines how the image is sampled.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawAffineScanlines( const Image& image, const PlaneCamera& camera, const SamplerState& samplerState = SamplerState {}, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw a first-person view of a tile map with a grid raycaster (like Wolfenstein 3D).
+    /// One ray per column of the color target is traced through the cells of the tile map (DDA), and the first non-empty cell
+    /// is drawn as a vertical wall slice, textured with the sprite of the cell. The texture coordinates are stepped down the column
+    /// in 16.16 fixed-point. The pixels below and above the wall are textured with the sprites of the floor and ceiling tile maps.
+    /// The projection covers the whole color target, and only the pixels inside the clipping rectangle are drawn.
+    ///
+    /// The columns are independent, so they can be split across worker threads. The rasterizer starts the worker threads
+    /// on the first multithreaded draw and keeps them, so later draws don't start threads or allocate memory.
+    /// </summary>
+    /// <param name="walls">The tile map of the walls. Empty cells (-1) are open space.</param>
+    /// <param name="camera">The camera.</param>
+    /// <param name="floor">(Optional) The tile map of the floor textures. Must be the same size as the walls. Default: The floor is not drawn.</param>
+    /// <param name="ceiling">(Optional) The tile map of the ceiling textures. Must be the same size as the walls. Default: The ceiling is not drawn.</param>
+    /// <param name="numThreads">(Optional) The number of threads to draw the columns with, including the calling thread. Default: 1.</param>
+    void drawRaycast( const TileMap& walls, const RaycastCamera& camera, const TileMap* floor = nullptr, const TileMap* ceiling = nullptr, unsigned numThreads = 1 );
+
+    /// <summary>
+    /// Draw a list of triangles with a solid color.
+    /// The triangles are clipped against the near plane and the guard band of the viewport (see <see cref="Clipper"/>),
+    /// and only the pixels inside the viewport and the clipping rectangle are visited.
+    /// The triangles are depth tested like textured triangles, if a depth target or a multisample target is set.
+    /// </summary>
+    /// <param name="vertices">The transformed vertices. Every vertex that is referenced by the indices must be transformed.</param>
+    /// <param name="indices">The indices of the vertices, 3 per triangle.</param>
+    /// <param name="color">The color of the triangles.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawTriangles( const VertexProcessor& vertices, std::span<const uint32_t> indices, const Color& color, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw a list of triangles with interpolated texture coordinates and colors.
+    /// The attributes are interpolated perspective-correct: the attributes divided by w are interpolated across the triangle,
+    /// and divided by the interpolated 1/w every 16 pixels (more often on steeply receding spans). In between, the attributes are stepped linearly.
+    /// The depth is interpolated linearly and tested against the depth target (if it is set). Pixels closer than the depth
+    /// target are drawn and update the depth target, and pixels beyond the far plane of the viewport are discarded.
+    /// </summary>
+    /// <param name="vertices">The transformed vertices. Every vertex that is referenced by the indices must be transformed.</param>
+    /// <param name="attributes">The attributes of the vertices.</param>
+    /// <param name="indices">The indices of the vertices, 3 per triangle.</param>
+    /// <param name="texture">(Optional) The texture to sample with the texture coordinates. The sampled color is multiplied by the vertex color.</param>
+    /// <param name="samplerState">(Optional) Determines how the texture is sampled.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, const Image* texture = nullptr,
+                        const SamplerState& samplerState = SamplerState {}, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw a list of triangles with interpolated texture coordinates and colors, and a pixel shader.
+    /// The shader computes the color of every pixel that passes the depth test, before it is blended.
+    /// Its source color is the sampled texel (if there is a texture) multiplied by the vertex color, and its texture coordinates are
+    /// the interpolated texture coordinates of the vertices. The attributes are only interpolated if the shader reads them.
+    /// </summary>
+    /// <param name="vertices">The transformed vertices. Every vertex that is referenced by the indices must be transformed.</param>
+    /// <param name="attributes">The attributes of the vertices.</param>
+    /// <param name="indices">The indices of the vertices, 3 per triangle.</param>
+    /// <param name="shader">The pixel shader (see <see cref="PixelShader"/>).</param>
+    /// <param name="texture">(Optional) The texture to sample for the source color.</param>
+    /// <param name="samplerState">(Optional) Determines how the texture is sampled.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    template<PixelShader Shader>
+    void drawTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, Shader&& shader, const Image* texture = nullptr,
+                        const SamplerState& samplerState = SamplerState {}, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw an indexed mesh with its texture coordinates.
+    /// Only the vertices that are referenced by the mesh and not in the post-transform cache of the vertex processor are transformed,
+    /// so drawing the same mesh again with the same transform (for example, to another pass) does not transform any vertices.
+    /// </summary>
+    /// <param name="vertices">The vertex processor with the transform of the mesh.</param>
+    /// <param name="mesh">The mesh to draw.</param>
+    /// <param name="texture">(Optional) The texture to sample with the texture coordinates of the mesh.</param>
+    /// <param name="samplerState">(Optional) Determines how the texture is sampled. Mesh texture coordinates are normalized.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    void drawIndexed( VertexProcessor& vertices, const Mesh& mesh, const Image* texture = nullptr, const SamplerState& samplerState = SamplerState::WrapNormalized,
+                      const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Draw an indexed mesh with its texture coordinates and a pixel shader.
+    /// </summary>
+    /// <param name="vertices">The vertex processor with the transform of the mesh.</param>
+    /// <param name="mesh">The mesh to draw.</param>
+    /// <param name="shader">The pixel shader (see <see cref="PixelShader"/>).</param>
+    /// <param name="texture">(Optional) The texture to sample for the source color.</param>
+    /// <param name="samplerState">(Optional) Determines how the texture is sampled. Mesh texture coordinates are normalized.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
+    template<PixelShader Shader>
+    void drawIndexed( VertexProcessor& vertices, const Mesh& mesh, Shader&& shader, const Image* texture = nullptr, const SamplerState& samplerState = SamplerState::WrapNormalized,
+                      const BlendMode& blendMode = BlendMode {} )
+    {
+        vertices.transform( mesh.getPositions(), mesh.getIndices() );
+        drawTriangles( vertices, mesh.getAttributes(), mesh.getIndices(), std::forward<Shader>( shader ), texture, samplerState, blendMode );
+    }
+
+private:
+    /// <summary>
+    /// The number of pixels between the perspective divisions when interpolating the attributes of a triangle.
+    /// The attributes are stepped linearly (affine) between the divisions, which is not visible for spans this short.
+    /// </summary>
+    static constexpr int SpanLength = 16;
+
+    /// <summary>
+    /// The maximum relative change of 1/w over a segment between two perspective divisions.
+    /// Steeply receding spans are divided more often, the error of the linear steps grows with the change of 1/w.
+    /// </summary>
+    static constexpr float MaxInvWChange = 0.125f;
+
+    /// <summary>
+    /// A span of covered pixels of a row of a triangle, and the values that are interpolated across it.
+    /// </summary>
+    struct TriangleSpan
+    {
+        int                  y;         ///< The row.
+        int                  first;     ///< The first pixel of the span.
+        int                  last;      ///< The last pixel of the span (inclusive).
+        std::array<float, 7> q;         ///< The attributes divided by w (u, v, r, g, b, a) and 1/w at the first pixel.
+        std::array<float, 7> dq;        ///< The change of q per pixel.
+        float                z;         ///< The depth at the first pixel.
+        float                dz;        ///< The change of the depth per pixel.
+        float                dzdy;      ///< The change of the depth per row.
+        uint8_t*             coverage;  ///< The coverage masks of the pixels of the span with multisampling, nullptr otherwise.
+    };
+
+    using SpanFunc = void ( * )( void* context, const TriangleSpan& span );
+
+    /// <summary>
+    /// Clip, set up, and rasterize a list of triangles, and call a function for every span of covered pixels.
+    /// This is not a template, so only the span loop is instantiated for every pixel shader.
+    /// </summary>
+    void rasterizeTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, SpanFunc spanFunc, void* context );
+
+    // The coverage masks of the current span with multisampling.
+    std::vector<uint8_t> m_Coverage;
+
+    // The distance to the floor and the ceiling seen by every row of the color target when raycasting.
+    std::vector<float> m_RowDistance;
+
+    // The threads that draw the columns when raycasting. Created by the first multithreaded draw.
+    std::unique_ptr<WorkerPool> m_Workers;
 };
 
+template<PixelShader Shader>
+void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y, Shader&& shader )
+{
+    constexpr uint32_t inputs = getPixelInputs<Shader>();
+
+    const Image* srcImage = sprite.getImage().get();
+    Image*       dstImage = state.colorTarget;
+
+    if ( !srcImage || !dstImage )
+        return;
+
+    const Color      color     = sprite.getColor();
+    const BlendMode  blendMode = sprite.getBlendMode();
+    const AABB       clipAABB  = AABB::fromRect( state.clipRect );
+    const AABB       dstAABB   = dstImage->getAABB().clamped( clipAABB );
+    const glm::ivec2 size      = sprite.getSize();
+    glm::ivec2       uv        = sprite.getUV();
+
+    // Compute viewport clipping bounds.
+    const int clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), _x );
+    const int clipTop    = std::max( static_cast<int>( dstAABB.min.y ), _y );
+    const int clipRight  = std::min( static_cast<int>( dstAABB.max.x ), _x + size.x - 1 );
+    const int clipBottom = std::min( static_cast<int>( dstAABB.max.y ), _y + size.y - 1 );
+
+    // Check if the sprite is completely off-screen.
+    if ( clipLeft >= clipRight || clipTop >= clipBottom )
+        return;
+
+    // Adjust sprite UV based on clipping.
+    uv.x += clipLeft - _x;
+    uv.y += clipTop - _y;
+
+    const Color* src = srcImage->data();
+    Color*       dst = dstImage->data();
+
+    int sS = srcImage->getStride();  // Source image stride.
+    int dS = dstImage->getStride();  // Destination image stride.
+
+    for ( int y = clipTop; y <= clipBottom; ++y )
+    {
+        // Compute clipped UV sprite texture coordinates.
+        const int    v      = uv.y + ( y - clipTop );
+        const Color* srcRow = src + v * sS;
+
+        Color* dstRow = dst + y * dS;
+
+        auto fetch = [&]( int x, Fragment& fragment ) {
+            const int u = uv.x + ( x - clipLeft );
+
+            if constexpr ( ( inputs & PixelInput::UV ) != 0u )
+                fragment.uv = { static_cast<float>( u ), static_cast<float>( v ) };
+
+            if constexpr ( ( inputs & PixelInput::SourceColor ) != 0u )
+                fragment.color = srcRow[u] * color;
+
+            return true;
+        };
+
+        detail::shadeSpan( shader, y, clipLeft, clipRight, fetch, [&]( int x, const Color& c ) { dstRow[x] = blendMode.Blend( c, dstRow[x] ); } );
+    }
+}
+
+template<PixelShader Shader>
+void Rasterizer::drawTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, Shader&& shader, const Image* texture,
+                                const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    constexpr uint32_t inputs = getPixelInputs<Shader>();
+
+    // The attributes are only interpolated (and divided by 1/w) if the shader reads them.
+    constexpr bool needsAttributes = ( inputs & ( PixelInput::UV | PixelInput::SourceColor ) ) != 0u;
+
+    Image* dstImage = state.colorTarget;
+    if ( !dstImage )
+        return;
+
+    DepthBuffer*       depthTarget       = state.depthTarget;
+    MultisampleTarget* multisampleTarget = state.multisampleTarget;
+    Color*             dst               = dstImage->data();
+    const int          dS                = dstImage->getStride();  // Destination image stride.
+    const int          dW                = dstImage->getWidth();   // Destination image width (the stride of the depth buffer).
+
+    // The far plane is not clipped against, pixels beyond it are discarded instead.
+    const float maxDepth = vertices.getViewport().maxDepth;
+
+    // The attributes of a pixel: u, v, r, g, b, a.
+    using Attributes = std::array<float, 6>;
+
+    auto drawSpan = [&]( const TriangleSpan& span ) {
+        Color* row      = dst + span.y * dS;
+        float* depthRow = depthTarget && !multisampleTarget ? depthTarget->data() + static_cast<ptrdiff_t>( span.y ) * dW : nullptr;
+
+        // Recover the attributes from the interpolants at an offset from the first pixel.
+        auto divide = [&]( float offset ) {
+            const float w = 1.0f / ( span.q[6] + span.dq[6] * offset );
+
+            Attributes a;
+            for ( size_t k = 0; k < 6; ++k )
+                a[k] = ( span.q[k] + span.dq[k] * offset ) * w;
+
+            return a;
+        };
+
+        // Divide at the ends of every segment, and step the attributes linearly in between.
+        // Shorten the segments if 1/w changes too fast along the span (1/w is linear, so its minimum is at one of the ends).
+        int        segmentLength = SpanLength;
+        int        segmentEnd    = span.first;
+        Attributes a {};
+        Attributes da {};
+        Attributes end {};
+
+        if constexpr ( needsAttributes )
+        {
+            const float minInvW = std::min( span.q[6], span.q[6] + span.dq[6] * static_cast<float>( span.last - span.first ) );
+            while ( segmentLength > 1 && std::abs( span.dq[6] ) * static_cast<float>( segmentLength ) > MaxInvWChange * minInvW )
+                segmentLength /= 2;
+
+            end = divide( 0.0f );
+        }
+
+        // Step the attributes to the next pixel. This is called for every pixel of the span, in order.
+        auto step = [&]( int x ) {
+            if constexpr ( needsAttributes )
+            {
+                if ( x == segmentEnd )
+                {
+                    const int length = std::min( segmentLength, span.last - x + 1 );
+
+                    a          = end;
+                    end        = divide( static_cast<float>( x + length - span.first ) );
+                    segmentEnd = x + length;
+
+                    for ( size_t k = 0; k < 6; ++k )
+                        da[k] = ( end[k] - a[k] ) / static_cast<float>( length );
+                }
+                else
+                {
+                    for ( size_t k = 0; k < 6; ++k )
+                        a[k] += da[k];
+                }
+            }
+        };
+
+        auto setInputs = [&]( Fragment& fragment ) {
+            if constexpr ( ( inputs & PixelInput::UV ) != 0u )
+                fragment.uv = { a[0], a[1] };
+
+            if constexpr ( ( inputs & PixelInput::SourceColor ) != 0u )
+            {
+                Color c {
+                    static_cast<uint8_t>( math::clamp( a[2], 0.0f, 255.0f ) ),
+                    static_cast<uint8_t>( math::clamp( a[3], 0.0f, 255.0f ) ),
+                    static_cast<uint8_t>( math::clamp( a[4], 0.0f, 255.0f ) ),
+                    static_cast<uint8_t>( math::clamp( a[5], 0.0f, 255.0f ) ),
+                };
+
+                if ( texture )
+                    c = texture->sample( a[0], a[1], samplerState ) * c;
+
+                fragment.color = c;
+            }
+        };
+
+        if ( span.coverage )
+        {
+            // Multisampling: the samples are depth tested, but the color is computed once per pixel (at the pixel center).
+            auto fetch = [&]( int x, Fragment& fragment ) {
+                step( x );
+
+                uint8_t&    coverage = span.coverage[x - span.first];
+                const float depth    = span.z + span.dz * static_cast<float>( x - span.first );
+
+                coverage = static_cast<uint8_t>( multisampleTarget->depthTest( x, span.y, coverage, depth, span.dz, span.dzdy, maxDepth ) );
+                if ( coverage == 0u )
+                    return false;
+
+                setInputs( fragment );
+                return true;
+            };
+
+            detail::shadeSpan( shader, span.y, span.first, span.last, fetch,
+                               [&]( int x, const Color& c ) { multisampleTarget->write( *dstImage, x, span.y, span.coverage[x - span.first], c, blendMode ); } );
+        }
+        else
+        {
+            auto fetch = [&]( int x, Fragment& fragment ) {
+                step( x );
+
+                const float depth = span.z + span.dz * static_cast<float>( x - span.first );
+                if ( depth > maxDepth || ( depthRow && depth >= depthRow[x] ) )
+                    return false;
+
+                if ( depthRow )
+                    depthRow[x] = depth;
+
+                setInputs( fragment );
+                return true;
+            };
+
+            detail::shadeSpan( shader, span.y, span.first, span.last, fetch, [&]( int x, const Color& c ) { row[x] = blendMode.Blend( c, row[x] ); } );
+        }
+    };
+
+    rasterizeTriangles(
+        vertices, attributes, indices, []( void* context, const TriangleSpan& span ) { ( *static_cast<decltype( drawSpan )*>( context ) )( span ); }, &drawSpan );
+}
+
 }  // namespace graphics
 }  // namespace cpprast
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cmath>  // For std::sin, std::cos, std::tan
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A first-person camera in the grid of a tile map, for the raycast column renderer (see <see cref="Rasterizer::drawRaycast"/>).
+/// Positions are in cells, every cell is a cube with a size of 1, and the eye is halfway between the floor and the ceiling.
+/// </summary>
+struct RaycastCamera
+{
+    glm::vec2 position { 0.0f };   ///< The position of the camera (in cells).
+    float     angle       = 0.0f;  ///< The heading of the camera (in radians). At 0 the camera looks towards -y (up on the tile map), increasing angles turn right.
+    float     fieldOfView = 1.15f; ///< The horizontal field of view (in radians). Default: 66 degrees.
+
+    /// <summary>
+    /// Get the direction the camera is looking at (a unit vector).
+    /// </summary>
+    glm::vec2 getDirection() const noexcept
+    {
+        return { std::sin( angle ), -std::cos( angle ) };
+    }
+
+    /// <summary>
+    /// Get the camera plane: the vector from the center to the right edge of the view, at a distance of 1 in front of the camera.
+    /// </summary>
+    glm::vec2 getPlane() const noexcept
+    {
+        const float halfWidth = std::tan( fieldOfView * 0.5f );
+        return { std::cos( angle ) * halfWidth, std::sin( angle ) * halfWidth };
+    }
+};
+}  // namespace graphics
+}  // namespace cpprast
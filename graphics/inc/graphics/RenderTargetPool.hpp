@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A pool of temporary images (render targets) for post effects, layers, and masks that are only needed during a frame.
+///
+/// Images are handed out by size and recycled, so steady-state frames do not allocate any pixel memory.
+/// An image that is released during a frame is handed out again by a later request of the same size in the same frame,
+/// so temporary targets whose lifetimes do not overlap share the same memory (aliasing), which reduces the peak memory.
+/// At the end of the frame, all images are returned to the pool, and images that have not been used for a number
+/// of frames are freed.
+///
+/// All images have the same pixel format (<see cref="Color"/>), so images are only matched by their size.
+/// </summary>
+class RenderTargetPool
+{
+public:
+    /// <summary>
+    /// Create an empty render target pool.
+    /// </summary>
+    /// <param name="maxIdleFrames">(Optional) The number of frames an image is kept in the pool without being used. Default: 3.</param>
+    explicit RenderTargetPool( uint32_t maxIdleFrames = 3u ) noexcept
+    : m_MaxIdleFrames { maxIdleFrames }
+    {}
+
+    /// <summary>
+    /// Get a temporary image with the Padded layout. The contents of the image are undefined.
+    /// The image stays valid (and is not handed out again) until it is released or the frame ends.
+    /// </summary>
+    /// <param name="width">The width of the image (in pixels).</param>
+    /// <param name="height">The height of the image (in pixels).</param>
+    /// <returns>The image.</returns>
+    Image& acquire( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Return an image to the pool before the end of the frame, so it can be reused by the following requests in this frame.
+    /// The image must not be used after it has been released.
+    /// </summary>
+    /// <param name="image">An image that was acquired from this pool.</param>
+    void release( const Image& image ) noexcept;
+
+    /// <summary>
+    /// End the frame: return all images to the pool, and free the images that have not been used for too long.
+    /// </summary>
+    void endFrame();
+
+    /// <summary>
+    /// Free all images that are not in use.
+    /// </summary>
+    void trim();
+
+    /// <summary>
+    /// Get the number of images in the pool (in use or not).
+    /// </summary>
+    size_t getNumImages() const noexcept
+    {
+        return m_Targets.size();
+    }
+
+    /// <summary>
+    /// Get the size of the pixels of all images in the pool (in bytes).
+    /// </summary>
+    size_t getMemoryUsage() const noexcept;
+
+private:
+    struct Target
+    {
+        Image    image;
+        bool     inUse     = false;
+        uint64_t lastFrame = 0u;  // The last frame the image was acquired in.
+    };
+
+    // The images are allocated separately, so references to them stay valid when images are added or freed.
+    std::vector<std::unique_ptr<Target>> m_Targets;
+
+    uint32_t m_MaxIdleFrames = 3u;
+    uint64_t m_Frame         = 0u;
+};
+}  // namespace graphics
+}  // namespace cpprast
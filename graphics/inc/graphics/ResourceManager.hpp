@@ -1,11 +1,14 @@
 #pragma once
 
+#include "CollisionMask.hpp"
 #include "Image.hpp"
 // #include "Font.hpp"
 // #include "SpriteSheet.hpp"
 
 #include <filesystem>  // For std::filesystem::path
 #include <memory>      // For std::shared_ptr
+#include <optional>
+#include <string>
 
 namespace cpprast
 {
@@ -14,6 +17,13 @@ inline namespace graphics
 namespace ResourceManager
 {
 
+/// <summary>
+/// Read the contents of a file.
+/// </summary>
+/// <param name="filePath">The path to the file to read.</param>
+/// <returns>The contents of the file, or an empty optional if the file couldn't be opened.</returns>
+std::optional<std::string> readFile( const std::filesystem::path& filePath );
+
 /// <summary>
 /// Load an image from a file path.
 /// </summary>
@@ -21,6 +31,16 @@ namespace ResourceManager
 /// <returns>The loaded image as a shared pointer, or null if the image couldn't be loaded.</returns>
 std::shared_ptr<Image> loadImage( const std::filesystem::path& filePath );
 
+/// <summary>
+/// Get the collision mask of a sprite.
+/// Masks are cached per image region and alpha threshold, so sprites that share a region of an image (for example,
+/// every instance of the same bullet) share a single mask.
+/// </summary>
+/// <param name="sprite">The sprite to get the collision mask for.</param>
+/// <param name="alphaThreshold">(Optional) The minimum alpha value of a solid pixel. Default: 128.</param>
+/// <returns>The collision mask of the sprite. An empty mask if the sprite has no image.</returns>
+std::shared_ptr<const CollisionMask> getCollisionMask( const Sprite& sprite, uint8_t alphaThreshold = 128u );
+
 /// <summary>
 /// Load a sprite sheet from a file path.
 /// </summary>
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Rasterizer.hpp"
+
+#include <math/Rect.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// Reuses the contents of the previous frame when the camera pans over static content (for example, in a side-scroller).
+///
+/// Instead of redrawing the whole frame, the previous frame is shifted in place by the distance the camera moved,
+/// and only the regions that changed are redrawn: the strips along the edges that scrolled into view, and the regions of
+/// the dynamic objects of the previous and the current frame (so moving objects are erased at their old position).
+///
+/// Usage, every frame:
+///   1. Register the bounds of every dynamic object with <see cref="addDynamicRegion"/>.
+///   2. Call <see cref="update"/> with the camera position to scroll the color target.
+///   3. Redraw the scene with <see cref="redraw"/> (or draw every region of <see cref="getDirtyRegions"/> yourself).
+/// </summary>
+class ScrollingFramebuffer
+{
+public:
+    /// <summary>
+    /// Default constructor. The first update redraws the whole color target.
+    /// </summary>
+    ScrollingFramebuffer() = default;
+
+    /// <summary>
+    /// Force the next update to redraw the whole color target (for example, when the static content changed).
+    /// </summary>
+    void invalidate() noexcept
+    {
+        m_Valid = false;
+    }
+
+    /// <summary>
+    /// Register a region that must be redrawn in the current frame, because its content changes (for example, the bounds of a moving sprite).
+    /// The region is also redrawn in the next frame, so the content is erased when it moves away.
+    /// </summary>
+    /// <param name="worldRect">The region in world coordinates (pixels, in the same space as the camera position).</param>
+    void addDynamicRegion( const RectI& worldRect );
+
+    /// <summary>
+    /// Scroll the contents of the color target to the new camera position, and compute the regions that must be redrawn.
+    /// The whole color target is redrawn if the camera moved further than its size, if its size changed, or after <see cref="invalidate"/>.
+    /// </summary>
+    /// <param name="image">The color target with the previous frame.</param>
+    /// <param name="cameraPosition">The world position (in pixels) of the top-left corner of the color target.</param>
+    void update( Image& image, const glm::ivec2& cameraPosition );
+
+    /// <summary>
+    /// Get the regions of the color target that must be redrawn in the current frame.
+    /// </summary>
+    std::span<const RectI> getDirtyRegions() const noexcept
+    {
+        return m_DirtyRegions;
+    }
+
+    /// <summary>
+    /// Redraw the dirty regions of the color target. Every region is cleared (if a clear color is specified), and then
+    /// the draw function is called with the clipping rectangle of the rasterizer set to the region. The clipping rectangle is restored afterwards.
+    /// </summary>
+    /// <param name="rasterizer">The rasterizer that draws to the color target.</param>
+    /// <param name="draw">The function that draws the scene: void draw( const RectI& region ).</param>
+    /// <param name="clearColor">(Optional) The color to clear the regions to before drawing. Default: Black.</param>
+    template<typename DrawFunc>
+    void redraw( Rasterizer& rasterizer, DrawFunc&& draw, const std::optional<Color>& clearColor = Color::Black )
+    {
+        const RectUI clipRect = rasterizer.state.clipRect;
+
+        for ( const RectI& region: m_DirtyRegions )
+        {
+            rasterizer.state.clipRect = RectUI { region };
+
+            if ( clearColor && rasterizer.state.colorTarget )
+                fill( *rasterizer.state.colorTarget, rasterizer.state.clipRect, *clearColor );
+
+            draw( region );
+        }
+
+        rasterizer.state.clipRect = clipRect;
+    }
+
+private:
+    // Fill the pixels of the color target that are inside a clipping rectangle (the pixels the rasterizer draws to) with a color.
+    static void fill( Image& image, const RectUI& clipRect, const Color& color ) noexcept;
+
+    // Add a region of the color target to the dirty regions, clipped to the color target.
+    void addDirtyRegion( RectI region );
+
+    bool       m_Valid = false;
+    glm::ivec2 m_CameraPosition { 0 };
+    glm::ivec2 m_Size { 0 };
+
+    std::vector<RectI> m_DynamicRegions;          // The dynamic regions of the current frame (in world coordinates).
+    std::vector<RectI> m_PreviousDynamicRegions;  // The dynamic regions of the previous frame (in world coordinates).
+    std::vector<RectI> m_DirtyRegions;            // The regions of the color target to redraw.
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "TileMap.hpp"
+
+#include <math/AABB.hpp>
+#include <math/BitGrid.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A solid tile that overlaps an AABB.
+/// </summary>
+struct TileContact
+{
+    glm::ivec2 tile;         ///< The column and row of the tile.
+    glm::vec2  penetration;  ///< The minimum translation vector. Subtract it from the AABB to separate it from the tile.
+};
+
+/// <summary>
+/// The first solid tile that is hit by a moving AABB.
+/// </summary>
+struct TileSweepHit
+{
+    glm::ivec2 tile;    ///< The column and row of the tile that was hit.
+    float      time;    ///< The fraction of the motion [0 ... 1] before the AABB touches the tile.
+    glm::vec2  normal;  ///< The normal of the face of the tile that was hit.
+};
+
+/// <summary>
+/// The first solid tile that is hit by a ray.
+/// </summary>
+struct TileRayHit
+{
+    glm::ivec2 tile;      ///< The column and row of the tile that was hit.
+    float      distance;  ///< The distance along the ray to the hit point.
+    glm::vec2  point;     ///< The point where the ray enters the tile.
+    glm::vec2  normal;    ///< The normal of the face of the tile that was hit (zero if the ray starts inside the tile).
+};
+
+/// <summary>
+/// The collision flags of the tiles of a tile map, packed into a bit grid (one bit per tile).
+/// Provides overlap, swept AABB, and ray queries against the solid tiles of the map.
+///
+/// All queries are performed in the local space of the tile map (in pixels, the top-left corner of the
+/// first tile is at the origin). Tiles outside the bounds of the map are never solid.
+/// None of the queries allocate memory.
+/// </summary>
+class TileCollisionMap
+{
+public:
+    /// <summary>
+    /// Default constructor. Creates an empty collision map.
+    /// </summary>
+    TileCollisionMap() = default;
+
+    /// <summary>
+    /// Create a collision map where every non-empty tile of the tile map is solid.
+    /// </summary>
+    /// <param name="tileMap">The tile map to create the collision map for.</param>
+    explicit TileCollisionMap( const TileMap& tileMap )
+    : TileCollisionMap( tileMap, []( int spriteId ) { return spriteId >= 0; } )
+    {}
+
+    /// <summary>
+    /// Create a collision map where the solid tiles are determined by a predicate.
+    /// </summary>
+    /// <param name="tileMap">The tile map to create the collision map for.</param>
+    /// <param name="isSolid">A function that returns `true` if a sprite index (-1 for empty tiles) is solid.</param>
+    template<typename Predicate>
+    TileCollisionMap( const TileMap& tileMap, Predicate&& isSolid )
+    : m_Solid { tileMap.getColumns(), tileMap.getRows() }
+    , m_TileSize { std::max( tileMap.getSpriteWidth(), 1u ), std::max( tileMap.getSpriteHeight(), 1u ) }
+    {
+        for ( uint32_t y = 0; y < tileMap.getRows(); ++y )
+        {
+            for ( uint32_t x = 0; x < tileMap.getColumns(); ++x )
+            {
+                if ( isSolid( tileMap.getSpriteId( x, y ) ) )
+                    m_Solid.set( x, y, true );
+            }
+        }
+    }
+
+    /// <summary>
+    /// Check if a tile is solid.
+    /// </summary>
+    /// <param name="x">The column of the tile.</param>
+    /// <param name="y">The row of the tile.</param>
+    /// <returns>true if the tile is solid, false if it is not, or is outside the bounds of the map.</returns>
+    bool isSolid( int x, int y ) const noexcept
+    {
+        return m_Solid.get( x, y );
+    }
+
+    /// <summary>
+    /// Mark a tile as solid or not.
+    /// </summary>
+    /// <param name="x">The column of the tile.</param>
+    /// <param name="y">The row of the tile.</param>
+    /// <param name="solid">Whether the tile is solid.</param>
+    void setSolid( uint32_t x, uint32_t y, bool solid ) noexcept
+    {
+        m_Solid.set( x, y, solid );
+    }
+
+    /// <summary>
+    /// Get the tile that contains a point.
+    /// </summary>
+    /// <param name="p">The point (in pixels).</param>
+    /// <returns>The column and row of the tile. The tile may be outside the bounds of the map.</returns>
+    glm::ivec2 getTile( const glm::vec2& p ) const noexcept;
+
+    /// <summary>
+    /// Get the bounds of a tile.
+    /// </summary>
+    /// <param name="x">The column of the tile.</param>
+    /// <param name="y">The row of the tile.</param>
+    /// <returns>The AABB of the tile (in pixels).</returns>
+    AABB getTileAABB( int x, int y ) const noexcept
+    {
+        const glm::vec2 min = glm::vec2 { static_cast<float>( x ), static_cast<float>( y ) } * m_TileSize;
+        return { min, min + m_TileSize };
+    }
+
+    /// <summary>
+    /// Check if an AABB overlaps any solid tile.
+    /// Touching the edge of a tile is not considered an overlap.
+    /// </summary>
+    /// <param name="aabb">The AABB to test.</param>
+    /// <returns>true if the AABB overlaps at least one solid tile.</returns>
+    bool overlaps( const AABB& aabb ) const noexcept;
+
+    /// <summary>
+    /// Find the solid tiles that overlap an AABB.
+    /// Touching the edge of a tile is not considered an overlap.
+    /// </summary>
+    /// <param name="aabb">The AABB to test.</param>
+    /// <param name="contacts">The buffer to write the contacts to. Contacts that don't fit in the buffer are discarded.</param>
+    /// <returns>The number of contacts written to the buffer.</returns>
+    size_t overlap( const AABB& aabb, std::span<TileContact> contacts ) const noexcept;
+
+    /// <summary>
+    /// Move an AABB and find the first solid tile that it hits.
+    /// Tiles that already overlap the AABB at the start of the motion are ignored (use <see cref="overlap"/> to resolve those).
+    /// Sliding along the edge of a tile is not considered a hit.
+    /// </summary>
+    /// <param name="aabb">The AABB at the start of the motion.</param>
+    /// <param name="delta">The motion of the AABB.</param>
+    /// <returns>The first tile that is hit, or an empty optional if the AABB can move freely.</returns>
+    std::optional<TileSweepHit> sweep( const AABB& aabb, const glm::vec2& delta ) const noexcept;
+
+    /// <summary>
+    /// Cast a ray through the grid and find the first solid tile it enters.
+    /// The tiles are traversed in order using a DDA (Amanatides & Woo), so the cost is proportional to the number of tiles crossed.
+    /// </summary>
+    /// <param name="origin">The origin of the ray.</param>
+    /// <param name="direction">The direction of the ray. Does not need to be normalized.</param>
+    /// <param name="maxDistance">(Optional) The maximum distance along the ray. Default: Unlimited.</param>
+    /// <returns>The first solid tile along the ray, or an empty optional if no solid tile is hit.</returns>
+    std::optional<TileRayHit> raycast( const glm::vec2& origin, const glm::vec2& direction, float maxDistance = std::numeric_limits<float>::max() ) const noexcept;
+
+    /// <summary>
+    /// Get the grid of collision flags (one bit per tile).
+    /// </summary>
+    const BitGrid& getSolidGrid() const noexcept
+    {
+        return m_Solid;
+    }
+
+    /// <summary>
+    /// Gets the number of columns in the collision map.
+    /// </summary>
+    uint32_t getColumns() const noexcept
+    {
+        return m_Solid.getWidth();
+    }
+
+    /// <summary>
+    /// Gets the number of rows in the collision map.
+    /// </summary>
+    uint32_t getRows() const noexcept
+    {
+        return m_Solid.getHeight();
+    }
+
+    /// <summary>
+    /// Gets the size of a single tile (in pixels).
+    /// </summary>
+    const glm::vec2& getTileSize() const noexcept
+    {
+        return m_TileSize;
+    }
+
+private:
+    /// <summary>
+    /// Get the range of tiles (inclusive) that an AABB overlaps, clamped to the bounds of the map.
+    /// </summary>
+    /// <returns>The first and last tile, or an empty optional if the AABB doesn't overlap the map.</returns>
+    std::optional<std::pair<glm::ivec2, glm::ivec2>> getTileRange( const AABB& aabb ) const noexcept;
+
+    BitGrid   m_Solid;
+    glm::vec2 m_TileSize { 1.0f };
+};
+}  // namespace graphics
+}  // namespace cpprast
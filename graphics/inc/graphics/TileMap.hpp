@@ -2,10 +2,29 @@
 
 #include "SpriteSheet.hpp"
 
+#include <cassert>
+#include <cstdint>
+#include <cstring>  // For std::memcpy
+#include <optional>
+#include <span>
+#include <vector>
+
 namespace cpprast
 {
 inline namespace graphics
 {
+/// <summary>
+/// The storage type of a single cell of a tile map.
+/// Smaller formats reduce the memory footprint of the tile map but limit the number
+/// of sprites that can be referenced from the sprite sheet.
+/// </summary>
+enum class TileIndexFormat : uint8_t
+{
+    UInt8,   ///< 1 byte per cell. Supports sprite sheets with up to 255 sprites.
+    UInt16,  ///< 2 bytes per cell. Supports sprite sheets with up to 65,535 sprites.
+    UInt32   ///< 4 bytes per cell. Supports any sprite sheet.
+};
+
 /// <summary>
 /// Represents a 2D grid of tiles, where each tile is a sprite from a sprite sheet.
 /// TileMap provides a way to organize and access sprites in a grid-like structure.
@@ -13,6 +32,56 @@ inline namespace graphics
 class TileMap
 {
 public:
+    /// <summary>
+    /// A proxy reference to a single cell of the tile map.
+    /// Cells are stored in a compact format so they can't be referenced directly.
+    /// </summary>
+    class TileRef
+    {
+    public:
+        /// <summary>
+        /// Read the sprite index stored in the cell.
+        /// </summary>
+        operator int() const noexcept
+        {
+            return m_TileMap.getSpriteId( m_X, m_Y );
+        }
+
+        /// <summary>
+        /// Store a sprite index in the cell.
+        /// </summary>
+        /// <param name="spriteId">The sprite index to store (-1 for an empty cell).</param>
+        /// <returns>A reference to this cell.</returns>
+        TileRef& operator=( int spriteId )
+        {
+            m_TileMap.setSpriteId( m_X, m_Y, spriteId );
+            return *this;
+        }
+
+        /// <summary>
+        /// Copy the sprite index from another cell.
+        /// </summary>
+        /// <param name="other">The cell to copy the sprite index from.</param>
+        /// <returns>A reference to this cell.</returns>
+        TileRef& operator=( const TileRef& other )
+        {
+            return operator=( static_cast<int>( other ) );
+        }
+
+    private:
+        friend class TileMap;
+
+        TileRef( TileMap& tileMap, size_t x, size_t y ) noexcept
+        : m_TileMap { tileMap }
+        , m_X { x }
+        , m_Y { y }
+        {}
+
+        TileMap& m_TileMap;
+        size_t   m_X;
+        size_t   m_Y;
+    };
+
     /// <summary>
     /// Default constructor. Creates an empty tile map with no sprites.
     /// </summary>
@@ -24,7 +93,24 @@ public:
     /// <param name="spriteSheet">The sprite sheet containing the sprites to use in the tile map.</param>
     /// <param name="columns">The number of columns in the tile map.</param>
     /// <param name="rows">The number of rows in the tile map.</param>
-    TileMap( std::shared_ptr<SpriteSheet> spriteSheet, uint32_t columns, uint32_t rows );
+    /// <param name="indexFormat">(Optional) The storage format of the cells. Default: The smallest format that can index every sprite in the sprite sheet.
+    /// The format is widened when a sprite index that doesn't fit in it is stored.</param>
+    TileMap( std::shared_ptr<SpriteSheet> spriteSheet, uint32_t columns, uint32_t rows, std::optional<TileIndexFormat> indexFormat = {} );
+
+    /// <summary>
+    /// Get the smallest index format that can reference the given number of sprites.
+    /// </summary>
+    /// <param name="numSprites">The number of sprites in the sprite sheet.</param>
+    /// <returns>The smallest index format that can store every sprite index and the empty (-1) tile.</returns>
+    static constexpr TileIndexFormat getIndexFormat( size_t numSprites ) noexcept
+    {
+        if ( numSprites <= UINT8_MAX )
+            return TileIndexFormat::UInt8;
+        if ( numSprites <= UINT16_MAX )
+            return TileIndexFormat::UInt16;
+
+        return TileIndexFormat::UInt32;
+    }
 
     /// <summary>
     /// Accesses a tile in the tile map by its coordinates (read-only).
@@ -39,8 +125,8 @@ public:
     /// </summary>
     /// <param name="x">The x-coordinate (column) of the tile.</param>
     /// <param name="y">The y-coordinate (row) of the tile.</param>
-    /// <returns>A reference to the sprite index at the specified coordinates.</returns>
-    int& operator[]( size_t x, size_t y ) noexcept;
+    /// <returns>A proxy reference to the sprite index at the specified coordinates.</returns>
+    TileRef operator[]( size_t x, size_t y ) noexcept;
 
     /// <summary>
     /// Clears all tiles in the tile map.
@@ -81,14 +167,29 @@ public:
     std::shared_ptr<Image> getImage() const noexcept;
 
     /// <summary>
-    /// Gets the grid of sprite indices.
+    /// Gets the storage format of the cells in the tile map.
     /// </summary>
-    /// <returns>A constant reference to the vector of sprite indices.</returns>
-    const std::vector<int>& getSpriteGrid() const noexcept
+    /// <returns>The storage format of the cells.</returns>
+    TileIndexFormat getIndexFormat() const noexcept
     {
-        return m_SpriteGrid;
+        return m_IndexFormat;
     }
 
+    /// <summary>
+    /// Gets the grid of sprite indices.
+    /// Note: The cells are stored in a packed format, so they are decoded into a new vector (this allocates).
+    /// Use <see cref="copySpriteGrid"/> to decode into an existing buffer, or <see cref="getSpriteId"/> to access individual cells.
+    /// </summary>
+    /// <returns>A vector containing the sprite index of every cell in row-major order.</returns>
+    std::vector<int> getSpriteGrid() const;
+
+    /// <summary>
+    /// Decode the grid of sprite indices into an existing buffer, without allocating.
+    /// The span must contain exactly columns * rows elements.
+    /// </summary>
+    /// <param name="spriteGrid">The buffer that receives the sprite index of every cell in row-major order.</param>
+    void copySpriteGrid( std::span<int> spriteGrid ) const noexcept;
+
     const BlendMode& getBlendMode() const noexcept;
 
     /// <summary>
@@ -97,7 +198,44 @@ public:
     /// <param name="x">The horizontal coordinate (column).</param>
     /// <param name="y">The vertical coordinate (row).</param>
     /// <returns>The ID of the sprite located at the given (x, y) coordinates.</returns>
-    int getSpriteId( size_t x, size_t y ) const;
+    int getSpriteId( size_t x, size_t y ) const noexcept;
+
+    /// <summary>
+    /// Call a function with the sprite ID of every cell in a range of columns of a row.
+    /// The storage format is only dispatched once per call instead of once per cell (like <see cref="getSpriteId"/>).
+    /// </summary>
+    /// <param name="y">The row.</param>
+    /// <param name="firstColumn">The first column of the range.</param>
+    /// <param name="lastColumn">The last column of the range (inclusive).</param>
+    /// <param name="func">The function to call for every cell: void( size_t x, int spriteId ).</param>
+    template<typename Func>
+    void forEachInRow( size_t y, size_t firstColumn, size_t lastColumn, Func&& func ) const
+    {
+        assert( y < m_Rows );
+        assert( firstColumn <= lastColumn && lastColumn < m_Columns );
+
+        switch ( m_IndexFormat )
+        {
+        case TileIndexFormat::UInt8:
+            forEachCellInRow<uint8_t>( y, firstColumn, lastColumn, func );
+            break;
+        case TileIndexFormat::UInt16:
+            forEachCellInRow<uint16_t>( y, firstColumn, lastColumn, func );
+            break;
+        case TileIndexFormat::UInt32:
+            forEachCellInRow<uint32_t>( y, firstColumn, lastColumn, func );
+            break;
+        }
+    }
+
+    /// <summary>
+    /// Sets the sprite ID at the specified coordinates.
+    /// </summary>
+    /// <param name="x">The horizontal coordinate (column).</param>
+    /// <param name="y">The vertical coordinate (row).</param>
+    /// <param name="spriteId">The sprite index to store in the cell (-1 or any other negative index for an empty cell).
+    /// If the index doesn't fit in the storage format of the cells, every cell is converted to a larger format.</param>
+    void setSpriteId( size_t x, size_t y, int spriteId );
 
     /// <summary>
     /// Gets the sprite at the specified coordinates.
@@ -109,6 +247,8 @@ public:
 
     /// <summary>
     /// Sets the entire sprite grid using a span of integers.
+    /// The span must contain exactly columns * rows sprite indices in row-major order.
+    /// Negative indices are stored as empty cells, and the storage format is widened if an index doesn't fit in it.
     /// </summary>
     /// <param name="spriteGrid">A span containing the sprite indices to use for the grid.</param>
     void setSpriteGrid( std::span<const int> spriteGrid );
@@ -146,11 +286,29 @@ public:
     }
 
 private:
-    uint32_t m_Columns = 0u;
-    uint32_t m_Rows    = 0u;
+    // Convert the cells to a larger storage format if the sprite index doesn't fit in the current format.
+    void reserveSpriteId( int spriteId );
+
+    template<typename T, typename Func>
+    void forEachCellInRow( size_t y, size_t firstColumn, size_t lastColumn, Func& func ) const
+    {
+        const uint8_t* cells = m_SpriteGrid.data() + y * m_Columns * sizeof( T );
+
+        for ( size_t x = firstColumn; x <= lastColumn; ++x )
+        {
+            T cell;
+            std::memcpy( &cell, cells + x * sizeof( T ), sizeof( T ) );
+            func( x, static_cast<int>( cell ) - 1 );
+        }
+    }
+
+    // Cells store the sprite index + 1 so that the empty tile (-1) is encoded as 0 in every format.
+    uint32_t        m_Columns     = 0u;
+    uint32_t        m_Rows        = 0u;
+    TileIndexFormat m_IndexFormat = TileIndexFormat::UInt8;
 
     std::shared_ptr<SpriteSheet> m_SpriteSheet;
-    std::vector<int>             m_SpriteGrid;
+    std::vector<uint8_t>         m_SpriteGrid;  // Packed cells. The size of a cell is determined by m_IndexFormat.
 };
 }  // namespace graphics
 }  // namespace cpprast
\ No newline at end of file
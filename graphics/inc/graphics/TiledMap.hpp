@@ -0,0 +1,133 @@
+#pragma once
+
+#include "TileMap.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// A single tile layer of a Tiled map.
+/// </summary>
+struct TiledLayer
+{
+    std::string name;            ///< The name of the layer in the Tiled editor.
+    TileMap     tileMap;         ///< The tiles of the layer.
+    bool        visible = true;  ///< Whether the layer is visible.
+    float       opacity = 1.0f;  ///< The opacity of the layer in the range [0 ... 1].
+};
+
+/// <summary>
+/// A map created with the Tiled map editor (https://www.mapeditor.org).
+/// Both the TMX (XML) and JSON map formats are supported, with external (TSX/JSON) or embedded tilesets.
+/// Layer data may be encoded as CSV, XML, or base64 (uncompressed, zlib, or gzip compressed).
+///
+/// The files are read into memory as a whole and then parsed in a single pass without building a document tree.
+/// The (potentially large) layer payloads are only located during parsing and are decoded on worker threads afterwards.
+///
+/// All tilesets of the map are merged into a single sprite sheet (in the order of their first global tile ID)
+/// which is shared by the tile maps of every layer. Tilesets whose tile size differs from the tile size of the map
+/// are skipped (with an error), and their tiles are left empty.
+/// Note: Infinite maps, image collection tilesets, and tile flipping are not supported. Flip flags are ignored.
+/// </summary>
+class TiledMap
+{
+public:
+    /// <summary>
+    /// Default constructor. Creates an empty map.
+    /// </summary>
+    TiledMap() = default;
+
+    /// <summary>
+    /// Load a Tiled map from a file.
+    /// The file format is determined by the file extension: `.json` and `.tmj` files are parsed as JSON, any other file as TMX.
+    /// </summary>
+    /// <param name="filePath">The path to the map file to load.</param>
+    /// <param name="blendMode">(Optional) The blend mode to apply to the sprites of the map. Default: No blending.</param>
+    explicit TiledMap( const std::filesystem::path& filePath, const BlendMode& blendMode = BlendMode {} );
+
+    /// <summary>
+    /// Gets the number of columns in the map.
+    /// </summary>
+    /// <returns>The number of columns in the map.</returns>
+    uint32_t getColumns() const noexcept
+    {
+        return m_Columns;
+    }
+
+    /// <summary>
+    /// Gets the number of rows in the map.
+    /// </summary>
+    /// <returns>The number of rows in the map.</returns>
+    uint32_t getRows() const noexcept
+    {
+        return m_Rows;
+    }
+
+    /// <summary>
+    /// Gets the width of a tile in the map grid.
+    /// </summary>
+    /// <returns>The width of a tile (in pixels).</returns>
+    uint32_t getTileWidth() const noexcept
+    {
+        return m_TileWidth;
+    }
+
+    /// <summary>
+    /// Gets the height of a tile in the map grid.
+    /// </summary>
+    /// <returns>The height of a tile (in pixels).</returns>
+    uint32_t getTileHeight() const noexcept
+    {
+        return m_TileHeight;
+    }
+
+    /// <summary>
+    /// Gets the sprite sheet containing the tiles of all tilesets of the map.
+    /// </summary>
+    /// <returns>A shared pointer to the sprite sheet.</returns>
+    std::shared_ptr<SpriteSheet> getSpriteSheet() const noexcept
+    {
+        return m_SpriteSheet;
+    }
+
+    /// <summary>
+    /// Gets the tile layers of the map (in drawing order).
+    /// </summary>
+    /// <returns>The tile layers of the map.</returns>
+    const std::vector<TiledLayer>& getLayers() const noexcept
+    {
+        return m_Layers;
+    }
+
+    /// <summary>
+    /// Find a layer by name.
+    /// </summary>
+    /// <param name="name">The name of the layer to find.</param>
+    /// <returns>A pointer to the first layer with the given name, or nullptr if no such layer exists.</returns>
+    const TiledLayer* findLayer( std::string_view name ) const noexcept;
+
+    /// <summary>
+    /// Check if the map was loaded successfully.
+    /// </summary>
+    explicit operator bool() const noexcept
+    {
+        return m_SpriteSheet != nullptr;
+    }
+
+private:
+    uint32_t m_Columns    = 0u;
+    uint32_t m_Rows       = 0u;
+    uint32_t m_TileWidth  = 0u;
+    uint32_t m_TileHeight = 0u;
+
+    std::shared_ptr<SpriteSheet> m_SpriteSheet;
+    std::vector<TiledLayer>      m_Layers;
+};
+}  // namespace graphics
+}  // namespace cpprast
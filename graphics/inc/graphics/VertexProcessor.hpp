@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Color.hpp"
+
+#include <math/Simd.hpp>
+#include <math/Viewport.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace graphics
+{
+/// <summary>
+/// The positions of a vertex stream, stored as a structure of arrays.
+/// All streams must have the same size.
+/// </summary>
+struct VertexPositions
+{
+    std::span<const float> x;
+    std::span<const float> y;
+    std::span<const float> z;
+
+    size_t size() const noexcept
+    {
+        return x.size();
+    }
+};
+
+/// <summary>
+/// The attributes of a vertex stream that are interpolated across triangles, stored as a structure of arrays.
+/// The streams are indexed like the vertex positions. Empty streams are not interpolated:
+/// the texture coordinates default to (0, 0) and the colors default to white.
+/// </summary>
+struct VertexAttributes
+{
+    std::span<const float> u;
+    std::span<const float> v;
+    std::span<const Color> color;
+};
+
+/// <summary>
+/// The vertex processing stage: transforms vertex positions to clip space, performs the perspective divide,
+/// and maps the result to the viewport.
+///
+/// Vertices are transformed in batches of 8 (AVX) or 4 (SSE) using a structure of arrays, so every instruction processes
+/// the same component of several vertices and no shuffling is needed.
+///
+/// The results are kept in a post-transform cache: a vertex that is referenced by several triangles of an indexed draw is
+/// transformed only once. The cache is invalidated when the transform, the viewport, or the vertex stream changes.
+///
+/// The projection matrix is expected to map the depth range to [0, w] (Direct3D convention, for example glm::perspectiveRH_ZO).
+/// </summary>
+class VertexProcessor
+{
+public:
+    /// <summary>
+    /// The number of vertices that are transformed per instruction.
+    /// </summary>
+    static constexpr size_t SimdWidth = CPPRAST_SIMD_WIDTH;
+
+    /// <summary>
+    /// Set the transform and the viewport. This invalidates the post-transform cache.
+    /// </summary>
+    /// <param name="transform">The matrix that transforms the vertex positions to clip space (usually projection * view * model).</param>
+    /// <param name="viewport">The viewport that normalized device coordinates are mapped to.</param>
+    void setTransform( const glm::mat4& transform, const Viewport& viewport ) noexcept;
+
+    /// <summary>
+    /// Transform every vertex of a vertex stream.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    void transform( const VertexPositions& positions );
+
+    /// <summary>
+    /// Transform the vertices that are referenced by an index buffer.
+    /// Only the vertices that are not in the post-transform cache are transformed, each of them once.
+    /// </summary>
+    /// <param name="positions">The vertex positions.</param>
+    /// <param name="indices">The indices of the vertices to transform.</param>
+    void transform( const VertexPositions& positions, std::span<const uint32_t> indices );
+
+    /// <summary>
+    /// Invalidate the post-transform cache, for example if the contents of the vertex stream were modified.
+    /// </summary>
+    void invalidate() noexcept;
+
+    /// <summary>
+    /// Check if a vertex is in the post-transform cache.
+    /// </summary>
+    bool isTransformed( uint32_t index ) const noexcept
+    {
+        return index < m_Stamps.size() && m_Stamps[index] == m_Generation;
+    }
+
+    /// <summary>
+    /// Get the clip-space position of a transformed vertex.
+    /// </summary>
+    glm::vec4 getClipPosition( uint32_t index ) const noexcept
+    {
+        assert( isTransformed( index ) );
+        return { m_ClipX[index], m_ClipY[index], m_ClipZ[index], m_ClipW[index] };
+    }
+
+    /// <summary>
+    /// Get the screen-space position of a transformed vertex.
+    /// </summary>
+    /// <returns>The position on the viewport (x, y), the depth (z), and 1/w (used for perspective-correct interpolation).</returns>
+    glm::vec4 getScreenPosition( uint32_t index ) const noexcept
+    {
+        assert( isTransformed( index ) );
+        return { m_ScreenX[index], m_ScreenY[index], m_ScreenZ[index], m_InvW[index] };
+    }
+
+    /// <summary>
+    /// Project a clip-space position to the viewport, the same way the vertices are projected.
+    /// Used for the vertices that are created by clipping.
+    /// </summary>
+    /// <param name="clipPosition">The clip-space position.</param>
+    /// <returns>The position on the viewport (x, y), the depth (z), and 1/w.</returns>
+    glm::vec4 project( const glm::vec4& clipPosition ) const noexcept;
+
+    /// <summary>
+    /// Get the viewport that the vertices are mapped to.
+    /// </summary>
+    const Viewport& getViewport() const noexcept
+    {
+        return m_Viewport;
+    }
+
+    /// <summary>
+    /// Get the number of vertices that were transformed by the last call to transform (the number of cache misses).
+    /// </summary>
+    size_t getNumTransformed() const noexcept
+    {
+        return m_NumTransformed;
+    }
+
+private:
+    // Resize the outputs for a vertex stream, and invalidate the cache if the stream changed.
+    void bind( const VertexPositions& positions );
+
+    glm::mat4 m_Transform { 1.0f };
+    Viewport  m_Viewport;
+
+    // The vertex stream the cache refers to.
+    const float* m_BoundX    = nullptr;
+    size_t       m_BoundSize = 0;
+
+    // The transformed vertices (structure of arrays).
+    std::vector<float> m_ClipX;
+    std::vector<float> m_ClipY;
+    std::vector<float> m_ClipZ;
+    std::vector<float> m_ClipW;
+    std::vector<float> m_ScreenX;
+    std::vector<float> m_ScreenY;
+    std::vector<float> m_ScreenZ;
+    std::vector<float> m_InvW;
+
+    // A vertex is in the cache if its stamp matches the current generation.
+    std::vector<uint32_t> m_Stamps;
+    uint32_t              m_Generation = 1u;
+
+    // The cache misses of an indexed transform, gathered into contiguous arrays.
+    std::vector<uint32_t> m_Misses;
+    std::vector<float>    m_Scratch;
+
+    size_t m_NumTransformed = 0;
+};
+}  // namespace graphics
+}  // namespace cpprast
@@ -0,0 +1,166 @@
+#include <aligned_unique_ptr.hpp>
+#include <graphics/AllocationTracker.hpp>
+
+#include <algorithm>  // For std::max
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdio>   // For std::fprintf
+#include <cstdlib>  // For std::malloc, std::free
+#include <new>
+
+using namespace cpprast::graphics;
+
+namespace
+{
+constexpr size_t NumSubsystems = static_cast<size_t>( AllocationTracker::Subsystem::Count );
+
+std::array<std::atomic<uint64_t>, NumSubsystems> g_Allocations {};
+std::array<std::atomic<uint64_t>, NumSubsystems> g_Bytes {};
+std::atomic<uint64_t>                            g_HotAllocations { 0u };
+std::atomic<AllocationTracker::HotScopeMode>     g_HotScopeMode { AllocationTracker::HotScopeMode::Assert };
+
+thread_local AllocationTracker::Subsystem t_Subsystem = AllocationTracker::Subsystem::Other;
+thread_local const char*                  t_HotScope  = nullptr;  // The name of the innermost hot scope, or null outside of hot scopes.
+#if CPPRAST_TRACK_ALLOCATIONS
+thread_local bool t_Reporting = false;  // Prevents recursion if reporting an allocation allocates.
+#endif
+}  // namespace
+
+AllocationTracker::SubsystemScope::SubsystemScope( Subsystem subsystem ) noexcept
+: m_Previous { t_Subsystem }
+{
+    t_Subsystem = subsystem;
+}
+
+AllocationTracker::SubsystemScope::~SubsystemScope()
+{
+    t_Subsystem = m_Previous;
+}
+
+AllocationTracker::HotScope::HotScope( const char* name ) noexcept
+: m_Previous { t_HotScope }
+{
+    t_HotScope = name;
+}
+
+AllocationTracker::HotScope::~HotScope()
+{
+    t_HotScope = m_Previous;
+}
+
+void AllocationTracker::beginFrame() noexcept
+{
+    for ( size_t i = 0; i < NumSubsystems; ++i )
+    {
+        g_Allocations[i].store( 0u, std::memory_order_relaxed );
+        g_Bytes[i].store( 0u, std::memory_order_relaxed );
+    }
+
+    g_HotAllocations.store( 0u, std::memory_order_relaxed );
+}
+
+AllocationTracker::Stats AllocationTracker::getFrameStats( Subsystem subsystem ) noexcept
+{
+    const auto i = static_cast<size_t>( subsystem );
+    assert( i < NumSubsystems );
+
+    return { g_Allocations[i].load( std::memory_order_relaxed ), g_Bytes[i].load( std::memory_order_relaxed ) };
+}
+
+AllocationTracker::Stats AllocationTracker::getFrameStats() noexcept
+{
+    Stats stats;
+    for ( size_t i = 0; i < NumSubsystems; ++i )
+    {
+        stats.allocations += g_Allocations[i].load( std::memory_order_relaxed );
+        stats.bytes += g_Bytes[i].load( std::memory_order_relaxed );
+    }
+
+    return stats;
+}
+
+uint64_t AllocationTracker::getHotAllocations() noexcept
+{
+    return g_HotAllocations.load( std::memory_order_relaxed );
+}
+
+void AllocationTracker::setHotScopeMode( HotScopeMode mode ) noexcept
+{
+    g_HotScopeMode.store( mode, std::memory_order_relaxed );
+}
+
+void AllocationTracker::recordAllocation( size_t bytes ) noexcept
+{
+#if CPPRAST_TRACK_ALLOCATIONS
+    const auto i = static_cast<size_t>( t_Subsystem );
+    g_Allocations[i].fetch_add( 1u, std::memory_order_relaxed );
+    g_Bytes[i].fetch_add( bytes, std::memory_order_relaxed );
+
+    if ( !t_HotScope || t_Reporting )
+        return;
+
+    g_HotAllocations.fetch_add( 1u, std::memory_order_relaxed );
+
+    const HotScopeMode mode = g_HotScopeMode.load( std::memory_order_relaxed );
+    if ( mode == HotScopeMode::Ignore )
+        return;
+
+    t_Reporting = true;
+    std::fprintf( stderr, "WARNING: Allocation of %zu bytes in hot scope \"%s\".\n", bytes, t_HotScope );
+    t_Reporting = false;
+
+    assert( mode != HotScopeMode::Assert && "Memory was allocated in a hot scope." );
+#else
+    (void)bytes;
+#endif
+}
+
+#if CPPRAST_TRACK_ALLOCATIONS
+
+// Replace the global allocation functions to count all allocations.
+// The array and non-throwing versions call these functions.
+
+void* operator new( std::size_t size )
+{
+    AllocationTracker::recordAllocation( size );
+
+    if ( void* p = std::malloc( size ? size : 1 ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new( std::size_t size, std::align_val_t alignment )
+{
+    AllocationTracker::recordAllocation( size );
+
+    // The size of an aligned allocation must be a multiple of the alignment.
+    const auto align = static_cast<std::size_t>( alignment );
+    if ( void* p = aligned_malloc( ( std::max<std::size_t>( size, 1 ) + align - 1 ) / align * align, align ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+    std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+    std::free( p );
+}
+
+void operator delete( void* p, std::align_val_t ) noexcept
+{
+    aligned_free( p );
+}
+
+void operator delete( void* p, std::size_t, std::align_val_t ) noexcept
+{
+    aligned_free( p );
+}
+
+#endif
@@ -5,6 +5,8 @@ using namespace cpprast::graphics;
 const BlendMode BlendMode::Disable { false };
 const BlendMode BlendMode::AlphaDiscard { true, 127 };
 const BlendMode BlendMode::AlphaBlend { true, 0, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha };
+const BlendMode BlendMode::AlphaBlendLayer { true, 0, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha, BlendOperation::Add, BlendFactor::One, BlendFactor::OneMinusSrcAlpha };
+const BlendMode BlendMode::PremultipliedAlphaBlend { true, 0, BlendFactor::One, BlendFactor::OneMinusSrcAlpha, BlendOperation::Add, BlendFactor::One, BlendFactor::OneMinusSrcAlpha };
 const BlendMode BlendMode::AdditiveBlend { true, 0, BlendFactor::One, BlendFactor::One };
 const BlendMode BlendMode::SubtractiveBlend { true, 0, BlendFactor::One, BlendFactor::One, BlendOperation::Subtract };
 const BlendMode BlendMode::MultiplicativeBlend { true, 0, BlendFactor::Zero, BlendFactor::SrcColor };
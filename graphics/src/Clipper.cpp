@@ -0,0 +1,93 @@
+#include <graphics/Clipper.hpp>
+
+#include <algorithm>  // For std::max
+#include <array>
+
+using namespace cpprast::graphics;
+using namespace cpprast::math;
+
+namespace
+{
+// The signed distance of a clip-space position to a clip plane (positive inside).
+float getDistance( const glm::vec4& p, uint32_t plane, float guardX, float guardY ) noexcept
+{
+    switch ( plane )
+    {
+    case Clipper::Near:
+        return p.z;
+    case Clipper::GuardLeft:
+        return p.x + guardX * p.w;
+    case Clipper::GuardRight:
+        return guardX * p.w - p.x;
+    case Clipper::GuardBottom:
+        return p.y + guardY * p.w;
+    case Clipper::GuardTop:
+        return guardY * p.w - p.y;
+    default:
+        return 0.0f;
+    }
+}
+
+ClipVertex lerp( const ClipVertex& a, const ClipVertex& b, float t ) noexcept
+{
+    return { a.position + ( b.position - a.position ) * t, a.barycentric + ( b.barycentric - a.barycentric ) * t };
+}
+}  // namespace
+
+Clipper::Clipper( const Viewport& viewport, float guardBand ) noexcept
+{
+    // The guard band extends the viewport by guardBand pixels on each side: [-1, 1] grows to [-(1 + 2 * guardBand / size), ...].
+    m_GuardX = 1.0f + 2.0f * guardBand / std::max( viewport.width, 1.0f );
+    m_GuardY = 1.0f + 2.0f * guardBand / std::max( viewport.height, 1.0f );
+}
+
+size_t Clipper::clip( const glm::vec4& p0, const glm::vec4& p1, const glm::vec4& p2, std::span<ClipVertex, MaxVertices> polygon ) const noexcept
+{
+    const uint32_t planes = ( getClipCode( p0 ) | getClipCode( p1 ) | getClipCode( p2 ) ) & ClipPlanes;
+
+    std::array<ClipVertex, MaxVertices> scratch;
+
+    // Clip back and forth between the output polygon and the scratch polygon.
+    ClipVertex* in  = polygon.data();
+    ClipVertex* out = scratch.data();
+    size_t      n   = 3;
+
+    in[0] = { p0, { 1.0f, 0.0f, 0.0f } };
+    in[1] = { p1, { 0.0f, 1.0f, 0.0f } };
+    in[2] = { p2, { 0.0f, 0.0f, 1.0f } };
+
+    // Clip against the near plane first, so the vertices that are clipped against the guard band have a positive w.
+    for ( uint32_t plane: { Near, GuardLeft, GuardRight, GuardBottom, GuardTop } )
+    {
+        if ( ( planes & plane ) == 0u )
+            continue;
+
+        size_t m = 0;
+        for ( size_t i = 0; i < n; ++i )
+        {
+            const ClipVertex& a  = in[i];
+            const ClipVertex& b  = in[( i + 1 ) % n];
+            const float       da = getDistance( a.position, plane, m_GuardX, m_GuardY );
+            const float       db = getDistance( b.position, plane, m_GuardX, m_GuardY );
+
+            if ( da >= 0.0f )
+                out[m++] = a;
+
+            // Always interpolate from the inside vertex to the outside vertex, so an edge that is shared by two triangles
+            // is split at exactly the same point.
+            if ( ( da >= 0.0f ) != ( db >= 0.0f ) )
+                out[m++] = da >= 0.0f ? lerp( a, b, da / ( da - db ) ) : lerp( b, a, db / ( db - da ) );
+        }
+
+        std::swap( in, out );
+        n = m;
+
+        if ( n < 3 )
+            return 0;
+    }
+
+    if ( in != polygon.data() )
+        std::copy_n( in, n, polygon.data() );
+
+    return n;
+}
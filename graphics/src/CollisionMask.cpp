@@ -0,0 +1,82 @@
+#include <graphics/CollisionMask.hpp>
+
+#include <algorithm>
+
+using namespace cpprast::graphics;
+using namespace cpprast::math;
+
+namespace
+{
+/// <summary>
+/// Get 64 consecutive bits of a row, starting at any (possibly negative) bit.
+/// Bits outside of the row are 0.
+/// </summary>
+uint64_t loadBits( const uint64_t* row, int numWords, int firstBit ) noexcept
+{
+    const int word  = firstBit >> 6;  // Arithmetic shift: rounds towards negative infinity.
+    const int shift = firstBit & 63;
+
+    const uint64_t lo = word >= 0 && word < numWords ? row[word] : 0;
+    const uint64_t hi = word + 1 >= 0 && word + 1 < numWords ? row[word + 1] : 0;
+
+    return shift == 0 ? lo : ( lo >> shift ) | ( hi << ( 64 - shift ) );
+}
+}  // namespace
+
+CollisionMask::CollisionMask( const Image& image, const RectI& rect, uint8_t alphaThreshold )
+: m_Bits { static_cast<uint32_t>( std::max( rect.width, 0 ) ), static_cast<uint32_t>( std::max( rect.height, 0 ) ) }
+{
+    // Only the part of the region that is inside the image can be solid.
+    const int x0 = std::max( rect.left, 0 );
+    const int y0 = std::max( rect.top, 0 );
+    const int x1 = std::min( rect.left + rect.width, static_cast<int>( image.getWidth() ) );
+    const int y1 = std::min( rect.top + rect.height, static_cast<int>( image.getHeight() ) );
+
+    for ( int y = y0; y < y1; ++y )
+    {
+        for ( int x = x0; x < x1; ++x )
+        {
+            if ( image( x, y ).channels.a >= alphaThreshold )
+                m_Bits.set( static_cast<uint32_t>( x - rect.left ), static_cast<uint32_t>( y - rect.top ), true );
+        }
+    }
+}
+
+CollisionMask::CollisionMask( const Sprite& sprite, uint8_t alphaThreshold )
+{
+    if ( auto image = sprite.getImage() )
+        *this = CollisionMask { *image, sprite.getRect(), alphaThreshold };
+}
+
+bool CollisionMask::overlaps( const CollisionMask& a, const glm::ivec2& positionA, const CollisionMask& b, const glm::ivec2& positionB ) noexcept
+{
+    // Intersect the bounds of the masks first.
+    const int x0 = std::max( positionA.x, positionB.x );
+    const int y0 = std::max( positionA.y, positionB.y );
+    const int x1 = std::min( positionA.x + static_cast<int>( a.getWidth() ), positionB.x + static_cast<int>( b.getWidth() ) );
+    const int y1 = std::min( positionA.y + static_cast<int>( a.getHeight() ), positionB.y + static_cast<int>( b.getHeight() ) );
+
+    if ( x0 >= x1 || y0 >= y1 )
+        return false;
+
+    // The columns of the overlap in the first mask, and the offset from a column in the first mask to the same column in the second mask.
+    const int firstWord = ( x0 - positionA.x ) >> 6;
+    const int lastWord  = ( x1 - 1 - positionA.x ) >> 6;
+    const int offset    = positionA.x - positionB.x;
+    const int numWordsB = static_cast<int>( b.m_Bits.getWordsPerRow() );
+
+    for ( int y = y0; y < y1; ++y )
+    {
+        const uint64_t* rowA = a.m_Bits.row( static_cast<uint32_t>( y - positionA.y ) );
+        const uint64_t* rowB = b.m_Bits.row( static_cast<uint32_t>( y - positionB.y ) );
+
+        // The bits outside of the overlap don't need to be masked: the padding bits of both masks are always 0.
+        for ( int w = firstWord; w <= lastWord; ++w )
+        {
+            if ( rowA[w] & loadBits( rowB, numWordsB, w * 64 + offset ) )
+                return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,105 @@
+#include <graphics/Compositor.hpp>
+
+#include <algorithm>  // For std::clamp, std::fill_n
+#include <cmath>      // For std::lround
+#include <cstring>    // For std::memcpy
+#include <utility>    // For std::move
+
+using namespace cpprast::graphics;
+
+size_t Compositor::addLayer( DrawFunc draw, const BlendMode& blendMode, float opacity )
+{
+    Layer& layer      = m_Layers.emplace_back();
+    layer.m_Draw      = std::move( draw );
+    layer.m_BlendMode = blendMode;
+    layer.m_Opacity   = opacity;
+
+    return m_Layers.size() - 1;
+}
+
+void Compositor::composite( Image& target, const Color& clearColor )
+{
+    if ( !target )
+        return;
+
+    const int width  = target.getWidth();
+    const int height = target.getHeight();
+
+    // Re-render the layers that changed.
+    for ( Layer& layer: m_Layers )
+    {
+        if ( !layer.m_Visible )
+            continue;
+
+        const bool resized = !layer.m_Image || layer.m_Image.getWidth() != width || layer.m_Image.getHeight() != height;
+        if ( resized )
+            layer.m_Image.resize( width, height, ImageLayout::Padded );
+
+        if ( resized || layer.m_Dirty || layer.m_Version != layer.m_RenderedVersion )
+        {
+            layer.m_Image.clear( Color { 0, 0, 0, 0 } );
+
+            m_Rasterizer.state             = Rasterizer::State {};
+            m_Rasterizer.state.colorTarget = &layer.m_Image;
+
+            if ( layer.m_Draw )
+                layer.m_Draw( m_Rasterizer );
+
+            layer.m_Dirty           = false;
+            layer.m_RenderedVersion = layer.m_Version;
+        }
+    }
+
+    // Layers behind an opaque layer (no blending and full opacity) are completely covered, so compositing starts at the last opaque layer.
+    size_t first  = 0;
+    bool   opaque = false;
+    for ( size_t i = 0; i < m_Layers.size(); ++i )
+    {
+        const Layer& layer = m_Layers[i];
+        if ( layer.m_Visible && !layer.m_BlendMode.blendEnable && layer.m_Opacity >= 1.0f )
+        {
+            first  = i;
+            opaque = true;
+        }
+    }
+
+    Color* dst = target.data();
+
+    for ( int y = 0; y < height; ++y )
+    {
+        Color* dstRow = dst + static_cast<size_t>( y ) * target.getStride();
+
+        // Composite the row from all layers while it is in the cache.
+        if ( opaque )
+        {
+            const Image& image = m_Layers[first].m_Image;
+            std::memcpy( dstRow, image.data() + static_cast<size_t>( y ) * image.getStride(), width * sizeof( Color ) );
+        }
+        else
+            std::fill_n( dstRow, width, clearColor );
+
+        for ( size_t i = opaque ? first + 1 : 0; i < m_Layers.size(); ++i )
+        {
+            const Layer& layer = m_Layers[i];
+            if ( !layer.m_Visible || layer.m_Opacity <= 0.0f )
+                continue;
+
+            const Color*     srcRow    = layer.m_Image.data() + static_cast<size_t>( y ) * layer.m_Image.getStride();
+            const BlendMode& blendMode = layer.m_BlendMode;
+
+            if ( layer.m_Opacity >= 1.0f )
+            {
+                for ( int x = 0; x < width; ++x )
+                    dstRow[x] = blendMode.Blend( srcRow[x], dstRow[x] );
+            }
+            else
+            {
+                const auto  alpha = static_cast<uint8_t>( std::lround( std::clamp( layer.m_Opacity, 0.0f, 1.0f ) * 255.0f ) );
+                const Color opacity { alpha, alpha, alpha, alpha };
+
+                for ( int x = 0; x < width; ++x )
+                    dstRow[x] = blendMode.Blend( srcRow[x] * opacity, dstRow[x] );
+            }
+        }
+    }
+}
@@ -0,0 +1,80 @@
+#include <graphics/CompressedTileMap.hpp>
+
+#include <algorithm>  // for std::ranges::upper_bound
+#include <cassert>
+#include <cstdint>
+
+using namespace cpprast::graphics;
+
+CompressedTileMap::CompressedTileMap( const TileMap& tileMap )
+: m_Columns { tileMap.getColumns() }
+, m_Rows { tileMap.getRows() }
+, m_SpriteSheet { tileMap.getSpriteSheet() }
+{
+    m_RowOffsets.reserve( static_cast<size_t>( m_Rows ) + 1 );
+
+    for ( uint32_t y = 0; y < m_Rows; ++y )
+    {
+        m_RowOffsets.push_back( static_cast<uint32_t>( m_Runs.size() ) );
+
+        uint32_t x = 0;
+        while ( x < m_Columns )
+        {
+            const int spriteId = tileMap.getSpriteId( x, y );
+            uint32_t  end      = x + 1;
+
+            while ( end < m_Columns && tileMap.getSpriteId( end, y ) == spriteId )
+                ++end;
+
+            m_Runs.push_back( { x, end - x, spriteId } );
+            x = end;
+        }
+    }
+
+    m_RowOffsets.push_back( static_cast<uint32_t>( m_Runs.size() ) );
+    m_Runs.shrink_to_fit();
+}
+
+int CompressedTileMap::operator[]( size_t x, size_t y ) const noexcept
+{
+    if ( x >= m_Columns || y >= m_Rows )
+        return -1;
+
+    const auto row = getRow( y );
+    // Find the first run that starts after x. The run before it contains x.
+    const auto run = std::ranges::upper_bound( row, x, {}, &TileRun::column );
+
+    return std::prev( run )->spriteId;
+}
+
+TileMap CompressedTileMap::decompress() const
+{
+    TileMap tileMap { m_SpriteSheet, m_Columns, m_Rows };
+
+    for ( uint32_t y = 0; y < m_Rows; ++y )
+    {
+        for ( const TileRun& run: getRow( y ) )
+        {
+            for ( uint32_t x = run.column; x < run.column + run.length; ++x )
+                tileMap.setSpriteId( x, y, run.spriteId );
+        }
+    }
+
+    return tileMap;
+}
+
+uint32_t CompressedTileMap::getSpriteWidth() const noexcept
+{
+    if ( m_SpriteSheet )
+        return m_SpriteSheet->getSpriteWidth();
+
+    return 0u;
+}
+
+uint32_t CompressedTileMap::getSpriteHeight() const noexcept
+{
+    if ( m_SpriteSheet )
+        return m_SpriteSheet->getSpriteHeight();
+
+    return 0u;
+}
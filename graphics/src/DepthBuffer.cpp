@@ -0,0 +1,37 @@
+#include <graphics/AllocationTracker.hpp>
+#include <graphics/DepthBuffer.hpp>
+
+#include <algorithm>  // For std::fill_n
+#include <climits>    // For INT_MAX
+
+using namespace cpprast::graphics;
+
+DepthBuffer::DepthBuffer( uint32_t width, uint32_t height, float depth )
+{
+    resize( width, height );
+    clear( depth );
+}
+
+void DepthBuffer::resize( uint32_t width, uint32_t height )
+{
+    assert( width < INT_MAX );
+    assert( height < INT_MAX );
+
+    if ( m_Depth && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) )
+        return;
+
+    const size_t size = static_cast<size_t>( width ) * height;
+
+    // The depth values bypass the global operator new, so they are recorded explicitly.
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Image };
+    AllocationTracker::recordAllocation( size * sizeof( float ) );
+
+    m_Width  = static_cast<int>( width );
+    m_Height = static_cast<int>( height );
+    m_Depth  = make_aligned_unique<float[], 64, huge_page_alloc_policy<>>( size );
+}
+
+void DepthBuffer::clear( float depth ) noexcept
+{
+    std::fill_n( m_Depth.get(), static_cast<size_t>( m_Width ) * m_Height, depth );
+}
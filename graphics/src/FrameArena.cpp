@@ -0,0 +1,121 @@
+#include <graphics/FrameArena.hpp>
+
+#include <algorithm>  // For std::max
+#include <cassert>
+#include <cstdint>    // For std::uintptr_t
+
+using namespace cpprast::graphics;
+
+FrameArena::FrameArena( size_t blockSize, std::pmr::memory_resource* upstream ) noexcept
+: m_Upstream { upstream }
+, m_BlockSize { blockSize }
+{
+    assert( upstream != nullptr );
+}
+
+FrameArena::~FrameArena()
+{
+    for ( const Block& block: m_Blocks )
+        m_Upstream->deallocate( block.data, block.size, alignof( std::max_align_t ) );
+}
+
+FrameArena& FrameArena::getThreadArena()
+{
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void FrameArena::reset()
+{
+    // Merge the blocks into a single block, so the next frame fits without switching (or adding) blocks.
+    if ( m_Blocks.size() > 1 )
+    {
+        const size_t size = getCapacity();
+
+        for ( const Block& block: m_Blocks )
+            m_Upstream->deallocate( block.data, block.size, alignof( std::max_align_t ) );
+        m_Blocks.clear();
+
+        m_Block = 0;
+        addBlock( size );
+    }
+
+    m_Block  = 0;
+    m_Offset = 0;
+}
+
+void FrameArena::rewind( const Marker& marker ) noexcept
+{
+    assert( marker.block < m_Block || ( marker.block == m_Block && marker.offset <= m_Offset ) );
+
+    m_Block  = marker.block;
+    m_Offset = marker.offset;
+}
+
+size_t FrameArena::getUsedBytes() const noexcept
+{
+    size_t used = m_Offset;
+    for ( size_t i = 0; i < m_Block && i < m_Blocks.size(); ++i )
+        used += m_Blocks[i].size;
+
+    return used;
+}
+
+size_t FrameArena::getCapacity() const noexcept
+{
+    size_t capacity = 0;
+    for ( const Block& block: m_Blocks )
+        capacity += block.size;
+
+    return capacity;
+}
+
+void* FrameArena::do_allocate( size_t bytes, size_t alignment )
+{
+    // Find the first block (starting at the current block) that fits the allocation.
+    while ( m_Block < m_Blocks.size() )
+    {
+        const Block& block   = m_Blocks[m_Block];
+        const auto   address = reinterpret_cast<std::uintptr_t>( block.data ) + m_Offset;
+        const size_t padding = ( alignment - address % alignment ) % alignment;
+
+        if ( m_Offset + padding + bytes <= block.size )
+        {
+            void* p  = block.data + m_Offset + padding;
+            m_Offset += padding + bytes;
+            return p;
+        }
+
+        ++m_Block;
+        m_Offset = 0;
+    }
+
+    // None of the blocks fit: add a block that is large enough for the allocation.
+    addBlock( std::max( m_BlockSize, bytes + alignment ) );
+
+    const Block& block   = m_Blocks[m_Block];
+    const auto   address = reinterpret_cast<std::uintptr_t>( block.data );
+    const size_t padding = ( alignment - address % alignment ) % alignment;
+
+    m_Offset = padding + bytes;
+    return block.data + padding;
+}
+
+void FrameArena::do_deallocate( void*, size_t, size_t )
+{
+    // Memory is only released by reset or rewind.
+}
+
+bool FrameArena::do_is_equal( const std::pmr::memory_resource& other ) const noexcept
+{
+    return this == &other;
+}
+
+void FrameArena::addBlock( size_t size )
+{
+    auto* data = static_cast<std::byte*>( m_Upstream->allocate( size, alignof( std::max_align_t ) ) );
+    m_Blocks.push_back( Block { data, size } );
+
+    m_Block  = m_Blocks.size() - 1;
+    m_Offset = 0;
+}
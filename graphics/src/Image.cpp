@@ -1,3 +1,4 @@
+#include <graphics/AllocationTracker.hpp>
 #include <graphics/Image.hpp>
 #include <iostream>
 
@@ -16,8 +17,8 @@ Image::Image( const Image& copy )
 {
     if ( copy.m_Pixels )
     {
-        resize( copy.m_Width, copy.m_Height );
-        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
+        resize( copy.m_Width, copy.m_Height, copy.m_Layout );
+        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( m_Stride ) * m_Height * sizeof( Color ) );
     }
 }
 
@@ -27,11 +28,15 @@ Image::Image( Image&& other ) noexcept
 , m_AABB( std::exchange( other.m_AABB, {} ) )
 , m_Width( std::exchange( other.m_Width, 0 ) )
 , m_Height( std::exchange( other.m_Height, 0 ) )
+, m_Stride( std::exchange( other.m_Stride, 0 ) )
+, m_Layout( other.m_Layout )
 , m_Pixels( std::move( other.m_Pixels ) )
 {}
 
 Image::Image( const std::filesystem::path& fileName )
 {
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Image };
+
     int            w, h, n;
     unsigned char* data = stbi_load( fileName.string().c_str(), &w, &h, &n, STBI_rgb_alpha );
     if ( !data )
@@ -41,14 +46,18 @@ Image::Image( const std::filesystem::path& fileName )
     }
 
     resize( static_cast<uint32_t>( w ), static_cast<uint32_t>( h ) );
-    std::memcpy( m_Pixels.get(), data, static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
+
+    // The loaded pixels are tightly packed.
+    const size_t rowSize = static_cast<size_t>( m_Width ) * sizeof( Color );
+    for ( int y = 0; y < m_Height; ++y )
+        std::memcpy( m_Pixels.get() + static_cast<size_t>( y ) * m_Stride, data + y * rowSize, rowSize );
 
     stbi_image_free( data );
 }
 
-Image::Image( uint32_t width, uint32_t height, std::optional<Color> color )
+Image::Image( uint32_t width, uint32_t height, std::optional<Color> color, ImageLayout layout )
 {
-    resize( width, height );
+    resize( width, height, layout );
     if ( color )
     {
         clear( *color );
@@ -62,8 +71,8 @@ Image& Image::operator=( const Image& copy )
 
     if ( copy.m_Pixels )
     {
-        resize( copy.m_Width, copy.m_Height );
-        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( copy.m_Width ) * copy.m_Height * sizeof( Color ) );
+        resize( copy.m_Width, copy.m_Height, copy.m_Layout );
+        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( m_Stride ) * m_Height * sizeof( Color ) );
     }
 
     return *this;
@@ -79,6 +88,8 @@ Image& Image::operator=( Image&& other ) noexcept
     m_AABB     = std::exchange( other.m_AABB, {} );
     m_Width    = std::exchange( other.m_Width, 0 );
     m_Height   = std::exchange( other.m_Height, 0 );
+    m_Stride   = std::exchange( other.m_Stride, 0 );
+    m_Layout   = other.m_Layout;
     m_Pixels   = std::move( other.m_Pixels );
 
     return *this;
@@ -121,7 +132,7 @@ const Color& Image::sample( int u, int v, const SamplerState& samplerState ) con
     assert( u >= 0 && u < w );
     assert( v >= 0 && v < h );
 
-    return m_Pixels[v * m_Width + u];
+    return m_Pixels[v * m_Stride + u];
 }
 
 void Image::save( const std::filesystem::path& file ) const
@@ -130,19 +141,25 @@ void Image::save( const std::filesystem::path& file ) const
 
     if ( extension == ".png" )
     {
-        stbi_write_png( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get(), m_Width * static_cast<int>( sizeof( Color ) ) );
+        stbi_write_png( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get(), getPitch() );
+        return;
     }
-    else if ( extension == ".bmp" )
+
+    // The other writers expect tightly packed rows.
+    const Image  packedCopy = m_Layout == ImageLayout::Packed ? Image {} : packed();
+    const Color* pixels     = m_Layout == ImageLayout::Packed ? m_Pixels.get() : packedCopy.data();
+
+    if ( extension == ".bmp" )
     {
-        stbi_write_bmp( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get() );
+        stbi_write_bmp( file.string().c_str(), m_Width, m_Height, 4, pixels );
     }
     else if ( extension == ".tga" )
     {
-        stbi_write_tga( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get() );
+        stbi_write_tga( file.string().c_str(), m_Width, m_Height, 4, pixels );
     }
     else if ( extension == ".jpg" )
     {
-        stbi_write_jpg( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get(), 10 );
+        stbi_write_jpg( file.string().c_str(), m_Width, m_Height, 4, pixels, 10 );
     }
     else
     {
@@ -150,23 +167,50 @@ void Image::save( const std::filesystem::path& file ) const
     }
 }
 
+Image Image::packed() const
+{
+    Image image;
+    if ( m_Pixels )
+    {
+        image.resize( m_Width, m_Height, ImageLayout::Packed );
+        for ( int y = 0; y < m_Height; ++y )
+            std::memcpy( image.m_Pixels.get() + static_cast<size_t>( y ) * m_Width, m_Pixels.get() + static_cast<size_t>( y ) * m_Stride, m_Width * sizeof( Color ) );
+    }
+
+    return image;
+}
+
 void Image::clear( const Color& color ) noexcept
 {
-    std::fill_n( m_Pixels.get(), m_Width * m_Height, color );
+    // The padding is cleared too, so the whole buffer is filled in one pass.
+    std::fill_n( m_Pixels.get(), static_cast<size_t>( m_Stride ) * m_Height, color );
 }
 
-void Image::resize( uint32_t width, uint32_t height )
+void Image::resize( uint32_t width, uint32_t height, std::optional<ImageLayout> newLayout )
 {
     assert( width < INT_MAX );
     assert( height < INT_MAX );
 
-    if ( m_Pixels && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) )
+    const ImageLayout layout = newLayout.value_or( m_Layout );
+
+    if ( m_Pixels && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) && m_Layout == layout )
         return;
 
+    // Round the rows of a padded image up to a multiple of the row alignment.
+    constexpr int pixelsPerAlignment = RowAlignment / static_cast<int>( sizeof( Color ) );
+
     m_Width  = static_cast<int>( width );
     m_Height = static_cast<int>( height );
+    m_Layout = layout;
+    m_Stride = layout == ImageLayout::Padded ? ( m_Width + pixelsPerAlignment - 1 ) / pixelsPerAlignment * pixelsPerAlignment : m_Width;
+
+    const size_t size = static_cast<size_t>( m_Stride ) * height;
+
+    // The pixels bypass the global operator new, so they are recorded explicitly.
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Image };
+    AllocationTracker::recordAllocation( size * sizeof( Color ) );
 
-    m_Pixels = make_aligned_unique<Color[], 64>( static_cast<size_t>( width ) * height );
+    m_Pixels = make_aligned_unique<Color[], RowAlignment, huge_page_alloc_policy<>>( size );
 
     widthInfo  = AddressingInfo { m_Width };
     heightInfo = AddressingInfo { m_Height };
@@ -0,0 +1,392 @@
+#include <graphics/FrameArena.hpp>
+#include <graphics/Mesh.hpp>
+#include <graphics/ResourceManager.hpp>
+
+#include <algorithm>  // For std::ranges::fill, std::min
+#include <array>
+#include <cassert>
+#include <charconv>  // For std::from_chars
+#include <cmath>     // For std::pow
+#include <iterator>  // For std::distance
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace cpprast::graphics;
+
+namespace
+{
+constexpr bool isWhitespace( char c ) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Split the next whitespace-separated token off the front of a line.
+std::string_view nextToken( std::string_view& line ) noexcept
+{
+    size_t begin = 0;
+    while ( begin < line.size() && isWhitespace( line[begin] ) )
+        ++begin;
+
+    size_t end = begin;
+    while ( end < line.size() && !isWhitespace( line[end] ) )
+        ++end;
+
+    const std::string_view token = line.substr( begin, end - begin );
+    line.remove_prefix( end );
+
+    return token;
+}
+
+template<typename T>
+T toNumber( std::string_view str, T defaultValue = T {} ) noexcept
+{
+    T value;
+    if ( auto [ptr, ec] = std::from_chars( str.data(), str.data() + str.size(), value ); ec == std::errc {} )
+        return value;
+
+    return defaultValue;
+}
+
+// Resolve a (1-based or negative relative) OBJ index. Returns -1 for invalid or missing indices.
+int64_t resolveIndex( std::string_view str, size_t count ) noexcept
+{
+    const int64_t index = toNumber<int64_t>( str, 0 );
+
+    if ( index > 0 && static_cast<size_t>( index ) <= count )
+        return index - 1;
+    if ( index < 0 && static_cast<size_t>( -index ) <= count )
+        return static_cast<int64_t>( count ) + index;
+
+    return -1;
+}
+
+// The vertex scores of Forsyth's algorithm (https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html).
+constexpr float CacheDecayPower   = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+float getVertexScore( int cachePosition, uint32_t remainingTriangles ) noexcept
+{
+    // Vertices without remaining triangles are never selected again.
+    if ( remainingTriangles == 0 )
+        return -1.0f;
+
+    float score = 0.0f;
+
+    if ( cachePosition >= 0 )
+    {
+        // The vertices of the last triangle get a fixed score, so the next triangle doesn't share an edge with it (which suits strips, not caches).
+        if ( cachePosition < 3 )
+            score = LastTriangleScore;
+        else
+            score = std::pow( 1.0f - static_cast<float>( cachePosition - 3 ) / static_cast<float>( Mesh::CacheSize - 3 ), CacheDecayPower );
+    }
+
+    // Boost vertices with few remaining triangles, so they are finished and can leave the cache.
+    score += ValenceBoostScale * std::pow( static_cast<float>( remainingTriangles ), -ValenceBoostPower );
+
+    return score;
+}
+
+// Reorder the triangles of an index buffer for a vertex cache of Mesh::CacheSize entries.
+std::vector<uint32_t> optimizeVertexCache( std::span<const uint32_t> indices, size_t numVertices )
+{
+    const size_t numTriangles = indices.size() / 3;
+
+    // The working arrays only live for this call, so they are allocated from the arena of the calling thread.
+    FrameArena::Scope scope { FrameArena::getThreadArena() };
+    FrameArena&       arena = scope.getArena();
+
+    // The triangles that use a vertex (a compressed adjacency list). The active triangles of vertex v are
+    // adjacency[offsets[v] ... offsets[v] + remaining[v]), emitted triangles are swapped out of that range.
+    std::pmr::vector<uint32_t> remaining( numVertices, 0u, &arena );
+    std::pmr::vector<uint32_t> offsets( numVertices + 1, 0u, &arena );
+    std::pmr::vector<uint32_t> adjacency( numTriangles * 3, &arena );
+
+    for ( size_t i = 0; i < numTriangles * 3; ++i )
+        ++remaining[indices[i]];
+
+    for ( size_t v = 0; v < numVertices; ++v )
+        offsets[v + 1] = offsets[v] + remaining[v];
+
+    {
+        std::pmr::vector<uint32_t> fill( offsets.begin(), offsets.end() - 1, &arena );
+        for ( size_t i = 0; i < numTriangles * 3; ++i )
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>( i / 3 );
+    }
+
+    std::pmr::vector<float> vertexScore( numVertices, &arena );
+    std::pmr::vector<float> triangleScore( numTriangles, 0.0f, &arena );
+    std::pmr::vector<bool>  emitted( numTriangles, false, &arena );
+
+    for ( size_t v = 0; v < numVertices; ++v )
+        vertexScore[v] = getVertexScore( -1, remaining[v] );
+
+    for ( size_t t = 0; t < numTriangles; ++t )
+    {
+        for ( size_t k = 0; k < 3; ++k )
+            triangleScore[t] += vertexScore[indices[t * 3 + k]];
+    }
+
+    // The simulated cache. It temporarily holds 3 more entries while the vertices of a triangle are added.
+    std::array<uint32_t, Mesh::CacheSize + 3> cache;
+    std::array<uint32_t, Mesh::CacheSize + 3> newCache;
+    size_t                                    cacheCount = 0;
+
+    std::vector<uint32_t> output;
+    output.reserve( numTriangles * 3 );
+
+    // The best triangle to start with is the one with the highest score.
+    int64_t best = numTriangles > 0 ? std::distance( triangleScore.begin(), std::ranges::max_element( triangleScore ) ) : -1;
+    size_t  scan = 0;  // The first triangle that may not have been emitted yet.
+
+    while ( output.size() < numTriangles * 3 )
+    {
+        // If no triangle in the cache has remaining work, continue with the next triangle that has not been emitted.
+        if ( best < 0 )
+        {
+            while ( emitted[scan] )
+                ++scan;
+
+            best = static_cast<int64_t>( scan );
+        }
+
+        const auto t = static_cast<size_t>( best );
+        emitted[t]   = true;
+
+        // Emit the triangle, and remove it from the adjacency of its vertices.
+        size_t newCount = 0;
+        for ( size_t k = 0; k < 3; ++k )
+        {
+            const uint32_t v = indices[t * 3 + k];
+            output.push_back( v );
+
+            uint32_t* triangles = adjacency.data() + offsets[v];
+            uint32_t* last      = triangles + --remaining[v];
+            *std::find( triangles, last, static_cast<uint32_t>( t ) ) = *last;
+
+            newCache[newCount++] = v;
+        }
+
+        // The vertices of the triangle move to the front of the cache (LRU), followed by the previous contents.
+        for ( size_t i = 0; i < cacheCount; ++i )
+        {
+            const uint32_t v = cache[i];
+            if ( v != newCache[0] && v != newCache[1] && v != newCache[2] )
+                newCache[newCount++] = v;
+        }
+
+        // Update the scores of the vertices in the (overfull) cache, and of their triangles.
+        // The vertices beyond the cache size are evicted.
+        for ( size_t i = 0; i < newCount; ++i )
+        {
+            const uint32_t v        = newCache[i];
+            const int      position = i < static_cast<size_t>( Mesh::CacheSize ) ? static_cast<int>( i ) : -1;
+            const float    score    = getVertexScore( position, remaining[v] );
+            const float    delta    = score - vertexScore[v];
+
+            vertexScore[v] = score;
+
+            for ( uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; ++j )
+                triangleScore[adjacency[j]] += delta;
+        }
+
+        cacheCount = std::min( newCount, static_cast<size_t>( Mesh::CacheSize ) );
+        std::copy_n( newCache.begin(), cacheCount, cache.begin() );
+
+        // Pick the best triangle of the vertices in the cache, once the scores of all their triangles are final.
+        best            = -1;
+        float bestScore = -1.0f;
+        for ( size_t i = 0; i < cacheCount; ++i )
+        {
+            const uint32_t v = cache[i];
+            for ( uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; ++j )
+            {
+                const uint32_t triangle = adjacency[j];
+                if ( triangleScore[triangle] > bestScore )
+                {
+                    best      = triangle;
+                    bestScore = triangleScore[triangle];
+                }
+            }
+        }
+    }
+
+    return output;
+}
+}  // namespace
+
+Mesh::Mesh( const std::filesystem::path& fileName )
+{
+    const auto contents = ResourceManager::readFile( fileName );
+    if ( !contents )
+    {
+        std::cerr << "ERROR: Could not load: " << fileName.string() << std::endl;
+        return;
+    }
+
+    // The parsed attributes are only needed while the mesh is built, so they are allocated from the arena of the calling thread.
+    FrameArena::Scope scope { FrameArena::getThreadArena() };
+    FrameArena&       arena = scope.getArena();
+
+    std::pmr::vector<glm::vec3> positions { &arena };
+    std::pmr::vector<glm::vec2> texCoords { &arena };
+
+    // Every unique pair of position and texture coordinate indices is a vertex.
+    std::pmr::unordered_map<uint64_t, uint32_t> vertices { &arena };
+    std::pmr::vector<uint32_t>                  polygon { &arena };
+
+    std::string_view rest = *contents;
+    while ( !rest.empty() )
+    {
+        const size_t     end  = rest.find( '\n' );
+        std::string_view line = rest.substr( 0, end );
+        rest.remove_prefix( end == std::string_view::npos ? rest.size() : end + 1 );
+
+        const std::string_view keyword = nextToken( line );
+
+        if ( keyword == "v" )
+        {
+            const float x = toNumber<float>( nextToken( line ) );
+            const float y = toNumber<float>( nextToken( line ) );
+            const float z = toNumber<float>( nextToken( line ) );
+            positions.emplace_back( x, y, z );
+        }
+        else if ( keyword == "vt" )
+        {
+            const float u = toNumber<float>( nextToken( line ) );
+            const float v = toNumber<float>( nextToken( line ) );
+            texCoords.emplace_back( u, 1.0f - v );
+        }
+        else if ( keyword == "f" )
+        {
+            polygon.clear();
+
+            // The vertices of a face are position[/texcoord[/normal]].
+            for ( std::string_view token = nextToken( line ); !token.empty(); token = nextToken( line ) )
+            {
+                const size_t  slash    = token.find( '/' );
+                const int64_t position = resolveIndex( token.substr( 0, slash ), positions.size() );
+                if ( position < 0 )
+                {
+                    std::cerr << "ERROR: Invalid face in: " << fileName.string() << std::endl;
+                    *this = Mesh {};
+                    return;
+                }
+
+                int64_t texCoord = -1;
+                if ( slash != std::string_view::npos )
+                {
+                    const std::string_view uv = token.substr( slash + 1 );
+                    texCoord                  = resolveIndex( uv.substr( 0, uv.find( '/' ) ), texCoords.size() );
+                }
+
+                const uint64_t key = static_cast<uint64_t>( position ) << 32 | static_cast<uint32_t>( texCoord );
+                const auto [it, inserted] = vertices.try_emplace( key, static_cast<uint32_t>( m_X.size() ) );
+                if ( inserted )
+                {
+                    const glm::vec3& p  = positions[static_cast<size_t>( position )];
+                    const glm::vec2  uv = texCoord >= 0 ? texCoords[static_cast<size_t>( texCoord )] : glm::vec2 { 0.0f };
+
+                    m_X.push_back( p.x );
+                    m_Y.push_back( p.y );
+                    m_Z.push_back( p.z );
+                    m_U.push_back( uv.x );
+                    m_V.push_back( uv.y );
+                }
+
+                polygon.push_back( it->second );
+            }
+
+            // Triangulate the polygon as a triangle fan.
+            for ( size_t i = 2; i < polygon.size(); ++i )
+                m_Indices.insert( m_Indices.end(), { polygon[0], polygon[i - 1], polygon[i] } );
+        }
+    }
+
+    optimize();
+}
+
+Mesh::Mesh( std::span<const glm::vec3> positions, std::span<const glm::vec2> texCoords, std::vector<uint32_t> indices )
+: m_Indices { std::move( indices ) }
+{
+    assert( texCoords.empty() || texCoords.size() == positions.size() );
+    assert( m_Indices.size() % 3 == 0 );
+
+    m_X.reserve( positions.size() );
+    m_Y.reserve( positions.size() );
+    m_Z.reserve( positions.size() );
+
+    for ( const glm::vec3& p: positions )
+    {
+        m_X.push_back( p.x );
+        m_Y.push_back( p.y );
+        m_Z.push_back( p.z );
+    }
+
+    m_U.resize( positions.size(), 0.0f );
+    m_V.resize( positions.size(), 0.0f );
+
+    for ( size_t i = 0; i < texCoords.size(); ++i )
+    {
+        m_U[i] = texCoords[i].x;
+        m_V[i] = texCoords[i].y;
+    }
+}
+
+void Mesh::optimize()
+{
+    const size_t numVertices = getNumVertices();
+
+    m_Indices = optimizeVertexCache( m_Indices, numVertices );
+
+    // Number the vertices in the order they are first referenced.
+    constexpr uint32_t    Unreferenced = UINT32_MAX;
+    std::vector<uint32_t> remap( numVertices, Unreferenced );
+    uint32_t              next = 0;
+
+    for ( uint32_t& index: m_Indices )
+    {
+        if ( remap[index] == Unreferenced )
+            remap[index] = next++;
+
+        index = remap[index];
+    }
+
+    for ( uint32_t& index: remap )
+    {
+        if ( index == Unreferenced )
+            index = next++;
+    }
+
+    for ( auto* stream: { &m_X, &m_Y, &m_Z, &m_U, &m_V } )
+    {
+        std::vector<float> reordered( numVertices );
+        for ( size_t v = 0; v < numVertices; ++v )
+            reordered[remap[v]] = ( *stream )[v];
+
+        *stream = std::move( reordered );
+    }
+}
+
+float Mesh::getAverageCacheMissRatio( int cacheSize ) const
+{
+    if ( m_Indices.empty() || cacheSize <= 0 )
+        return 0.0f;
+
+    // Simulate a FIFO cache: the time a vertex entered the cache, a vertex is in the cache if fewer than cacheSize misses happened since then.
+    std::vector<int64_t> entered( getNumVertices(), -int64_t { cacheSize } - 1 );
+    int64_t              misses = 0;
+
+    for ( uint32_t index: m_Indices )
+    {
+        if ( misses - entered[index] > cacheSize )
+            entered[index] = misses++;
+    }
+
+    return static_cast<float>( misses ) / static_cast<float>( getNumTriangles() );
+}
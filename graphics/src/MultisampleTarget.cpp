@@ -0,0 +1,82 @@
+#include <graphics/AllocationTracker.hpp>
+#include <graphics/MultisampleTarget.hpp>
+
+#include <algorithm>  // For std::fill_n
+#include <climits>    // For INT_MAX
+
+using namespace cpprast::graphics;
+
+MultisampleTarget::MultisampleTarget( uint32_t width, uint32_t height, bool depth )
+: m_HasDepth { depth }
+{
+    resize( width, height );
+}
+
+void MultisampleTarget::resize( uint32_t width, uint32_t height )
+{
+    assert( width < INT_MAX );
+    assert( height < INT_MAX );
+
+    if ( m_Samples && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) )
+        return;
+
+    const size_t numSamples = static_cast<size_t>( width ) * height * NumSamples;
+
+    // The samples bypass the global operator new, so they are recorded explicitly (the partial pixel mask is tracked by operator new).
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Image };
+    AllocationTracker::recordAllocation( numSamples * ( sizeof( Color ) + ( m_HasDepth ? sizeof( float ) : 0 ) ) );
+
+    m_Width   = static_cast<int>( width );
+    m_Height  = static_cast<int>( height );
+    m_Samples = make_aligned_unique<Color[], 64, huge_page_alloc_policy<>>( numSamples );
+    m_Partial = BitGrid { width, height };
+
+    if ( m_HasDepth )
+        m_Depth = make_aligned_unique<float[], 64, huge_page_alloc_policy<>>( numSamples );
+
+    clear();
+}
+
+void MultisampleTarget::clear( float depth ) noexcept
+{
+    if ( m_Depth )
+        std::fill_n( m_Depth.get(), static_cast<size_t>( m_Width ) * m_Height * NumSamples, depth );
+
+    m_Partial.fill( false );
+}
+
+void MultisampleTarget::resolve( Image& image )
+{
+    assert( image.getWidth() == m_Width && image.getHeight() == m_Height );
+
+    Color*    pixels = image.data();
+    const int stride = image.getStride();
+
+    m_Partial.forEachSet( 0, 0, m_Width - 1, m_Height - 1, [&]( uint32_t x, uint32_t y ) {
+        const size_t i       = static_cast<size_t>( y ) * m_Width + x;
+        const Color* samples = m_Samples.get() + i * NumSamples;
+        Color&       pixel   = pixels[static_cast<size_t>( y ) * stride + x];
+
+        uint32_t sum[4] = { 0u, 0u, 0u, 0u };
+        for ( int s = 0; s < NumSamples; ++s )
+        {
+            sum[0] += samples[s].channels.r;
+            sum[1] += samples[s].channels.g;
+            sum[2] += samples[s].channels.b;
+            sum[3] += samples[s].channels.a;
+        }
+
+        // Round to nearest.
+        constexpr uint32_t half = NumSamples / 2;
+        pixel                   = Color {
+            static_cast<uint8_t>( ( sum[0] + half ) / NumSamples ),
+            static_cast<uint8_t>( ( sum[1] + half ) / NumSamples ),
+            static_cast<uint8_t>( ( sum[2] + half ) / NumSamples ),
+            static_cast<uint8_t>( ( sum[3] + half ) / NumSamples ),
+        };
+
+        return true;
+    } );
+
+    m_Partial.fill( false );
+}
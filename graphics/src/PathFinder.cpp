@@ -0,0 +1,364 @@
+#include <graphics/PathFinder.hpp>
+
+#include <algorithm>  // For std::ranges::reverse
+#include <cassert>
+#include <cmath>
+
+using namespace cpprast::graphics;
+using namespace cpprast::math;
+
+namespace
+{
+constexpr uint32_t InvalidIndex = UINT32_MAX;
+constexpr float    Sqrt2        = 1.41421356f;
+
+/// <summary>
+/// The octile distance between two cells. This is the exact cost of the shortest path between the cells on an empty grid.
+/// </summary>
+float octile( const glm::ivec2& a, const glm::ivec2& b ) noexcept
+{
+    const int dx = std::abs( a.x - b.x );
+    const int dy = std::abs( a.y - b.y );
+
+    return static_cast<float>( std::max( dx, dy ) ) + ( Sqrt2 - 1.0f ) * static_cast<float>( std::min( dx, dy ) );
+}
+
+int sign( int v ) noexcept
+{
+    return ( v > 0 ) - ( v < 0 );
+}
+
+/// <summary>
+/// Move from a cell in a direction until a jump point is found.
+/// A jump point is the goal, or a cell with a forced neighbor that can only be reached optimally through it.
+/// </summary>
+/// <returns>The jump point, or an empty optional if the move runs into an obstacle.</returns>
+std::optional<glm::ivec2> jump( const BitGrid& walkable, int x, int y, int dx, int dy, const glm::ivec2& goal ) noexcept
+{
+    while ( walkable.get( x, y ) )
+    {
+        if ( x == goal.x && y == goal.y )
+            return glm::ivec2 { x, y };
+
+        if ( dx != 0 && dy != 0 )
+        {
+            // A diagonal move stops at any cell from which a horizontal or vertical jump finds a jump point.
+            if ( jump( walkable, x + dx, y, dx, 0, goal ) || jump( walkable, x, y + dy, 0, dy, goal ) )
+                return glm::ivec2 { x, y };
+
+            // Corners can't be cut.
+            if ( !walkable.get( x + dx, y ) || !walkable.get( x, y + dy ) )
+                return {};
+        }
+        else if ( dx != 0 )
+        {
+            if ( ( walkable.get( x, y - 1 ) && !walkable.get( x - dx, y - 1 ) ) ||
+                 ( walkable.get( x, y + 1 ) && !walkable.get( x - dx, y + 1 ) ) )
+                return glm::ivec2 { x, y };
+        }
+        else
+        {
+            if ( ( walkable.get( x - 1, y ) && !walkable.get( x - 1, y - dy ) ) ||
+                 ( walkable.get( x + 1, y ) && !walkable.get( x + 1, y - dy ) ) )
+                return glm::ivec2 { x, y };
+        }
+
+        x += dx;
+        y += dy;
+    }
+
+    return {};
+}
+}  // namespace
+
+BitGrid cpprast::graphics::getWalkableGrid( const TileCollisionMap& collisionMap )
+{
+    BitGrid walkable { collisionMap.getColumns(), collisionMap.getRows(), true };
+
+    const BitGrid& solid = collisionMap.getSolidGrid();
+    solid.forEachSet( 0, 0, static_cast<int>( solid.getWidth() ) - 1, static_cast<int>( solid.getHeight() ) - 1, [&walkable]( uint32_t x, uint32_t y ) {
+        walkable.set( x, y, false );
+        return true;
+    } );
+
+    return walkable;
+}
+
+PathFinder::PathFinder( uint32_t width, uint32_t height )
+{
+    reserve( width, height );
+}
+
+void PathFinder::reserve( uint32_t width, uint32_t height )
+{
+    const size_t numNodes = static_cast<size_t>( width ) * height;
+    if ( m_Nodes.size() < numNodes )
+    {
+        m_Nodes.resize( numNodes );
+        m_Open.reserve( numNodes );
+    }
+}
+
+void PathFinder::beginQuery()
+{
+    m_Open.clear();
+    m_NumExpanded = 0;
+
+    if ( ++m_Generation == 0 )
+    {
+        // The generation counter wrapped around. Reset the stamps so stale nodes are not mistaken for visited nodes.
+        for ( auto& node: m_Nodes )
+            node.generation = 0;
+
+        m_Generation = 1;
+    }
+}
+
+void PathFinder::open( uint32_t index, uint32_t parent, float g, const glm::ivec2& cell, const glm::ivec2& goal )
+{
+    Node&       node = m_Nodes[index];
+    const float f    = g + octile( cell, goal );
+
+    if ( node.generation != m_Generation )
+    {
+        node = { g, parent, m_Generation, static_cast<uint32_t>( m_Open.size() ), false };
+        m_Open.push_back( { f, index } );
+    }
+    else if ( node.closed || g >= node.g )
+    {
+        return;
+    }
+    else
+    {
+        // The node is still open, decrease its cost in place.
+        node.g                   = g;
+        node.parent              = parent;
+        m_Open[node.heapIndex].f = f;
+    }
+
+    siftUp( node.heapIndex );
+}
+
+bool PathFinder::popOpen( uint32_t& index )
+{
+    if ( m_Open.empty() )
+        return false;
+
+    index = m_Open.front().index;
+
+    m_Open.front() = m_Open.back();
+    m_Open.pop_back();
+
+    if ( !m_Open.empty() )
+    {
+        m_Nodes[m_Open.front().index].heapIndex = 0;
+        siftDown( 0 );
+    }
+
+    return true;
+}
+
+void PathFinder::siftUp( size_t i ) noexcept
+{
+    const OpenNode entry = m_Open[i];
+
+    while ( i > 0 )
+    {
+        const size_t parent = ( i - 1 ) / 2;
+        if ( m_Open[parent].f <= entry.f )
+            break;
+
+        m_Open[i]                          = m_Open[parent];
+        m_Nodes[m_Open[i].index].heapIndex = static_cast<uint32_t>( i );
+        i                                  = parent;
+    }
+
+    m_Open[i]                      = entry;
+    m_Nodes[entry.index].heapIndex = static_cast<uint32_t>( i );
+}
+
+void PathFinder::siftDown( size_t i ) noexcept
+{
+    const OpenNode entry = m_Open[i];
+    const size_t   size  = m_Open.size();
+
+    while ( true )
+    {
+        size_t child = 2 * i + 1;
+        if ( child >= size )
+            break;
+
+        if ( child + 1 < size && m_Open[child + 1].f < m_Open[child].f )
+            ++child;
+
+        if ( entry.f <= m_Open[child].f )
+            break;
+
+        m_Open[i]                          = m_Open[child];
+        m_Nodes[m_Open[i].index].heapIndex = static_cast<uint32_t>( i );
+        i                                  = child;
+    }
+
+    m_Open[i]                      = entry;
+    m_Nodes[entry.index].heapIndex = static_cast<uint32_t>( i );
+}
+
+void PathFinder::expandAStar( const BitGrid& walkable, const glm::ivec2& cell, uint32_t index, const glm::ivec2& goal )
+{
+    const float g = m_Nodes[index].g;
+
+    for ( int dy = -1; dy <= 1; ++dy )
+    {
+        for ( int dx = -1; dx <= 1; ++dx )
+        {
+            if ( ( dx == 0 && dy == 0 ) || !walkable.get( cell.x + dx, cell.y + dy ) )
+                continue;
+
+            const bool diagonal = dx != 0 && dy != 0;
+            if ( diagonal && ( !walkable.get( cell.x + dx, cell.y ) || !walkable.get( cell.x, cell.y + dy ) ) )
+                continue;
+
+            const glm::ivec2 neighbor { cell.x + dx, cell.y + dy };
+            open( static_cast<uint32_t>( neighbor.y ) * m_Width + static_cast<uint32_t>( neighbor.x ), index, g + ( diagonal ? Sqrt2 : 1.0f ), neighbor, goal );
+        }
+    }
+}
+
+void PathFinder::expandJumpPoint( const BitGrid& walkable, const glm::ivec2& cell, uint32_t index, const glm::ivec2& goal )
+{
+    const Node& node = m_Nodes[index];
+    const float g    = node.g;
+
+    // The directions to search from this node. Up to 8 directions (for the start node).
+    glm::ivec2 directions[8];
+    int        numDirections = 0;
+
+    if ( node.parent == InvalidIndex )
+    {
+        for ( int dy = -1; dy <= 1; ++dy )
+        {
+            for ( int dx = -1; dx <= 1; ++dx )
+            {
+                if ( dx != 0 || dy != 0 )
+                    directions[numDirections++] = { dx, dy };
+            }
+        }
+    }
+    else
+    {
+        // Prune the neighbors that can be reached optimally without going through this node.
+        const int dx = sign( cell.x - static_cast<int>( node.parent % m_Width ) );
+        const int dy = sign( cell.y - static_cast<int>( node.parent / m_Width ) );
+
+        if ( dx != 0 && dy != 0 )
+        {
+            directions[numDirections++] = { dx, 0 };
+            directions[numDirections++] = { 0, dy };
+            directions[numDirections++] = { dx, dy };
+        }
+        else if ( dx != 0 )
+        {
+            directions[numDirections++] = { dx, 0 };
+            directions[numDirections++] = { 0, -1 };
+            directions[numDirections++] = { 0, 1 };
+            directions[numDirections++] = { dx, -1 };
+            directions[numDirections++] = { dx, 1 };
+        }
+        else
+        {
+            directions[numDirections++] = { 0, dy };
+            directions[numDirections++] = { -1, 0 };
+            directions[numDirections++] = { 1, 0 };
+            directions[numDirections++] = { -1, dy };
+            directions[numDirections++] = { 1, dy };
+        }
+    }
+
+    for ( int i = 0; i < numDirections; ++i )
+    {
+        const glm::ivec2& d = directions[i];
+
+        // Corners can't be cut.
+        if ( d.x != 0 && d.y != 0 && ( !walkable.get( cell.x + d.x, cell.y ) || !walkable.get( cell.x, cell.y + d.y ) ) )
+            continue;
+
+        if ( auto jumpPoint = jump( walkable, cell.x + d.x, cell.y + d.y, d.x, d.y, goal ) )
+        {
+            open( static_cast<uint32_t>( jumpPoint->y ) * m_Width + static_cast<uint32_t>( jumpPoint->x ), index, g + octile( cell, *jumpPoint ), *jumpPoint, goal );
+        }
+    }
+}
+
+void PathFinder::buildPath( uint32_t goalIndex, uint32_t width, std::vector<glm::ivec2>& path ) const
+{
+    for ( uint32_t i = goalIndex; i != InvalidIndex; i = m_Nodes[i].parent )
+        path.emplace_back( static_cast<int>( i % width ), static_cast<int>( i / width ) );
+
+    std::ranges::reverse( path );
+}
+
+bool PathFinder::findPath( const BitGrid& walkable, const glm::ivec2& start, const glm::ivec2& goal, std::vector<glm::ivec2>& path, PathAlgorithm algorithm )
+{
+    path.clear();
+
+    if ( !walkable.get( start.x, start.y ) || !walkable.get( goal.x, goal.y ) )
+        return false;
+
+    m_Width = walkable.getWidth();
+    reserve( walkable.getWidth(), walkable.getHeight() );
+    beginQuery();
+
+    const uint32_t startIndex = static_cast<uint32_t>( start.y ) * m_Width + static_cast<uint32_t>( start.x );
+    const uint32_t goalIndex  = static_cast<uint32_t>( goal.y ) * m_Width + static_cast<uint32_t>( goal.x );
+
+    open( startIndex, InvalidIndex, 0.0f, start, goal );
+
+    uint32_t index;
+    while ( popOpen( index ) )
+    {
+        if ( index == goalIndex )
+        {
+            buildPath( goalIndex, m_Width, path );
+            return true;
+        }
+
+        m_Nodes[index].closed = true;
+        ++m_NumExpanded;
+
+        const glm::ivec2 cell { static_cast<int>( index % m_Width ), static_cast<int>( index / m_Width ) };
+
+        switch ( algorithm )
+        {
+        case PathAlgorithm::AStar:
+            expandAStar( walkable, cell, index, goal );
+            break;
+        case PathAlgorithm::JumpPoint:
+            expandJumpPoint( walkable, cell, index, goal );
+            break;
+        }
+    }
+
+    return false;
+}
+
+void cpprast::graphics::findPaths( const BitGrid& walkable, std::span<PathQuery> queries, std::span<PathFinder> pathFinders, WorkerPool& workers, PathAlgorithm algorithm )
+{
+    assert( !pathFinders.empty() );
+
+    const size_t numWorkers = std::min( pathFinders.size(), queries.size() );
+    if ( numWorkers == 0 )
+        return;
+
+    // Every worker solves an interleaved subset of the queries so that expensive queries that are
+    // next to each other are spread over the workers.
+    auto worker = [&walkable, queries, pathFinders, numWorkers, algorithm]( uint32_t first ) {
+        PathFinder& pathFinder = pathFinders[first];
+        for ( size_t i = first; i < queries.size(); i += numWorkers )
+        {
+            PathQuery& query = queries[i];
+            query.found      = pathFinder.findPath( walkable, query.start, query.goal, query.path, algorithm );
+        }
+    };
+
+    workers.run( static_cast<uint32_t>( numWorkers ), worker );
+}
@@ -1,16 +1,612 @@
+#include <graphics/AllocationTracker.hpp>
 #include <graphics/Rasterizer.hpp>
 
+#include <algorithm>  // For std::min, std::max
+#include <array>
+#include <cassert>
+#include <cmath>  // For std::floor, std::round
+#include <cstring>  // For std::memcpy
+#include <limits>
+#include <optional>
+#include <vector>
+
 using namespace cpprast::graphics;
 using namespace cpprast::math;
 
+namespace
+{
+/// <summary>
+/// Compute the range of tiles of a tile map that overlap the clipping region of the color target.
+/// </summary>
+/// <param name="dstAABB">The clipping region of the color target.</param>
+/// <param name="x">The x-coordinate of the top-left corner of the tile map on the color target.</param>
+/// <param name="y">The y-coordinate of the top-left corner of the tile map on the color target.</param>
+/// <param name="columns">The number of columns in the tile map.</param>
+/// <param name="rows">The number of rows in the tile map.</param>
+/// <param name="tileWidth">The width of a tile (in pixels).</param>
+/// <param name="tileHeight">The height of a tile (in pixels).</param>
+/// <returns>The (inclusive) range of visible tiles as min (column, row) and max (column, row), or an empty optional if no tiles are visible.</returns>
+std::optional<std::pair<glm::ivec2, glm::ivec2>> getVisibleTiles( const AABB& dstAABB, int x, int y, int columns, int rows, int tileWidth, int tileHeight ) noexcept
+{
+    if ( columns <= 0 || rows <= 0 || tileWidth <= 0 || tileHeight <= 0 )
+        return {};
+
+    const int firstColumn = std::max( 0, floor_div( static_cast<int>( dstAABB.min.x ) - x, tileWidth ) );
+    const int firstRow    = std::max( 0, floor_div( static_cast<int>( dstAABB.min.y ) - y, tileHeight ) );
+    const int lastColumn  = std::min( columns - 1, floor_div( static_cast<int>( dstAABB.max.x ) - x, tileWidth ) );
+    const int lastRow     = std::min( rows - 1, floor_div( static_cast<int>( dstAABB.max.y ) - y, tileHeight ) );
+
+    if ( firstColumn > lastColumn || firstRow > lastRow )
+        return {};
+
+    return std::pair { glm::ivec2 { firstColumn, firstRow }, glm::ivec2 { lastColumn, lastRow } };
+}
+
+/// <summary>
+/// Compute the scissor rectangle: the part of the viewport that is inside of the color target and the clipping rectangle.
+/// </summary>
+/// <returns>The first and the last (inclusive) pixel of the scissor rectangle, or an empty optional if it is empty.</returns>
+std::optional<std::pair<glm::ivec2, glm::ivec2>> getScissor( const Image& image, const RectUI& clipRect, const Viewport& viewport ) noexcept
+{
+    const AABB       dstAABB = image.getAABB().clamped( AABB::fromRect( clipRect ) ).clamped( AABB { viewport } );
+    const glm::ivec2 first { static_cast<int>( dstAABB.min.x ), static_cast<int>( dstAABB.min.y ) };
+    const glm::ivec2 last { static_cast<int>( dstAABB.max.x ), static_cast<int>( dstAABB.max.y ) };
+
+    if ( first.x > last.x || first.y > last.y )
+        return {};
+
+    return std::pair { first, last };
+}
+
+/// <summary>
+/// Convert a screen position to 28.4 fixed-point.
+/// </summary>
+FixedVec2_28_4 toFixed( const glm::vec4& screenPosition ) noexcept
+{
+    return FixedVec2_28_4 { glm::vec2 { screenPosition.x, screenPosition.y } };
+}
+
+/// <summary>
+/// Rasterize a triangle using fixed-point edge functions.
+/// A pixel is covered if its center is inside the triangle. Pixel centers exactly on an edge are only covered if the edge is
+/// a top or a left edge (top-left rule), so pixels on an edge that is shared by two triangles are drawn exactly once.
+///
+/// With multisampling, the coverage is evaluated at the samples of the multisample target (with the same rules), and a pixel
+/// is part of a span if any of its samples is covered.
+/// </summary>
+/// <param name="v0">The screen position of the first vertex.</param>
+/// <param name="v1">The screen position of the second vertex.</param>
+/// <param name="v2">The screen position of the third vertex.</param>
+/// <param name="cullMode">The triangles to cull. Front-facing triangles are clockwise on the screen.</param>
+/// <param name="scissorMin">The first pixel that may be covered.</param>
+/// <param name="scissorMax">The last pixel that may be covered (inclusive).</param>
+/// <param name="coverage">Receives the coverage masks of the pixels of every span if multisampling is used, nullptr otherwise.</param>
+/// <param name="spanFunc">The function that is called for the covered pixels of every row with the row, the first and the last (inclusive) pixel
+/// of the span, the barycentric coordinates of the center of the first pixel, and the change of the barycentric coordinates per pixel
+/// along the x-axis and along the y-axis.</param>
+template<typename SpanFunc>
+void rasterizeTriangle( const FixedVec2_28_4& v0, const FixedVec2_28_4& v1, const FixedVec2_28_4& v2, CullMode cullMode, const glm::ivec2& scissorMin, const glm::ivec2& scissorMax,
+                        std::vector<uint8_t>* coverage, SpanFunc&& spanFunc )
+{
+    const int64_t area = cross( v1 - v0, v2 - v0 );
+
+    if ( area == 0 || ( cullMode == CullMode::Back && area < 0 ) || ( cullMode == CullMode::Front && area > 0 ) )
+        return;
+
+    // Only visit the pixels inside the scissor rectangle. The triangle itself may extend far outside of it (guard band).
+    // With multisampling, the pixels whose samples are covered extend up to the largest sample offset beyond the pixel centers.
+    FixedAABB_28_4 bounds { v0, v1 };
+    bounds.expand( v2 );
+
+    if ( coverage )
+    {
+        const Fixed28_4 margin = Fixed28_4::fromRaw( 6 );
+        bounds.min.x -= margin;
+        bounds.min.y -= margin;
+        bounds.max.x += margin;
+        bounds.max.y += margin;
+    }
+
+    const RectI pixels = bounds.getPixelRect();
+    const int   minX   = std::max( scissorMin.x, pixels.left );
+    const int   minY   = std::max( scissorMin.y, pixels.top );
+    const int   maxX   = std::min( scissorMax.x, pixels.right() - 1 );
+    const int   maxY   = std::min( scissorMax.y, pixels.bottom() - 1 );
+
+    if ( minX > maxX || minY > maxY )
+        return;
+
+    struct Edge
+    {
+        int64_t stepX;  // The change of the edge function per pixel.
+        int64_t stepY;  // The change of the edge function per row.
+        int64_t value;  // The value of the edge function at the center of the first pixel (including the bias).
+        int64_t bias;   // -1 for edges that are not top or left edges, so pixel centers on the edge are outside.
+    };
+
+    // The edge function is positive on the inside of an edge of a clockwise triangle. A counter-clockwise triangle is flipped.
+    const int64_t sign = area > 0 ? 1 : -1;
+    const int64_t px   = int64_t { minX } * Fixed28_4::One + Fixed28_4::One / 2;
+    const int64_t py   = int64_t { minY } * Fixed28_4::One + Fixed28_4::One / 2;
+
+    auto setupEdge = [&]( const FixedVec2_28_4& a, const FixedVec2_28_4& b ) {
+        const int64_t ex = sign * ( b.x.raw() - a.x.raw() );
+        const int64_t ey = sign * ( b.y.raw() - a.y.raw() );
+
+        const bool    topLeft = ey < 0 || ( ey == 0 && ex > 0 );
+        const int64_t bias    = topLeft ? 0 : -1;
+
+        return Edge { -ey * Fixed28_4::One, ex * Fixed28_4::One, ex * ( py - a.y.raw() ) - ey * ( px - a.x.raw() ) + bias, bias };
+    };
+
+    // Edge i is opposite of vertex i, so its value is proportional to the barycentric coordinate of vertex i.
+    const Edge      edges[3] = { setupEdge( v1, v2 ), setupEdge( v2, v0 ), setupEdge( v0, v1 ) };
+    const float     invArea  = 1.0f / static_cast<float>( area * sign );
+    const glm::vec3 dbdx { static_cast<float>( edges[0].stepX ) * invArea, static_cast<float>( edges[1].stepX ) * invArea, static_cast<float>( edges[2].stepX ) * invArea };
+    const glm::vec3 dbdy { static_cast<float>( edges[0].stepY ) * invArea, static_cast<float>( edges[1].stepY ) * invArea, static_cast<float>( edges[2].stepY ) * invArea };
+    const int64_t   lastOffset = maxX - minX;
+
+    // The covered pixels of a row are contiguous (the triangle is convex), so the span is computed from the edge functions
+    // instead of testing every pixel: a pixel at offset k is inside an edge if value + k * stepX >= 0.
+    auto getSpan = [&]( const int64_t ( &values )[3], int64_t& first, int64_t& last ) {
+        first = 0;
+        last  = lastOffset;
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            const int64_t value = values[i];
+            const int64_t step  = edges[i].stepX;
+
+            if ( step > 0 )
+                first = value < 0 ? std::max( first, ( -value + step - 1 ) / step ) : first;
+            else if ( step < 0 )
+                last = value >= 0 ? std::min( last, value / -step ) : -1;
+            else if ( value < 0 )
+                last = -1;
+        }
+    };
+
+    // The offsets of the edge functions at the samples from the pixel centers (the sample offsets are in 1/16 pixels, like the steps).
+    int64_t sampleOffsets[MultisampleTarget::NumSamples][3];
+    for ( int s = 0; s < MultisampleTarget::NumSamples; ++s )
+    {
+        for ( int i = 0; i < 3; ++i )
+            sampleOffsets[s][i] = ( edges[i].stepX * MultisampleTarget::SampleOffsetX[s] + edges[i].stepY * MultisampleTarget::SampleOffsetY[s] ) / Fixed28_4::One;
+    }
+
+    if ( coverage )
+        coverage->resize( static_cast<size_t>( lastOffset ) + 1 );
+
+    int64_t rows[3] = { edges[0].value, edges[1].value, edges[2].value };
+
+    for ( int y = minY; y <= maxY; ++y )
+    {
+        int64_t first;
+        int64_t last;
+
+        if ( !coverage )
+        {
+            getSpan( rows, first, last );
+        }
+        else
+        {
+            // The span of every sample. The pixels of the row are covered by the union of them.
+            int64_t sampleFirst[MultisampleTarget::NumSamples];
+            int64_t sampleLast[MultisampleTarget::NumSamples];
+
+            first = lastOffset + 1;
+            last  = -1;
+
+            for ( int s = 0; s < MultisampleTarget::NumSamples; ++s )
+            {
+                const int64_t values[3] = { rows[0] + sampleOffsets[s][0], rows[1] + sampleOffsets[s][1], rows[2] + sampleOffsets[s][2] };
+                getSpan( values, sampleFirst[s], sampleLast[s] );
+
+                if ( sampleFirst[s] <= sampleLast[s] )
+                {
+                    first = std::min( first, sampleFirst[s] );
+                    last  = std::max( last, sampleLast[s] );
+                }
+            }
+
+            for ( int64_t k = first; k <= last; ++k )
+            {
+                uint8_t mask = 0u;
+                for ( int s = 0; s < MultisampleTarget::NumSamples; ++s )
+                    mask |= k >= sampleFirst[s] && k <= sampleLast[s] ? static_cast<uint8_t>( 1u << s ) : uint8_t { 0 };
+
+                ( *coverage )[static_cast<size_t>( k - first )] = mask;
+            }
+        }
+
+        if ( first <= last )
+        {
+            const glm::vec3 barycentric {
+                static_cast<float>( rows[0] + first * edges[0].stepX - edges[0].bias ) * invArea,
+                static_cast<float>( rows[1] + first * edges[1].stepX - edges[1].bias ) * invArea,
+                static_cast<float>( rows[2] + first * edges[2].stepX - edges[2].bias ) * invArea,
+            };
+
+            spanFunc( y, minX + static_cast<int>( first ), minX + static_cast<int>( last ), barycentric, dbdx, dbdy );
+        }
+
+        for ( int i = 0; i < 3; ++i )
+            rows[i] += edges[i].stepY;
+    }
+}
+
+/// <summary>
+/// A vertex of a triangle that is ready to be rasterized.
+/// </summary>
+struct TriangleVertex
+{
+    glm::vec4 screen;   // The position on the viewport (x, y), the depth (z), and 1/w.
+    glm::vec3 weights;  // The weights of the vertices of the original triangle (a vertex that was created by clipping is a blend of them).
+};
+
+/// <summary>
+/// Reject, clip, and project the triangles of an index list.
+/// </summary>
+/// <param name="vertices">The transformed vertices.</param>
+/// <param name="indices">The indices of the vertices, 3 per triangle.</param>
+/// <param name="triangleFunc">The function that is called with the indices of the original triangle and the vertices of every triangle to rasterize.</param>
+template<typename TriangleFunc>
+void forEachTriangle( const VertexProcessor& vertices, std::span<const uint32_t> indices, TriangleFunc&& triangleFunc )
+{
+    assert( indices.size() % 3 == 0 );
+
+    const Clipper clipper { vertices.getViewport() };
+
+    std::array<ClipVertex, Clipper::MaxVertices> polygon;
+
+    for ( size_t i = 0; i + 2 < indices.size(); i += 3 )
+    {
+        const uint32_t  i0 = indices[i + 0];
+        const uint32_t  i1 = indices[i + 1];
+        const uint32_t  i2 = indices[i + 2];
+        const glm::vec4 c0 = vertices.getClipPosition( i0 );
+        const glm::vec4 c1 = vertices.getClipPosition( i1 );
+        const glm::vec4 c2 = vertices.getClipPosition( i2 );
+
+        const uint32_t code0 = clipper.getClipCode( c0 );
+        const uint32_t code1 = clipper.getClipCode( c1 );
+        const uint32_t code2 = clipper.getClipCode( c2 );
+
+        if ( Clipper::isRejected( code0, code1, code2 ) )
+            continue;
+
+        // Most triangles are inside the guard band, so the screen positions of the vertex processor can be used directly.
+        if ( !Clipper::needsClipping( code0, code1, code2 ) )
+        {
+            triangleFunc( i0, i1, i2,
+                          TriangleVertex { vertices.getScreenPosition( i0 ), { 1.0f, 0.0f, 0.0f } },
+                          TriangleVertex { vertices.getScreenPosition( i1 ), { 0.0f, 1.0f, 0.0f } },
+                          TriangleVertex { vertices.getScreenPosition( i2 ), { 0.0f, 0.0f, 1.0f } } );
+            continue;
+        }
+
+        // Draw the clipped polygon as a triangle fan.
+        const size_t n = clipper.clip( c0, c1, c2, polygon );
+        if ( n < 3 )
+            continue;
+
+        const TriangleVertex t0 { vertices.project( polygon[0].position ), polygon[0].barycentric };
+        TriangleVertex       t1 { vertices.project( polygon[1].position ), polygon[1].barycentric };
+        for ( size_t k = 2; k < n; ++k )
+        {
+            const TriangleVertex t2 { vertices.project( polygon[k].position ), polygon[k].barycentric };
+            triangleFunc( i0, i1, i2, t0, t1, t2 );
+            t1 = t2;
+        }
+    }
+}
+/// <summary>
+/// Draw the pixels left..right (inclusive) of a row of the color target with the texels of an affine scanline.
+/// </summary>
+void drawScanline( const Image& srcImage, Image& dstImage, int y, int left, int right, AffineScanline scanline, const SamplerState& samplerState,
+                   const BlendMode& blendMode ) noexcept
+{
+    const int sW = srcImage.getWidth();
+    const int sH = srcImage.getHeight();
+
+    if ( samplerState.normalizedCoordinates )
+    {
+        const glm::vec2 scale { static_cast<float>( sW - 1 ), static_cast<float>( sH - 1 ) };
+        scanline.origin = scanline.origin * scale + 0.5f;
+        scanline.step   = scanline.step * scale;
+    }
+
+    // Start at the first pixel of the span.
+    glm::vec2 origin = scanline.origin + scanline.step * static_cast<float>( left );
+
+    // Wrapped coordinates are reduced to the first period, so that they stay precise far away from the origin of the image.
+    if ( samplerState.addressMode == AddressMode::Wrap )
+    {
+        origin.x -= std::floor( origin.x / static_cast<float>( sW ) ) * static_cast<float>( sW );
+        origin.y -= std::floor( origin.y / static_cast<float>( sH ) ) * static_cast<float>( sH );
+    }
+
+    // Limit the coordinates so the texel coordinates of the whole row fit in an int (the texels this far out are all
+    // clamped, bordered, or wrapped anyway).
+    constexpr float maxOrigin = 1 << 20;
+    constexpr float maxStep   = 1 << 14;
+    auto toRaw = []( float value, float limit ) {
+        return static_cast<int64_t>( std::round( std::clamp( value, -limit, limit ) * 65536.0f ) );
+    };
+
+    int64_t       u  = toRaw( origin.x, maxOrigin );
+    int64_t       v  = toRaw( origin.y, maxOrigin );
+    const int64_t du = toRaw( scanline.step.x, maxStep );
+    const int64_t dv = toRaw( scanline.step.y, maxStep );
+
+    const Color* src     = srcImage.data();
+    const int    sStride = srcImage.getStride();
+    Color*       dst     = dstImage.data() + static_cast<size_t>( y ) * dstImage.getStride();
+
+    auto write = [&]( int x, const Color& color ) {
+        dst[x] = blendMode.blendEnable ? blendMode.Blend( color, dst[x] ) : color;
+    };
+
+    const bool pow2 = ( sW & ( sW - 1 ) ) == 0 && ( sH & ( sH - 1 ) ) == 0 && sW <= 65536 && sH <= 65536;
+    if ( samplerState.addressMode == AddressMode::Wrap && pow2 )
+    {
+        // Step in unsigned 16.16 fixed-point: the integer part wraps around modulo 2^16, which is a multiple of the size of the image,
+        // so wrapping the coordinates is only a mask.
+        const uint32_t maskU = static_cast<uint32_t>( sW - 1 );
+        const uint32_t maskV = static_cast<uint32_t>( sH - 1 );
+        auto           fu    = static_cast<uint32_t>( u );
+        auto           fv    = static_cast<uint32_t>( v );
+        const auto     fdu   = static_cast<uint32_t>( du );
+        const auto     fdv   = static_cast<uint32_t>( dv );
+
+        for ( int x = left; x <= right; ++x )
+        {
+            write( x, src[( ( fv >> 16 ) & maskV ) * sStride + ( ( fu >> 16 ) & maskU )] );
+            fu += fdu;
+            fv += fdv;
+        }
+    }
+    else
+    {
+        for ( int x = left; x <= right; ++x )
+        {
+            write( x, srcImage.sample( static_cast<int>( u >> 16 ), static_cast<int>( v >> 16 ), samplerState ) );
+            u += du;
+            v += dv;
+        }
+    }
+}
+/// <summary>
+/// The texels of the sprite of a cell, so that the shared pointer to the image of the sprite is only copied when the sprite changes.
+/// </summary>
+struct CellTexture
+{
+    int          spriteId = -1;
+    const Color* pixels   = nullptr;  // The top-left texel of the sprite.
+    int          stride   = 0;        // The distance between the rows of the image of the sprite (in pixels).
+    int          width    = 0;
+    int          height   = 0;
+    Color        color;               // The color of the sprite.
+
+    // Load the sprite of a cell. Returns false if the cell is empty or the sprite has no image.
+    bool load( const SpriteSheet& spriteSheet, int id ) noexcept
+    {
+        if ( id == spriteId )
+            return pixels != nullptr;
+
+        spriteId = id;
+        pixels   = nullptr;
+
+        if ( id < 0 || static_cast<size_t>( id ) >= spriteSheet.getNumSprites() )
+            return false;
+
+        const Sprite& sprite = spriteSheet.getSprite( id );
+        const Image*  image  = sprite.getImage().get();
+        if ( !image || sprite.getWidth() <= 0 || sprite.getHeight() <= 0 )
+            return false;
+
+        const glm::ivec2 uv = sprite.getUV();
+
+        stride = image->getStride();
+        pixels = image->data() + static_cast<size_t>( uv.y ) * stride + uv.x;
+        width  = sprite.getWidth();
+        height = sprite.getHeight();
+        color  = sprite.getColor();
+
+        return true;
+    }
+
+    Color fetch( int u, int v ) const noexcept
+    {
+        assert( u >= 0 && u < width && v >= 0 && v < height );
+        return pixels[v * stride + u] * color;
+    }
+};
+
+/// <summary>
+/// The state of a raycast view that is shared by all columns.
+/// </summary>
+struct RaycastView
+{
+    const TileMap&         walls;
+    const TileMap*         floor;
+    const TileMap*         ceiling;
+    Image&                 image;
+    glm::vec2              position;
+    glm::vec2              direction;
+    glm::vec2              plane;
+    float                  focalLength;  // The distance to the projection plane (in pixels).
+    float                  horizon;      // The row of the horizon.
+    int                    top;          // The first row to draw.
+    int                    bottom;       // The last row to draw (inclusive).
+    std::span<const float> rowDistance;  // The distance along the view direction to the floor (or ceiling) seen by every row.
+};
+
+/// <summary>
+/// Get the cell of a tile map at a position on the floor, or -1 if the position is outside of the tile map.
+/// </summary>
+int getCell( const TileMap& tileMap, const glm::vec2& p ) noexcept
+{
+    if ( !( p.x >= 0.0f && p.y >= 0.0f && p.x < static_cast<float>( tileMap.getColumns() ) && p.y < static_cast<float>( tileMap.getRows() ) ) )
+        return -1;
+
+    return tileMap.getSpriteId( static_cast<size_t>( p.x ), static_cast<size_t>( p.y ) );
+}
+
+/// <summary>
+/// Raycast and draw the columns first..last (inclusive) of a raycast view.
+/// </summary>
+void drawRaycastColumns( const RaycastView& view, int first, int last ) noexcept
+{
+    const auto  columns     = static_cast<int>( view.walls.getColumns() );
+    const auto  rows        = static_cast<int>( view.walls.getRows() );
+    const auto& wallSprites = *view.walls.getSpriteSheet();
+    const int   width       = view.image.getWidth();
+    const int   stride      = view.image.getStride();
+    Color*      pixels      = view.image.data();
+
+    CellTexture wallTexture, floorTexture, ceilingTexture;
+
+    for ( int x = first; x <= last; ++x )
+    {
+        const float     cameraX = 2.0f * ( static_cast<float>( x ) + 0.5f ) / static_cast<float>( width ) - 1.0f;
+        const glm::vec2 ray     = view.direction + view.plane * cameraX;
+
+        // Walk the cells that are crossed by the ray (DDA). The distances are measured along the view direction
+        // (not along the ray), so walls are not distorted towards the edges of the view.
+        // side is the distance to the next cell boundary along each axis, and delta is the distance between two boundaries.
+        constexpr float  infinity = std::numeric_limits<float>::infinity();
+        glm::ivec2       cell { static_cast<int>( std::floor( view.position.x ) ), static_cast<int>( std::floor( view.position.y ) ) };
+        const glm::ivec2 step { ray.x < 0.0f ? -1 : 1, ray.y < 0.0f ? -1 : 1 };
+        const glm::vec2  delta { ray.x != 0.0f ? std::abs( 1.0f / ray.x ) : infinity, ray.y != 0.0f ? std::abs( 1.0f / ray.y ) : infinity };
+        glm::vec2        side {
+            ray.x != 0.0f ? ( ray.x < 0.0f ? view.position.x - static_cast<float>( cell.x ) : static_cast<float>( cell.x + 1 ) - view.position.x ) * delta.x : infinity,
+            ray.y != 0.0f ? ( ray.y < 0.0f ? view.position.y - static_cast<float>( cell.y ) : static_cast<float>( cell.y + 1 ) - view.position.y ) * delta.y : infinity,
+        };
+
+        float distance = infinity;
+        bool  ySide    = false;
+        int   wall     = -1;
+
+        while ( true )
+        {
+            if ( side.x < side.y )
+            {
+                cell.x += step.x;
+                side.x += delta.x;
+                ySide = false;
+            }
+            else
+            {
+                cell.y += step.y;
+                side.y += delta.y;
+                ySide = true;
+            }
+
+            // Leaving the tile map towards the outside: there is no wall in this column.
+            if ( ( cell.x < 0 && step.x < 0 ) || ( cell.x >= columns && step.x > 0 ) || ( cell.y < 0 && step.y < 0 ) || ( cell.y >= rows && step.y > 0 ) )
+                break;
+
+            if ( cell.x < 0 || cell.y < 0 || cell.x >= columns || cell.y >= rows )
+                continue;
+
+            wall = view.walls.getSpriteId( static_cast<size_t>( cell.x ), static_cast<size_t>( cell.y ) );
+            if ( wall >= 0 )
+            {
+                // Limit the distance, so the height of walls right in front of the camera stays finite.
+                distance = std::max( ySide ? side.y - delta.y : side.x - delta.x, 1.0f / 1024.0f );
+                break;
+            }
+        }
+
+        // The rows covered by the wall (pixels whose center is between the top and the bottom of the wall).
+        // Without a wall, everything below the horizon is floor, and everything above is ceiling.
+        const float height    = wall >= 0 ? view.focalLength / distance : 0.0f;
+        const float wallTop   = view.horizon - height * 0.5f;
+        const float maxRow    = static_cast<float>( view.image.getHeight() );
+        const int   wallFirst = static_cast<int>( std::ceil( std::clamp( wallTop - 0.5f, -1.0f, maxRow ) ) );
+        const int   wallLast  = static_cast<int>( std::ceil( std::clamp( wallTop + height - 0.5f, -1.0f, maxRow ) ) ) - 1;
+
+        if ( wall >= 0 && wallTexture.load( wallSprites, wall ) )
+        {
+            // The position of the hit along the wall, mirrored so that textures are not flipped on the opposite faces of a cell.
+            const float hit = ySide ? view.position.x + distance * ray.x : view.position.y + distance * ray.y;
+            int         u   = static_cast<int>( ( hit - std::floor( hit ) ) * static_cast<float>( wallTexture.width ) );
+            u               = std::clamp( u, 0, wallTexture.width - 1 );
+
+            if ( ( !ySide && ray.x < 0.0f ) || ( ySide && ray.y > 0.0f ) )
+                u = wallTexture.width - 1 - u;
+
+            const int        y0 = std::max( wallFirst, view.top );
+            const int        y1 = std::min( wallLast, view.bottom );
+            const float      dv = static_cast<float>( wallTexture.height ) / height;
+            const Fixed16_16 step16 { dv };
+            Fixed16_16       v { ( static_cast<float>( y0 ) + 0.5f - wallTop ) * dv };
+
+            for ( int y = y0; y <= y1; ++y )
+            {
+                const int iv = std::clamp( v.floor(), 0, wallTexture.height - 1 );
+
+                pixels[static_cast<size_t>( y ) * stride + x] = wallTexture.fetch( u, iv );
+                v += step16;
+            }
+        }
+
+        // Floor and ceiling casting: the distance of every row is precomputed, so the position on the floor is a multiply-add.
+        auto drawPlane = [&]( const TileMap* tileMap, CellTexture& texture, int y0, int y1 ) {
+            if ( !tileMap )
+                return;
+
+            const auto& sprites = *tileMap->getSpriteSheet();
+
+            for ( int y = std::max( y0, view.top ); y <= std::min( y1, view.bottom ); ++y )
+            {
+                const glm::vec2 p  = view.position + ray * view.rowDistance[y];
+                const int       id = getCell( *tileMap, p );
+
+                if ( !texture.load( sprites, id ) )
+                    continue;
+
+                const int u = std::min( static_cast<int>( ( p.x - std::floor( p.x ) ) * static_cast<float>( texture.width ) ), texture.width - 1 );
+                const int v = std::min( static_cast<int>( ( p.y - std::floor( p.y ) ) * static_cast<float>( texture.height ) ), texture.height - 1 );
+
+                pixels[static_cast<size_t>( y ) * stride + x] = texture.fetch( u, v );
+            }
+        };
+
+        drawPlane( view.ceiling, ceilingTexture, view.top, wallFirst - 1 );
+        drawPlane( view.floor, floorTexture, wallLast + 1, view.bottom );
+    }
+}
+}  // namespace
+
 void Rasterizer::clear( const Color& color )
 {
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
     if ( Image* image = state.colorTarget )
         image->clear( color );
 }
 
-void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y )
+void Rasterizer::resolve()
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    if ( state.multisampleTarget && state.colorTarget )
+        state.multisampleTarget->resolve( *state.colorTarget );
+}
+
+void Rasterizer::drawSprite( const Sprite& sprite, int x, int y )
 {
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    drawSprite( sprite, x, y, SourceColorShader {} );
+}
+
+void Rasterizer::drawSprite( const Sprite& sprite, const glm::mat3& transform )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
     const Image* srcImage = sprite.getImage().get();
     Image*       dstImage = state.colorTarget;
 
@@ -19,43 +615,432 @@ void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y )
 
     const Color      color     = sprite.getColor();
     const BlendMode  blendMode = sprite.getBlendMode();
-    const AABB       clipAABB  = AABB::fromRect( state.clipRect );
-    const AABB       dstAABB   = dstImage->getAABB().clamped( clipAABB );
     const glm::ivec2 size      = sprite.getSize();
-    glm::ivec2       uv        = sprite.getUV();
+    const glm::ivec2 uv        = sprite.getUV();
+
+    // The linear part and the translation of the transform (glm matrices are column-major).
+    const float a   = transform[0][0];
+    const float b   = transform[1][0];
+    const float c   = transform[0][1];
+    const float d   = transform[1][1];
+    const float tx  = transform[2][0];
+    const float ty  = transform[2][1];
+    const float det = a * d - b * c;
+
+    if ( det == 0.0f || size.x <= 0 || size.y <= 0 )
+        return;
+
+    // Transform the corners of the sprite to positions on the color target.
+    auto toTarget = [&]( int x, int y ) {
+        const auto fx = static_cast<float>( x );
+        const auto fy = static_cast<float>( y );
+        return glm::vec2 { a * fx + b * fy + tx, c * fx + d * fy + ty };
+    };
+
+    const glm::vec2 corners[] = { toTarget( 0, 0 ), toTarget( size.x, 0 ), toTarget( 0, size.y ), toTarget( size.x, size.y ) };
+
+    // The corners are converted to 28.4 fixed-point, skip sprites that are transformed out of its range.
+    for ( const glm::vec2& corner: corners )
+    {
+        if ( !Fixed28_4::isRepresentable( corner.x ) || !Fixed28_4::isRepresentable( corner.y ) )
+            return;
+    }
+
+    FixedAABB_28_4 bounds { FixedVec2_28_4 { corners[0] }, FixedVec2_28_4 { corners[1] } };
+    bounds.expand( FixedVec2_28_4 { corners[2] } ).expand( FixedVec2_28_4 { corners[3] } );
 
     // Compute viewport clipping bounds.
-    const int clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), _x );
-    const int clipTop    = std::max( static_cast<int>( dstAABB.min.y ), _y );
-    const int clipRight  = std::min( static_cast<int>( dstAABB.max.x ), _x + size.x - 1 );
-    const int clipBottom = std::min( static_cast<int>( dstAABB.max.y ), _y + size.y - 1 );
+    const AABB  dstAABB    = dstImage->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+    const RectI pixels     = bounds.getPixelRect();
+    const int   clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), pixels.left );
+    const int   clipTop    = std::max( static_cast<int>( dstAABB.min.y ), pixels.top );
+    const int   clipRight  = std::min( static_cast<int>( dstAABB.max.x ), pixels.right() - 1 );
+    const int   clipBottom = std::min( static_cast<int>( dstAABB.max.y ), pixels.bottom() - 1 );
 
-    // Check if the sprite is completely off-screen.
-    if ( clipLeft >= clipRight || clipTop >= clipBottom )
+    if ( clipLeft > clipRight || clipTop > clipBottom )
         return;
 
-    // Adjust sprite UV based on clipping.
-    uv.x += clipLeft - _x;
-    uv.y += clipTop - _y;
+    // The inverse transform maps pixel centers back to sprite space. Its gradients are constant,
+    // so the texture coordinates are stepped across the pixels instead of transforming every pixel.
+    auto toSprite = [&]( int x, int y ) {
+        const float px = static_cast<float>( x ) + 0.5f - tx;
+        const float py = static_cast<float>( y ) + 0.5f - ty;
+        return glm::vec2 { ( d * px - b * py ) / det, ( a * py - c * px ) / det };
+    };
+
+    // The texture coordinates are stepped in 16.16 fixed-point. An affine function is extreme at the corners of a rectangle,
+    // so the coordinates stay in range if they do at the corners of the clipped bounds. Half of the range is used so
+    // the rounding errors of the steps can't overflow it. This also rejects extreme scales (and near singular transforms).
+    constexpr float maxCoord = 16384.0f;
+
+    const glm::vec2 texCoords[] = { toSprite( clipLeft, clipTop ), toSprite( clipRight, clipTop ), toSprite( clipLeft, clipBottom ), toSprite( clipRight, clipBottom ) };
+    for ( const glm::vec2& texCoord: texCoords )
+    {
+        if ( !( std::abs( texCoord.x ) < maxCoord && std::abs( texCoord.y ) < maxCoord ) )
+            return;
+    }
+
+    if ( !( std::abs( d / det ) < maxCoord && std::abs( c / det ) < maxCoord && std::abs( b / det ) < maxCoord && std::abs( a / det ) < maxCoord ) )
+        return;
+
+    const float      px   = static_cast<float>( clipLeft ) + 0.5f - tx;
+    const float      py   = static_cast<float>( clipTop ) + 0.5f - ty;
+    const Fixed16_16 dudx { d / det };
+    const Fixed16_16 dvdx { -c / det };
+    const Fixed16_16 dudy { -b / det };
+    const Fixed16_16 dvdy { a / det };
+    Fixed16_16       rowU { ( d * px - b * py ) / det };
+    Fixed16_16       rowV { ( a * py - c * px ) / det };
 
     const Color* src = srcImage->data();
     Color*       dst = dstImage->data();
 
-    int sW = srcImage->getWidth();  // Source image width.
-    int dW = dstImage->getWidth();  // Destination image width.
+    int sS = srcImage->getStride();  // Source image stride.
+    int dS = dstImage->getStride();  // Destination image stride.
 
     for ( int y = clipTop; y <= clipBottom; ++y )
     {
+        Fixed16_16 u = rowU;
+        Fixed16_16 v = rowV;
+
         for ( int x = clipLeft; x <= clipRight; ++x )
         {
-            // Compute clipped UV sprite texture coordinates.
-            int u = uv.x + ( x - clipLeft );
-            int v = uv.y + ( y - clipTop );
+            const int iu = u.floor();
+            const int iv = v.floor();
+
+            // Skip the pixels of the bounds that are outside of the sprite (negative coordinates wrap to large unsigned values).
+            if ( static_cast<uint32_t>( iu ) < static_cast<uint32_t>( size.x ) && static_cast<uint32_t>( iv ) < static_cast<uint32_t>( size.y ) )
+            {
+                Color sC = src[( uv.y + iv ) * sS + uv.x + iu] * color;
+                Color dC = dst[y * dS + x];
+
+                dst[y * dS + x] = blendMode.Blend( sC, dC );
+            }
+
+            u += dudx;
+            v += dvdx;
+        }
+
+        rowU += dudy;
+        rowV += dvdy;
+    }
+}
+
+void Rasterizer::drawTileMap( const TileMap& tileMap, int x, int y )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    const auto spriteSheet = tileMap.getSpriteSheet();
+    if ( !spriteSheet || !state.colorTarget )
+        return;
+
+    const int  tileWidth  = static_cast<int>( tileMap.getSpriteWidth() );
+    const int  tileHeight = static_cast<int>( tileMap.getSpriteHeight() );
+    const AABB dstAABB    = state.colorTarget->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+
+    const auto visibleTiles = getVisibleTiles( dstAABB, x, y, static_cast<int>( tileMap.getColumns() ), static_cast<int>( tileMap.getRows() ), tileWidth, tileHeight );
+    if ( !visibleTiles )
+        return;
+
+    const auto [first, last] = *visibleTiles;
+
+    for ( int row = first.y; row <= last.y; ++row )
+    {
+        tileMap.forEachInRow( row, first.x, last.x, [&]( size_t column, int spriteId ) {
+            if ( spriteId >= 0 )
+                drawSprite( spriteSheet->getSprite( spriteId ), x + static_cast<int>( column ) * tileWidth, y + row * tileHeight );
+        } );
+    }
+}
+
+void Rasterizer::drawTileMap( const CompressedTileMap& tileMap, int x, int y )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    const auto spriteSheet = tileMap.getSpriteSheet();
+    if ( !spriteSheet || !state.colorTarget )
+        return;
+
+    const int  tileWidth  = static_cast<int>( tileMap.getSpriteWidth() );
+    const int  tileHeight = static_cast<int>( tileMap.getSpriteHeight() );
+    const AABB dstAABB    = state.colorTarget->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+
+    const auto visibleTiles = getVisibleTiles( dstAABB, x, y, static_cast<int>( tileMap.getColumns() ), static_cast<int>( tileMap.getRows() ), tileWidth, tileHeight );
+    if ( !visibleTiles )
+        return;
+
+    const auto [first, last] = *visibleTiles;
+
+    for ( int row = first.y; row <= last.y; ++row )
+    {
+        for ( const TileRun& run: tileMap.getRow( row ) )
+        {
+            if ( std::cmp_greater( run.column, last.x ) )
+                break;  // Runs are sorted by column, the remaining runs are not visible.
+
+            const int runFirst = std::max<int>( run.column, first.x );
+            const int runLast  = std::min<int>( run.column + run.length - 1, last.x );
+
+            if ( run.spriteId < 0 || runFirst > runLast )
+                continue;
+
+            const Sprite& sprite = spriteSheet->getSprite( run.spriteId );
+            for ( int column = runFirst; column <= runLast; ++column )
+                drawSprite( sprite, x + column * tileWidth, y + row * tileHeight );
+        }
+    }
+}
+
+void Rasterizer::drawTiledImage( const Image& image, const glm::ivec2& scrollOffset, const RectI& destRect, const BlendMode& blendMode )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    Image* dstImage = state.colorTarget;
+    if ( !image || !dstImage )
+        return;
+
+    const AABB dstAABB = dstImage->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+    const int  left    = std::max( static_cast<int>( dstAABB.min.x ), destRect.left );
+    const int  top     = std::max( static_cast<int>( dstAABB.min.y ), destRect.top );
+    const int  right   = std::min( static_cast<int>( dstAABB.max.x ), destRect.right() - 1 );
+    const int  bottom  = std::min( static_cast<int>( dstAABB.max.y ), destRect.bottom() - 1 );
+
+    if ( left > right || top > bottom )
+        return;
+
+    const Color* src = image.data();
+    Color*       dst = dstImage->data();
+
+    const int sW = image.getWidth();
+    const int sH = image.getHeight();
+    const int sS = image.getStride();
+    const int dS = dstImage->getStride();
+
+    // The column of the image at the first pixel of every row.
+    const int firstU = fast_mod_signed( left - destRect.left + scrollOffset.x, sW );
+
+    for ( int y = top; y <= bottom; ++y )
+    {
+        const Color* srcRow = src + static_cast<size_t>( fast_mod_signed( y - destRect.top + scrollOffset.y, sH ) ) * sS;
+        Color*       dstRow = dst + static_cast<size_t>( y ) * dS;
+
+        // Copy the row in segments that end at the right edge of the image, so the wrapping is only resolved between segments.
+        int u = firstU;
+        for ( int x = left; x <= right; )
+        {
+            const int count = std::min( sW - u, right - x + 1 );
 
-            Color sC = src[v * sW + u] * color;
-            Color dC = dst[y * dW + x];
+            if ( blendMode.blendEnable )
+            {
+                for ( int i = 0; i < count; ++i )
+                    dstRow[x + i] = blendMode.Blend( srcRow[u + i], dstRow[x + i] );
+            }
+            else
+            {
+                std::memcpy( dstRow + x, srcRow + u, count * sizeof( Color ) );
+            }
 
-            dst[y * dW + x] = blendMode.Blend( sC, dC );
+            x += count;
+            u = 0;
         }
     }
+}
+
+void Rasterizer::drawParallaxLayers( std::span<const ParallaxLayer> layers, const glm::vec2& camera, const RectI& destRect )
+{
+    for ( const ParallaxLayer& layer: layers )
+    {
+        if ( layer.image )
+            drawTiledImage( *layer.image, layer.getScrollOffset( camera ), destRect, layer.blendMode );
+    }
+}
+
+void Rasterizer::drawAffineScanlines( const Image& image, std::span<const AffineScanline> scanlines, int top, const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    Image* dstImage = state.colorTarget;
+    if ( !image || !dstImage )
+        return;
+
+    const AABB dstAABB = dstImage->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+    const int  left    = static_cast<int>( dstAABB.min.x );
+    const int  right   = static_cast<int>( dstAABB.max.x );
+    const int  first   = std::max( static_cast<int>( dstAABB.min.y ), top );
+    const int  last    = std::min( static_cast<int>( dstAABB.max.y ), top + static_cast<int>( scanlines.size() ) - 1 );
+
+    if ( left > right )
+        return;
+
+    for ( int y = first; y <= last; ++y )
+        drawScanline( image, *dstImage, y, left, right, scanlines[y - top], samplerState, blendMode );
+}
+
+void Rasterizer::drawAffineScanlines( const Image& image, const PlaneCamera& camera, const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    Image* dstImage = state.colorTarget;
+    if ( !image || !dstImage )
+        return;
+
+    const AABB dstAABB = dstImage->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+    const int  left    = static_cast<int>( dstAABB.min.x );
+    const int  right   = static_cast<int>( dstAABB.max.x );
+
+    if ( left > right )
+        return;
+
+    for ( int y = static_cast<int>( dstAABB.min.y ); y <= static_cast<int>( dstAABB.max.y ); ++y )
+    {
+        if ( const auto scanline = camera.getScanline( y ) )
+            drawScanline( image, *dstImage, y, left, right, *scanline, samplerState, blendMode );
+    }
+}
+
+void Rasterizer::drawRaycast( const TileMap& walls, const RaycastCamera& camera, const TileMap* floor, const TileMap* ceiling, unsigned numThreads )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    Image* dstImage = state.colorTarget;
+    if ( !dstImage || !*dstImage || !walls.getSpriteSheet() )
+        return;
+
+    assert( !floor || ( floor->getSpriteSheet() && floor->getColumns() == walls.getColumns() && floor->getRows() == walls.getRows() ) );
+    assert( !ceiling || ( ceiling->getSpriteSheet() && ceiling->getColumns() == walls.getColumns() && ceiling->getRows() == walls.getRows() ) );
+
+    const AABB dstAABB = dstImage->getAABB().clamped( AABB::fromRect( state.clipRect ) );
+    const int  left    = static_cast<int>( dstAABB.min.x );
+    const int  right   = static_cast<int>( dstAABB.max.x );
+    const int  top     = static_cast<int>( dstAABB.min.y );
+    const int  bottom  = static_cast<int>( dstAABB.max.y );
+
+    if ( left > right || top > bottom )
+        return;
+
+    // The plane spans the width of the color target.
+    const float focalLength = static_cast<float>( dstImage->getWidth() ) * 0.5f / std::tan( camera.fieldOfView * 0.5f );
+    const float horizon     = static_cast<float>( dstImage->getHeight() ) * 0.5f;
+
+    // The eye is halfway between the floor and the ceiling, so a row at a distance dy from the horizon sees the floor
+    // (or the ceiling) at a distance of 0.5 * focalLength / dy.
+    m_RowDistance.resize( dstImage->getHeight() );
+    for ( int y = 0; y < dstImage->getHeight(); ++y )
+        m_RowDistance[y] = 0.5f * focalLength / std::abs( static_cast<float>( y ) + 0.5f - horizon );
+
+    const RaycastView view { walls, floor, ceiling, *dstImage, camera.position, camera.getDirection(), camera.getPlane(), focalLength, horizon, top, bottom, m_RowDistance };
+
+    // Split the columns into a contiguous range per thread. The calling thread draws the first range.
+    const int numColumns = right - left + 1;
+    const int numRanges  = std::clamp( static_cast<int>( numThreads ), 1, numColumns );
+
+    auto drawRange = [&view, left, numColumns, numRanges]( uint32_t i ) {
+        const int first = left + numColumns * static_cast<int>( i ) / numRanges;
+        const int last  = left + numColumns * ( static_cast<int>( i ) + 1 ) / numRanges - 1;
+
+        drawRaycastColumns( view, first, last );
+    };
+
+    if ( numRanges > 1 )
+    {
+        // The worker threads are started by the first multithreaded draw, and are kept for the next frames.
+        if ( !m_Workers )
+            m_Workers = std::make_unique<WorkerPool>();
+
+        m_Workers->run( static_cast<uint32_t>( numRanges ), drawRange );
+    }
+    else
+    {
+        drawRange( 0 );
+    }
+}
+
+void Rasterizer::drawTriangles( const VertexProcessor& vertices, std::span<const uint32_t> indices, const Color& color, const BlendMode& blendMode )
+{
+    drawTriangles( vertices, VertexAttributes {}, indices, ConstantColorShader { color }, nullptr, SamplerState {}, blendMode );
+}
+
+void Rasterizer::drawTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, const Image* texture, const SamplerState& samplerState,
+                                const BlendMode& blendMode )
+{
+    drawTriangles( vertices, attributes, indices, SourceColorShader {}, texture, samplerState, blendMode );
+}
+
+void Rasterizer::drawIndexed( VertexProcessor& vertices, const Mesh& mesh, const Image* texture, const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    drawIndexed( vertices, mesh, SourceColorShader {}, texture, samplerState, blendMode );
+}
+
+void Rasterizer::rasterizeTriangles( const VertexProcessor& vertices, const VertexAttributes& attributes, std::span<const uint32_t> indices, SpanFunc spanFunc, void* context )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::Rasterizer };
+
+    Image* dstImage = state.colorTarget;
+    if ( !dstImage )
+        return;
+
+    [[maybe_unused]] const DepthBuffer*       depthTarget       = state.depthTarget;
+    [[maybe_unused]] const MultisampleTarget* multisampleTarget = state.multisampleTarget;
+    assert( !depthTarget || ( depthTarget->getWidth() == dstImage->getWidth() && depthTarget->getHeight() == dstImage->getHeight() ) );
+    assert( !multisampleTarget || ( multisampleTarget->getWidth() == dstImage->getWidth() && multisampleTarget->getHeight() == dstImage->getHeight() ) );
+
+    std::vector<uint8_t>* coverage = state.multisampleTarget ? &m_Coverage : nullptr;
+
+    const auto scissor = getScissor( *dstImage, state.clipRect, vertices.getViewport() );
+    if ( !scissor )
+        return;
+
+    const auto [scissorMin, scissorMax] = *scissor;
+
+    // The attributes of a vertex: u, v, r, g, b, a.
+    using Attributes = std::array<float, 6>;
+
+    auto fetch = [&]( uint32_t i ) {
+        const glm::vec2 uv = attributes.u.empty() ? glm::vec2 { 0.0f } : glm::vec2 { attributes.u[i], attributes.v[i] };
+        const Color     c  = attributes.color.empty() ? Color::White : attributes.color[i];
+
+        return Attributes {
+            uv.x, uv.y, static_cast<float>( c.channels.r ), static_cast<float>( c.channels.g ), static_cast<float>( c.channels.b ), static_cast<float>( c.channels.a ),
+        };
+    };
+
+    forEachTriangle( vertices, indices, [&]( uint32_t i0, uint32_t i1, uint32_t i2, const TriangleVertex& t0, const TriangleVertex& t1, const TriangleVertex& t2 ) {
+        const Attributes a0 = fetch( i0 );
+        const Attributes a1 = fetch( i1 );
+        const Attributes a2 = fetch( i2 );
+
+        // The attributes divided by w and 1/w are linear in screen space, the attributes themselves are not.
+        // The vertices created by clipping blend the attributes of the original vertices (which is linear in clip space).
+        auto setup = [&]( const TriangleVertex& t ) {
+            std::array<float, 7> q;
+            for ( size_t k = 0; k < 6; ++k )
+                q[k] = ( t.weights.x * a0[k] + t.weights.y * a1[k] + t.weights.z * a2[k] ) * t.screen.w;
+
+            q[6] = t.screen.w;
+            return q;
+        };
+
+        const std::array<float, 7> q0 = setup( t0 );
+        const std::array<float, 7> q1 = setup( t1 );
+        const std::array<float, 7> q2 = setup( t2 );
+
+        rasterizeTriangle( toFixed( t0.screen ), toFixed( t1.screen ), toFixed( t2.screen ), state.cullMode, scissorMin, scissorMax, coverage,
+                           [&]( int y, int first, int last, const glm::vec3& b, const glm::vec3& dbdx, const glm::vec3& dbdy ) {
+                               TriangleSpan span { y, first, last, {}, {}, 0.0f, 0.0f, 0.0f, coverage ? coverage->data() : nullptr };
+
+                               // The interpolants at the first pixel of the span, and their change per pixel.
+                               for ( size_t k = 0; k < 7; ++k )
+                               {
+                                   span.q[k]  = b.x * q0[k] + b.y * q1[k] + b.z * q2[k];
+                                   span.dq[k] = dbdx.x * q0[k] + dbdx.y * q1[k] + dbdx.z * q2[k];
+                               }
+
+                               // The depth (z/w) is linear in screen space.
+                               span.z    = b.x * t0.screen.z + b.y * t1.screen.z + b.z * t2.screen.z;
+                               span.dz   = dbdx.x * t0.screen.z + dbdx.y * t1.screen.z + dbdx.z * t2.screen.z;
+                               span.dzdy = dbdy.x * t0.screen.z + dbdy.y * t1.screen.z + dbdy.z * t2.screen.z;
+
+                               spanFunc( context, span );
+                           } );
+    } );
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include <graphics/RenderTargetPool.hpp>
+
+#include <cassert>
+#include <utility>  // For std::cmp_equal
+#include <vector>   // For std::erase_if
+
+using namespace cpprast::graphics;
+
+Image& RenderTargetPool::acquire( uint32_t width, uint32_t height )
+{
+    for ( auto& target: m_Targets )
+    {
+        if ( !target->inUse && std::cmp_equal( target->image.getWidth(), width ) && std::cmp_equal( target->image.getHeight(), height ) )
+        {
+            target->inUse     = true;
+            target->lastFrame = m_Frame;
+            return target->image;
+        }
+    }
+
+    auto& target      = m_Targets.emplace_back( std::make_unique<Target>() );
+    target->image     = Image { width, height, {}, ImageLayout::Padded };
+    target->inUse     = true;
+    target->lastFrame = m_Frame;
+
+    return target->image;
+}
+
+void RenderTargetPool::release( const Image& image ) noexcept
+{
+    for ( auto& target: m_Targets )
+    {
+        if ( &target->image == &image )
+        {
+            assert( target->inUse );
+            target->inUse = false;
+            return;
+        }
+    }
+
+    assert( false && "The image was not acquired from this pool." );
+}
+
+void RenderTargetPool::endFrame()
+{
+    for ( auto& target: m_Targets )
+        target->inUse = false;
+
+    std::erase_if( m_Targets, [this]( const auto& target ) { return m_Frame - target->lastFrame >= m_MaxIdleFrames; } );
+
+    ++m_Frame;
+}
+
+void RenderTargetPool::trim()
+{
+    std::erase_if( m_Targets, []( const auto& target ) { return !target->inUse; } );
+}
+
+size_t RenderTargetPool::getMemoryUsage() const noexcept
+{
+    size_t size = 0;
+    for ( const auto& target: m_Targets )
+        size += static_cast<size_t>( target->image.getPitch() ) * target->image.getHeight();
+
+    return size;
+}
@@ -1,9 +1,13 @@
+#include <graphics/AllocationTracker.hpp>
 #include <graphics/ResourceManager.hpp>
 #include <hash.hpp>
 
+#include <algorithm>  // For std::max
+#include <fstream>
 #include <unordered_map>
 
 using namespace cpprast::graphics;
+using namespace cpprast::math;
 
 struct FontKey
 {
@@ -31,19 +35,78 @@ struct std::hash<FontKey>
     }
 };
 
+struct CollisionMaskKey
+{
+    const Image* image;
+    RectI        rect;
+    uint8_t      alphaThreshold;
+
+    bool operator==( const CollisionMaskKey& other ) const
+    {
+        return image == other.image && rect == other.rect && alphaThreshold == other.alphaThreshold;
+    }
+};
+
+// Hasher for a CollisionMaskKey.
+template<>
+struct std::hash<CollisionMaskKey>
+{
+    size_t operator()( const CollisionMaskKey& key ) const noexcept
+    {
+        std::size_t seed = 0;
+
+        hash_combine( seed, key.image );
+        hash_combine( seed, key.rect.left );
+        hash_combine( seed, key.rect.top );
+        hash_combine( seed, key.rect.width );
+        hash_combine( seed, key.rect.height );
+        hash_combine( seed, key.alphaThreshold );
+
+        return seed;
+    }
+};
+
 namespace
 {
 
 // Image store.
 std::unordered_map<std::filesystem::path, std::shared_ptr<Image>> g_ImageMap;
 
+// Collision mask store.
+// The image is referenced weakly: if the image is destroyed, another image could be allocated at the same address.
+struct CollisionMaskEntry
+{
+    std::weak_ptr<Image>                 image;
+    std::shared_ptr<const CollisionMask> mask;
+};
+
+std::unordered_map<CollisionMaskKey, CollisionMaskEntry> g_CollisionMaskMap;
+size_t                                                   g_CollisionMaskSweepSize = 64u;  // Evict the masks of destroyed images when the store grows to this size.
+
 // Font store.
 // std::unordered_map<FontKey, std::shared_ptr<Font>> g_FontMap;
 
 }  // namespace
 
+std::optional<std::string> ResourceManager::readFile( const std::filesystem::path& filePath )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::ResourceManager };
+
+    std::ifstream file( filePath, std::ios::binary | std::ios::ate );
+    if ( !file )
+        return {};
+
+    std::string contents( static_cast<size_t>( file.tellg() ), '\0' );
+    file.seekg( 0 );
+    file.read( contents.data(), static_cast<std::streamsize>( contents.size() ) );
+
+    return contents;
+}
+
 std::shared_ptr<Image> ResourceManager::loadImage( const std::filesystem::path& filePath )
 {
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::ResourceManager };
+
     const auto iter = g_ImageMap.find( filePath );
 
     if ( iter == g_ImageMap.end() )
@@ -58,6 +121,37 @@ std::shared_ptr<Image> ResourceManager::loadImage( const std::filesystem::path&
     return iter->second;
 }
 
+std::shared_ptr<const CollisionMask> ResourceManager::getCollisionMask( const Sprite& sprite, uint8_t alphaThreshold )
+{
+    const AllocationTracker::SubsystemScope tracking { AllocationTracker::Subsystem::ResourceManager };
+
+    static const auto emptyMask = std::make_shared<const CollisionMask>();
+
+    const auto image = sprite.getImage();
+    if ( !image )
+        return emptyMask;
+
+    const CollisionMaskKey key { image.get(), sprite.getRect(), alphaThreshold };
+
+    // Images can be destroyed at any time, so their masks are evicted when the store grows.
+    // The next sweep happens when the store has doubled, so the cost of sweeping is amortized over the insertions.
+    if ( g_CollisionMaskMap.size() >= g_CollisionMaskSweepSize && !g_CollisionMaskMap.contains( key ) )
+    {
+        std::erase_if( g_CollisionMaskMap, []( const auto& item ) { return item.second.image.expired(); } );
+        g_CollisionMaskSweepSize = std::max<size_t>( 64u, g_CollisionMaskMap.size() * 2 );
+    }
+
+    CollisionMaskEntry& entry = g_CollisionMaskMap[key];
+
+    if ( !entry.mask || entry.image.lock() != image )
+    {
+        entry.image = image;
+        entry.mask  = std::make_shared<const CollisionMask>( *image, sprite.getRect(), alphaThreshold );
+    }
+
+    return entry.mask;
+}
+
 /**
 
 std::shared_ptr<SpriteSheet> ResourceManager::loadSpriteSheet( const std::filesystem::path& filePath, std::optional<int> spriteWidth, std::optional<int> spriteHeight, int padding, int margin, const BlendMode& blendMode )
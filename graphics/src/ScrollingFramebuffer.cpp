@@ -0,0 +1,102 @@
+#include <graphics/ScrollingFramebuffer.hpp>
+
+#include <algorithm>  // For std::min, std::max, std::fill_n
+#include <cstdlib>    // For std::abs
+#include <cstring>    // For std::memmove
+#include <utility>    // For std::swap
+
+using namespace cpprast::graphics;
+using namespace cpprast::math;
+
+void ScrollingFramebuffer::addDynamicRegion( const RectI& worldRect )
+{
+    if ( worldRect.width > 0 && worldRect.height > 0 )
+        m_DynamicRegions.push_back( worldRect );
+}
+
+void ScrollingFramebuffer::update( Image& image, const glm::ivec2& cameraPosition )
+{
+    const glm::ivec2 size { image.getWidth(), image.getHeight() };
+    const glm::ivec2 delta   = cameraPosition - m_CameraPosition;
+    const bool       resized = size != m_Size;
+
+    m_DirtyRegions.clear();
+    m_Size = size;
+
+    if ( !m_Valid || resized || std::abs( delta.x ) >= size.x || std::abs( delta.y ) >= size.y )
+    {
+        // Nothing of the previous frame can be reused.
+        addDirtyRegion( RectI { 0, 0, size.x, size.y } );
+    }
+    else
+    {
+        if ( delta != glm::ivec2 { 0 } )
+        {
+            // The pixel at (x, y) shows what was at (x + dx, y + dy) in the previous frame. The rows are moved in the order
+            // that does not overwrite rows that are still to be moved, memmove handles the overlap within a row.
+            const int    width  = size.x - std::abs( delta.x );
+            const int    height = size.y - std::abs( delta.y );
+            const int    srcX   = std::max( delta.x, 0 );
+            const int    dstX   = std::max( -delta.x, 0 );
+            const int    srcY   = std::max( delta.y, 0 );
+            const int    dstY   = std::max( -delta.y, 0 );
+            const size_t stride = static_cast<size_t>( image.getStride() );
+            Color*       pixels = image.data();
+
+            for ( int i = 0; i < height; ++i )
+            {
+                const int row = delta.y >= 0 ? i : height - 1 - i;
+                std::memmove( pixels + ( dstY + row ) * stride + dstX, pixels + ( srcY + row ) * stride + srcX, width * sizeof( Color ) );
+            }
+
+            // The strips that scrolled into view. The corner is only added once, with the horizontal strip.
+            if ( delta.y > 0 )
+                addDirtyRegion( RectI { 0, size.y - delta.y, size.x, delta.y } );
+            else if ( delta.y < 0 )
+                addDirtyRegion( RectI { 0, 0, size.x, -delta.y } );
+
+            if ( delta.x > 0 )
+                addDirtyRegion( RectI { size.x - delta.x, dstY, delta.x, height } );
+            else if ( delta.x < 0 )
+                addDirtyRegion( RectI { 0, dstY, -delta.x, height } );
+        }
+
+        // Erase the dynamic objects of the previous frame, and draw them at their current position.
+        for ( const RectI& r: m_PreviousDynamicRegions )
+            addDirtyRegion( RectI { r.left - cameraPosition.x, r.top - cameraPosition.y, r.width, r.height } );
+
+        for ( const RectI& r: m_DynamicRegions )
+            addDirtyRegion( RectI { r.left - cameraPosition.x, r.top - cameraPosition.y, r.width, r.height } );
+    }
+
+    m_Valid          = true;
+    m_CameraPosition = cameraPosition;
+
+    std::swap( m_PreviousDynamicRegions, m_DynamicRegions );
+    m_DynamicRegions.clear();
+}
+
+void ScrollingFramebuffer::fill( Image& image, const RectUI& clipRect, const Color& color ) noexcept
+{
+    const AABB dstAABB = image.getAABB().clamped( AABB::fromRect( clipRect ) );
+    const int  left    = static_cast<int>( dstAABB.min.x );
+    const int  right   = static_cast<int>( dstAABB.max.x );
+    Color*     pixels  = image.data();
+
+    if ( left > right )
+        return;
+
+    for ( int y = static_cast<int>( dstAABB.min.y ); y <= static_cast<int>( dstAABB.max.y ); ++y )
+        std::fill_n( pixels + static_cast<size_t>( y ) * image.getStride() + left, right - left + 1, color );
+}
+
+void ScrollingFramebuffer::addDirtyRegion( RectI region )
+{
+    const int left   = std::max( region.left, 0 );
+    const int top    = std::max( region.top, 0 );
+    const int right  = std::min( region.right(), m_Size.x );
+    const int bottom = std::min( region.bottom(), m_Size.y );
+
+    if ( left < right && top < bottom )
+        m_DirtyRegions.emplace_back( left, top, right - left, bottom - top );
+}
@@ -0,0 +1,228 @@
+#include <graphics/TileCollisionMap.hpp>
+
+#include <glm/common.hpp>  // For glm::floor, glm::ceil, glm::sign
+
+#include <cmath>
+
+using namespace cpprast::graphics;
+
+namespace
+{
+/// <summary>
+/// Convert a (floating-point) tile coordinate to an integer.
+/// The coordinate is clamped to [lo ... hi] first to avoid overflow for points far outside the map.
+/// </summary>
+int toTile( float t, int lo, int hi ) noexcept
+{
+    return static_cast<int>( std::clamp( t, static_cast<float>( lo ), static_cast<float>( hi ) ) );
+}
+
+/// <summary>
+/// Compute the interval of time [tEnter ... tExit] that a moving interval [min ... max] overlaps a static interval [lo ... hi] along a single axis.
+/// </summary>
+/// <returns>false if the intervals never overlap.</returns>
+bool slab( float min, float max, float d, float lo, float hi, float& tEnter, float& tExit ) noexcept
+{
+    if ( d == 0.0f )
+    {
+        // No motion on this axis. The intervals must (strictly) overlap for the whole motion.
+        tEnter = -std::numeric_limits<float>::infinity();
+        tExit  = std::numeric_limits<float>::infinity();
+        return min < hi && max > lo;
+    }
+
+    const float invD = 1.0f / d;
+    if ( d > 0.0f )
+    {
+        tEnter = ( lo - max ) * invD;
+        tExit  = ( hi - min ) * invD;
+    }
+    else
+    {
+        tEnter = ( hi - min ) * invD;
+        tExit  = ( lo - max ) * invD;
+    }
+
+    return true;
+}
+}  // namespace
+
+glm::ivec2 TileCollisionMap::getTile( const glm::vec2& p ) const noexcept
+{
+    const glm::vec2 t = glm::floor( p / m_TileSize );
+
+    constexpr int limit = 1 << 30;
+    return { toTile( t.x, -limit, limit ), toTile( t.y, -limit, limit ) };
+}
+
+std::optional<std::pair<glm::ivec2, glm::ivec2>> TileCollisionMap::getTileRange( const AABB& aabb ) const noexcept
+{
+    const int columns = static_cast<int>( getColumns() );
+    const int rows    = static_cast<int>( getRows() );
+
+    // Tile i spans [i * size ... (i + 1) * size]. A tile is only included if the AABB strictly overlaps it.
+    const glm::vec2 first = glm::floor( aabb.min / m_TileSize );
+    const glm::vec2 last  = glm::ceil( aabb.max / m_TileSize ) - 1.0f;
+
+    const int x0 = toTile( first.x, 0, columns );
+    const int y0 = toTile( first.y, 0, rows );
+    const int x1 = toTile( last.x, -1, columns - 1 );
+    const int y1 = toTile( last.y, -1, rows - 1 );
+
+    if ( x0 > x1 || y0 > y1 )
+        return {};
+
+    return std::pair { glm::ivec2 { x0, y0 }, glm::ivec2 { x1, y1 } };
+}
+
+bool TileCollisionMap::overlaps( const AABB& aabb ) const noexcept
+{
+    const auto range = getTileRange( aabb );
+    if ( !range )
+        return false;
+
+    const auto [first, last] = *range;
+
+    return m_Solid.any( first.x, first.y, last.x, last.y );
+}
+
+size_t TileCollisionMap::overlap( const AABB& aabb, std::span<TileContact> contacts ) const noexcept
+{
+    const auto range = getTileRange( aabb );
+    if ( !range || contacts.empty() )
+        return 0;
+
+    const auto [first, last] = *range;
+
+    size_t count = 0;
+    m_Solid.forEachSet( first.x, first.y, last.x, last.y, [&]( uint32_t x, uint32_t y ) {
+        const glm::ivec2 tile { x, y };
+        if ( auto penetration = aabb.overlap( getTileAABB( tile.x, tile.y ) ) )
+            contacts[count++] = { tile, *penetration };
+
+        return count < contacts.size();
+    } );
+
+    return count;
+}
+
+std::optional<TileSweepHit> TileCollisionMap::sweep( const AABB& aabb, const glm::vec2& delta ) const noexcept
+{
+    // Only the tiles in the area covered by the motion can be hit.
+    AABB area = aabb;
+    area.expand( aabb + delta );
+
+    const auto range = getTileRange( area );
+    if ( !range )
+        return {};
+
+    const auto [first, last] = *range;
+
+    std::optional<TileSweepHit> hit;
+    float                       tMin = 1.0f;
+
+    m_Solid.forEachSet( first.x, first.y, last.x, last.y, [&]( uint32_t x, uint32_t y ) {
+        const glm::ivec2 tile { x, y };
+        const AABB       tileAABB = getTileAABB( tile.x, tile.y );
+
+        float txEnter, txExit, tyEnter, tyExit;
+        if ( !slab( aabb.min.x, aabb.max.x, delta.x, tileAABB.min.x, tileAABB.max.x, txEnter, txExit ) ||
+             !slab( aabb.min.y, aabb.max.y, delta.y, tileAABB.min.y, tileAABB.max.y, tyEnter, tyExit ) )
+            return true;
+
+        const float tEnter = std::max( txEnter, tyEnter );
+        const float tExit  = std::min( txExit, tyExit );
+
+        // Ignore tiles that are missed, only touched at a corner, already overlapping, or not closer than the current hit.
+        if ( tEnter >= tExit || tEnter < 0.0f || tEnter > tMin || ( hit && tEnter == tMin ) )
+            return true;
+
+        const glm::vec2 normal = txEnter > tyEnter ? glm::vec2 { -glm::sign( delta.x ), 0.0f } : glm::vec2 { 0.0f, -glm::sign( delta.y ) };
+
+        tMin = tEnter;
+        hit  = TileSweepHit { tile, tEnter, normal };
+
+        return true;
+    } );
+
+    return hit;
+}
+
+std::optional<TileRayHit> TileCollisionMap::raycast( const glm::vec2& origin, const glm::vec2& direction, float maxDistance ) const noexcept
+{
+    const float length = std::sqrt( direction.x * direction.x + direction.y * direction.y );
+    if ( length == 0.0f || m_Solid.getWidth() == 0 || m_Solid.getHeight() == 0 )
+        return {};
+
+    const glm::vec2 dir = direction / length;
+
+    // Clip the ray to the bounds of the map so that rays starting outside of the map don't walk empty tiles.
+    const AABB bounds { glm::vec2 { 0.0f }, glm::vec2 { static_cast<float>( getColumns() ), static_cast<float>( getRows() ) } * m_TileSize };
+
+    float txEnter, txExit, tyEnter, tyExit;
+    if ( dir.x == 0.0f && ( origin.x < bounds.min.x || origin.x >= bounds.max.x ) )
+        return {};
+    if ( dir.y == 0.0f && ( origin.y < bounds.min.y || origin.y >= bounds.max.y ) )
+        return {};
+
+    slab( origin.x, origin.x, dir.x, bounds.min.x, bounds.max.x, txEnter, txExit );
+    slab( origin.y, origin.y, dir.y, bounds.min.y, bounds.max.y, tyEnter, tyExit );
+
+    const float tStart = std::max( { txEnter, tyEnter, 0.0f } );
+    const float tEnd   = std::min( { txExit, tyExit, maxDistance } );
+
+    if ( tStart > tEnd )
+        return {};
+
+    // The normal of the face the ray entered the map through.
+    glm::vec2 normal { 0.0f };
+    if ( tStart > 0.0f )
+        normal = txEnter > tyEnter ? glm::vec2 { -glm::sign( dir.x ), 0.0f } : glm::vec2 { 0.0f, -glm::sign( dir.y ) };
+
+    const glm::vec2  start = origin + dir * tStart;
+    const glm::ivec2 step { glm::sign( dir ) };
+
+    glm::ivec2 tile = getTile( start );
+    tile.x          = std::clamp( tile.x, 0, static_cast<int>( getColumns() ) - 1 );
+    tile.y          = std::clamp( tile.y, 0, static_cast<int>( getRows() ) - 1 );
+
+    // The distance along the ray to the next vertical (x) and horizontal (y) tile boundary,
+    // and the distance along the ray between consecutive boundaries.
+    constexpr float inf = std::numeric_limits<float>::infinity();
+
+    const glm::vec2 tDelta { dir.x != 0.0f ? m_TileSize.x / std::abs( dir.x ) : inf,
+                             dir.y != 0.0f ? m_TileSize.y / std::abs( dir.y ) : inf };
+
+    glm::vec2 tMax { inf };
+    if ( dir.x != 0.0f )
+        tMax.x = ( ( static_cast<float>( tile.x + ( step.x > 0 ) ) * m_TileSize.x ) - origin.x ) / dir.x;
+    if ( dir.y != 0.0f )
+        tMax.y = ( ( static_cast<float>( tile.y + ( step.y > 0 ) ) * m_TileSize.y ) - origin.y ) / dir.y;
+
+    float t = tStart;
+    while ( t <= tEnd )
+    {
+        if ( m_Solid.get( tile.x, tile.y ) )
+            return TileRayHit { tile, t, origin + dir * t, normal };
+
+        if ( tMax.x < tMax.y )
+        {
+            t = tMax.x;
+            tile.x += step.x;
+            tMax.x += tDelta.x;
+            normal = { static_cast<float>( -step.x ), 0.0f };
+        }
+        else
+        {
+            t = tMax.y;
+            tile.y += step.y;
+            tMax.y += tDelta.y;
+            normal = { 0.0f, static_cast<float>( -step.y ) };
+        }
+
+        if ( tile.x < 0 || tile.y < 0 || tile.x >= static_cast<int>( getColumns() ) || tile.y >= static_cast<int>( getRows() ) )
+            break;
+    }
+
+    return {};
+}
@@ -1,36 +1,119 @@
 #include <graphics/TileMap.hpp>
 
-#include <algorithm>  // for std::ranges::fill
+#include <algorithm>  // for std::ranges::fill, std::ranges::max
 #include <cassert>
+#include <cstring>  // for std::memcpy
+#include <limits>
 
 using namespace cpprast::graphics;
 
-TileMap::TileMap( std::shared_ptr<SpriteSheet> spriteSheet, uint32_t columns, uint32_t rows )
+namespace
+{
+/// <summary>
+/// Get the size (in bytes) of a single cell.
+/// </summary>
+/// <param name="format">The storage format of the cells.</param>
+/// <returns>The size of a cell in bytes.</returns>
+constexpr size_t getCellSize( TileIndexFormat format ) noexcept
+{
+    switch ( format )
+    {
+    case TileIndexFormat::UInt8:
+        return sizeof( uint8_t );
+    case TileIndexFormat::UInt16:
+        return sizeof( uint16_t );
+    case TileIndexFormat::UInt32:
+        return sizeof( uint32_t );
+    }
+
+    return sizeof( uint32_t );
+}
+
+/// <summary>
+/// Decode the sprite index of the i'th cell of a packed sprite grid.
+/// </summary>
+template<typename T>
+int loadCell( const uint8_t* cells, size_t i ) noexcept
+{
+    T cell;
+    std::memcpy( &cell, cells + i * sizeof( T ), sizeof( T ) );
+    return static_cast<int>( cell ) - 1;
+}
+
+/// <summary>
+/// Encode a sprite index into the i'th cell of a packed sprite grid.
+/// </summary>
+template<typename T>
+void storeCell( uint8_t* cells, size_t i, int spriteId ) noexcept
+{
+    // The tile map widens its format before storing a sprite index that doesn't fit.
+    assert( spriteId >= -1 );
+    assert( static_cast<uint64_t>( spriteId ) + 1 <= std::numeric_limits<T>::max() );  // The sprite index doesn't fit in the cell format.
+
+    const auto cell = static_cast<T>( spriteId + 1 );
+    std::memcpy( cells + i * sizeof( T ), &cell, sizeof( T ) );
+}
+
+int loadCell( TileIndexFormat format, const uint8_t* cells, size_t i ) noexcept
+{
+    switch ( format )
+    {
+    case TileIndexFormat::UInt8:
+        return loadCell<uint8_t>( cells, i );
+    case TileIndexFormat::UInt16:
+        return loadCell<uint16_t>( cells, i );
+    case TileIndexFormat::UInt32:
+        return loadCell<uint32_t>( cells, i );
+    }
+
+    return -1;
+}
+
+void storeCell( TileIndexFormat format, uint8_t* cells, size_t i, int spriteId ) noexcept
+{
+    switch ( format )
+    {
+    case TileIndexFormat::UInt8:
+        storeCell<uint8_t>( cells, i, spriteId );
+        break;
+    case TileIndexFormat::UInt16:
+        storeCell<uint16_t>( cells, i, spriteId );
+        break;
+    case TileIndexFormat::UInt32:
+        storeCell<uint32_t>( cells, i, spriteId );
+        break;
+    }
+}
+}  // namespace
+
+TileMap::TileMap( std::shared_ptr<SpriteSheet> spriteSheet, uint32_t columns, uint32_t rows, std::optional<TileIndexFormat> indexFormat )
 : m_Columns { columns }
 , m_Rows { rows }
+, m_IndexFormat { indexFormat.value_or( getIndexFormat( spriteSheet ? spriteSheet->getNumSprites() : 0 ) ) }
 , m_SpriteSheet( std::move( spriteSheet ) )
-, m_SpriteGrid( static_cast<size_t>( m_Columns ) * m_Rows, -1 )
+, m_SpriteGrid( static_cast<size_t>( m_Columns ) * m_Rows * getCellSize( m_IndexFormat ), 0 )
 {}
 
 int TileMap::operator[]( size_t x, size_t y ) const noexcept
 {
     if ( x < m_Columns && y < m_Rows )
-        return m_SpriteGrid[y * m_Columns + x];
+        return loadCell( m_IndexFormat, m_SpriteGrid.data(), y * m_Columns + x );
 
     return -1;
 }
 
-int& TileMap::operator[]( size_t x, size_t y ) noexcept
+TileMap::TileRef TileMap::operator[]( size_t x, size_t y ) noexcept
 {
     assert( x < m_Columns );
     assert( y < m_Rows );
 
-    return m_SpriteGrid[y * m_Columns + x];
+    return { *this, x, y };
 }
 
 void TileMap::clear()
 {
-    std::ranges::fill( m_SpriteGrid, -1 );
+    // The empty tile (-1) is encoded as 0 in every format.
+    std::ranges::fill( m_SpriteGrid, uint8_t { 0 } );
 }
 
 uint32_t TileMap::getSpriteWidth() const noexcept
@@ -69,12 +152,39 @@ const BlendMode& TileMap::getBlendMode() const noexcept
     return BlendMode::Disable;
 }
 
-int TileMap::getSpriteId( size_t x, size_t y ) const
+int TileMap::getSpriteId( size_t x, size_t y ) const noexcept
 {
     assert( x < m_Columns );
     assert( y < m_Rows );
 
-    return m_SpriteGrid[y * m_Columns + x];
+    return loadCell( m_IndexFormat, m_SpriteGrid.data(), y * m_Columns + x );
+}
+
+void TileMap::setSpriteId( size_t x, size_t y, int spriteId )
+{
+    assert( x < m_Columns );
+    assert( y < m_Rows );
+
+    spriteId = std::max( spriteId, -1 );
+    reserveSpriteId( spriteId );
+
+    storeCell( m_IndexFormat, m_SpriteGrid.data(), y * m_Columns + x, spriteId );
+}
+
+std::vector<int> TileMap::getSpriteGrid() const
+{
+    std::vector<int> spriteGrid( static_cast<size_t>( m_Columns ) * m_Rows );
+    copySpriteGrid( spriteGrid );
+
+    return spriteGrid;
+}
+
+void TileMap::copySpriteGrid( std::span<int> spriteGrid ) const noexcept
+{
+    assert( spriteGrid.size() == static_cast<size_t>( m_Columns ) * m_Rows );
+
+    for ( size_t i = 0; i < spriteGrid.size(); ++i )
+        spriteGrid[i] = loadCell( m_IndexFormat, m_SpriteGrid.data(), i );
 }
 
 const Sprite& TileMap::getSprite( size_t x, size_t y ) const
@@ -89,5 +199,30 @@ const Sprite& TileMap::getSprite( size_t x, size_t y ) const
 
 void TileMap::setSpriteGrid( std::span<const int> spriteGrid )
 {
-    m_SpriteGrid = std::vector( spriteGrid.begin(), spriteGrid.end() );
+    assert( spriteGrid.size() == static_cast<size_t>( m_Columns ) * m_Rows );
+
+    if ( !spriteGrid.empty() )
+        reserveSpriteId( std::ranges::max( spriteGrid ) );
+
+    m_SpriteGrid.resize( spriteGrid.size() * getCellSize( m_IndexFormat ) );
+
+    for ( size_t i = 0; i < spriteGrid.size(); ++i )
+        storeCell( m_IndexFormat, m_SpriteGrid.data(), i, std::max( spriteGrid[i], -1 ) );
+}
+
+void TileMap::reserveSpriteId( int spriteId )
+{
+    // A sheet with spriteId + 1 sprites can index the sprite.
+    const TileIndexFormat format = getIndexFormat( static_cast<size_t>( std::max( spriteId, 0 ) ) + 1 );
+    if ( format <= m_IndexFormat )
+        return;
+
+    const size_t         numCells = static_cast<size_t>( m_Columns ) * m_Rows;
+    std::vector<uint8_t> spriteGrid( numCells * getCellSize( format ) );
+
+    for ( size_t i = 0; i < numCells; ++i )
+        storeCell( format, spriteGrid.data(), i, loadCell( m_IndexFormat, m_SpriteGrid.data(), i ) );
+
+    m_SpriteGrid  = std::move( spriteGrid );
+    m_IndexFormat = format;
 }
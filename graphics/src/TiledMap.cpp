@@ -0,0 +1,1288 @@
+#include <graphics/FrameArena.hpp>
+#include <graphics/ResourceManager.hpp>
+#include <graphics/TiledMap.hpp>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>  // For std::from_chars
+#include <future>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string_view>
+
+using namespace cpprast::graphics;
+
+namespace
+{
+// The upper 4 bits of a global tile ID (GID) store the flip & rotation flags of the tile.
+constexpr uint32_t GidMask = 0x0FFFFFFFu;
+
+enum class Encoding
+{
+    Xml,    // <tile gid="..."/> elements (TMX only).
+    Csv,    // Comma separated GIDs (or a JSON array of GIDs).
+    Base64  // Base64 encoded array of little-endian 32-bit GIDs.
+};
+
+enum class Compression
+{
+    None,
+    Zlib,
+    Gzip,
+    Unsupported
+};
+
+struct Tileset
+{
+    uint32_t              firstGid   = 1;
+    uint32_t              tileWidth  = 0;
+    uint32_t              tileHeight = 0;
+    uint32_t              spacing    = 0;
+    uint32_t              margin     = 0;
+    uint32_t              tileCount  = 0;
+    uint32_t              columns    = 0;
+    uint32_t              numSources = 0;  // The number of external tileset files that were loaded for this tileset.
+    std::filesystem::path image;
+};
+
+// External tilesets may refer to other external tilesets. Limit the nesting so that a tileset that (indirectly) refers to itself can't recurse forever.
+constexpr uint32_t MaxTilesetSources = 8;
+
+// Maps a range of GIDs to the sprites in the merged sprite sheet.
+struct TilesetRange
+{
+    uint32_t firstGid;
+    uint32_t tileCount;
+    int      firstSprite;
+};
+
+// A tile layer whose data has been located but not yet decoded.
+struct LayerData
+{
+    std::string      name;
+    uint32_t         columns     = 0;
+    uint32_t         rows        = 0;
+    bool             visible     = true;
+    float            opacity     = 1.0f;
+    Encoding         encoding    = Encoding::Xml;
+    Compression      compression = Compression::None;
+    std::string_view payload;  // Points into the contents of the map file.
+};
+
+struct MapData
+{
+    uint32_t               columns    = 0;
+    uint32_t               rows       = 0;
+    uint32_t               tileWidth  = 0;
+    uint32_t               tileHeight = 0;
+    std::vector<Tileset>   tilesets;
+    std::vector<LayerData> layers;
+};
+
+template<typename T>
+T toNumber( std::string_view str, T defaultValue = T {} ) noexcept
+{
+    T value;
+    if ( auto [ptr, ec] = std::from_chars( str.data(), str.data() + str.size(), value ); ec == std::errc {} )
+        return value;
+
+    return defaultValue;
+}
+
+constexpr bool isWhitespace( char c ) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool isWhitespace( std::string_view str ) noexcept
+{
+    return std::ranges::all_of( str, []( char c ) { return isWhitespace( c ); } );
+}
+
+void appendUTF8( std::string& str, uint32_t codePoint )
+{
+    if ( codePoint < 0x80 )
+    {
+        str += static_cast<char>( codePoint );
+    }
+    else if ( codePoint < 0x800 )
+    {
+        str += static_cast<char>( 0xC0 | ( codePoint >> 6 ) );
+        str += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+    }
+    else if ( codePoint < 0x10000 )
+    {
+        str += static_cast<char>( 0xE0 | ( codePoint >> 12 ) );
+        str += static_cast<char>( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+        str += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+    }
+    else
+    {
+        str += static_cast<char>( 0xF0 | ( codePoint >> 18 ) );
+        str += static_cast<char>( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+        str += static_cast<char>( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+        str += static_cast<char>( 0x80 | ( codePoint & 0x3F ) );
+    }
+}
+
+/// <summary>
+/// Replace the XML entities (&amp;amp; &amp;lt; &amp;#65; ...) in an attribute value.
+/// </summary>
+std::string decodeXml( std::string_view str )
+{
+    std::string result;
+    result.reserve( str.size() );
+
+    for ( size_t i = 0; i < str.size(); ++i )
+    {
+        const size_t end = str[i] == '&' ? str.find( ';', i ) : std::string_view::npos;
+        if ( end == std::string_view::npos )
+        {
+            result += str[i];
+            continue;
+        }
+
+        const std::string_view entity = str.substr( i + 1, end - i - 1 );
+        if ( entity == "amp" )
+            result += '&';
+        else if ( entity == "lt" )
+            result += '<';
+        else if ( entity == "gt" )
+            result += '>';
+        else if ( entity == "quot" )
+            result += '"';
+        else if ( entity == "apos" )
+            result += '\'';
+        else if ( entity.starts_with( "#x" ) )
+        {
+            uint32_t codePoint = 0;
+            std::from_chars( entity.data() + 2, entity.data() + entity.size(), codePoint, 16 );
+            appendUTF8( result, codePoint );
+        }
+        else if ( entity.starts_with( '#' ) )
+            appendUTF8( result, toNumber<uint32_t>( entity.substr( 1 ) ) );
+        else
+            result.append( str.substr( i, end - i + 1 ) );
+
+        i = end;
+    }
+
+    return result;
+}
+
+/// <summary>
+/// Replace the escape sequences in a JSON string.
+/// </summary>
+std::string decodeJson( std::string_view str )
+{
+    std::string result;
+    result.reserve( str.size() );
+
+    for ( size_t i = 0; i < str.size(); ++i )
+    {
+        if ( str[i] != '\\' || i + 1 == str.size() )
+        {
+            result += str[i];
+            continue;
+        }
+
+        switch ( const char c = str[++i] )
+        {
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'u':
+        {
+            uint32_t codePoint = 0;
+            std::from_chars( str.data() + i + 1, str.data() + std::min( i + 5, str.size() ), codePoint, 16 );
+            appendUTF8( result, codePoint );
+            i = std::min( i + 4, str.size() - 1 );
+        }
+        break;
+        default:
+            result += c;
+            break;
+        }
+    }
+
+    return result;
+}
+
+/// <summary>
+/// A forward-only XML reader. Elements are reported as they are encountered in the document,
+/// no document tree is built. Empty elements (&lt;tag/&gt;) are reported as a start and an end element.
+/// </summary>
+class XmlReader
+{
+public:
+    enum class Token
+    {
+        StartElement,
+        EndElement,
+        Text,
+        End,
+        Error
+    };
+
+    explicit XmlReader( std::string_view xml ) noexcept
+    : m_Xml { xml }
+    {}
+
+    Token next() noexcept
+    {
+        if ( m_PendingEnd )
+        {
+            m_PendingEnd = false;
+            return Token::EndElement;
+        }
+
+        while ( m_Pos < m_Xml.size() )
+        {
+            if ( m_Xml[m_Pos] != '<' )
+            {
+                const size_t end = std::min( m_Xml.find( '<', m_Pos ), m_Xml.size() );
+                m_Text           = m_Xml.substr( m_Pos, end - m_Pos );
+                m_Pos            = end;
+
+                if ( !isWhitespace( m_Text ) )
+                    return Token::Text;
+
+                continue;
+            }
+
+            const std::string_view rest = m_Xml.substr( m_Pos );
+            if ( rest.starts_with( "<?" ) )
+            {
+                skipPast( "?>" );
+            }
+            else if ( rest.starts_with( "<!--" ) )
+            {
+                skipPast( "-->" );
+            }
+            else if ( rest.starts_with( "<![CDATA[" ) )
+            {
+                const size_t begin = m_Pos + 9;
+                const size_t end   = std::min( m_Xml.find( "]]>", begin ), m_Xml.size() );
+                m_Text             = m_Xml.substr( begin, end - begin );
+                m_Pos              = std::min( end + 3, m_Xml.size() );
+                return Token::Text;
+            }
+            else if ( rest.starts_with( "<!" ) )
+            {
+                skipPast( ">" );
+            }
+            else if ( rest.starts_with( "</" ) )
+            {
+                const size_t end = m_Xml.find( '>', m_Pos );
+                if ( end == std::string_view::npos )
+                    return Token::Error;
+
+                m_Name = trim( m_Xml.substr( m_Pos + 2, end - m_Pos - 2 ) );
+                m_Pos  = end + 1;
+                return Token::EndElement;
+            }
+            else
+            {
+                return readStartElement();
+            }
+        }
+
+        return Token::End;
+    }
+
+    std::string_view name() const noexcept
+    {
+        return m_Name;
+    }
+
+    std::string_view text() const noexcept
+    {
+        return m_Text;
+    }
+
+    std::optional<std::string_view> attribute( std::string_view key ) const noexcept
+    {
+        return findAttribute( m_Attributes, key );
+    }
+
+    template<typename T>
+    T attribute( std::string_view key, T defaultValue ) const noexcept
+    {
+        if ( auto value = attribute( key ) )
+            return toNumber<T>( *value, defaultValue );
+
+        return defaultValue;
+    }
+
+    /// <summary>
+    /// Return the raw content of the current element and move past its end tag.
+    /// </summary>
+    std::string_view readContent() noexcept
+    {
+        if ( m_PendingEnd )
+        {
+            m_PendingEnd = false;
+            return {};
+        }
+
+        const std::string endTag = "</" + std::string( m_Name );
+        const size_t      end    = std::min( m_Xml.find( endTag, m_Pos ), m_Xml.size() );
+        std::string_view  content = m_Xml.substr( m_Pos, end - m_Pos );
+
+        m_Pos = end;
+        skipPast( ">" );
+
+        return content;
+    }
+
+    /// <summary>
+    /// Skip the current element, including all of its children.
+    /// </summary>
+    void skipElement() noexcept
+    {
+        int depth = 1;
+        while ( depth > 0 )
+        {
+            switch ( next() )
+            {
+            case Token::StartElement:
+                ++depth;
+                break;
+            case Token::EndElement:
+                --depth;
+                break;
+            case Token::End:
+            case Token::Error:
+                return;
+            default:
+                break;
+            }
+        }
+    }
+
+    static std::optional<std::string_view> findAttribute( std::string_view attributes, std::string_view key ) noexcept
+    {
+        size_t i = 0;
+        while ( i < attributes.size() )
+        {
+            while ( i < attributes.size() && isWhitespace( attributes[i] ) )
+                ++i;
+
+            const size_t nameBegin = i;
+            while ( i < attributes.size() && attributes[i] != '=' && !isWhitespace( attributes[i] ) )
+                ++i;
+
+            const std::string_view name = attributes.substr( nameBegin, i - nameBegin );
+
+            while ( i < attributes.size() && ( attributes[i] == '=' || isWhitespace( attributes[i] ) ) )
+                ++i;
+
+            if ( i >= attributes.size() )
+                break;
+
+            const char   quote      = attributes[i];
+            const size_t valueBegin = i + 1;
+            const size_t valueEnd   = std::min( attributes.find( quote, valueBegin ), attributes.size() );
+
+            if ( name == key )
+                return attributes.substr( valueBegin, valueEnd - valueBegin );
+
+            i = valueEnd + 1;
+        }
+
+        return {};
+    }
+
+private:
+    Token readStartElement() noexcept
+    {
+        size_t nameEnd = m_Pos + 1;
+        while ( nameEnd < m_Xml.size() && !isWhitespace( m_Xml[nameEnd] ) && m_Xml[nameEnd] != '>' && m_Xml[nameEnd] != '/' )
+            ++nameEnd;
+
+        // Find the end of the tag. Attribute values may contain '>'.
+        size_t end   = nameEnd;
+        char   quote = 0;
+        for ( ; end < m_Xml.size(); ++end )
+        {
+            const char c = m_Xml[end];
+            if ( quote )
+            {
+                if ( c == quote )
+                    quote = 0;
+            }
+            else if ( c == '"' || c == '\'' )
+            {
+                quote = c;
+            }
+            else if ( c == '>' )
+            {
+                break;
+            }
+        }
+
+        if ( end >= m_Xml.size() )
+            return Token::Error;
+
+        m_PendingEnd = m_Xml[end - 1] == '/';
+        m_Name       = m_Xml.substr( m_Pos + 1, nameEnd - m_Pos - 1 );
+        m_Attributes = m_Xml.substr( nameEnd, end - nameEnd - ( m_PendingEnd ? 1 : 0 ) );
+        m_Pos        = end + 1;
+
+        return Token::StartElement;
+    }
+
+    void skipPast( std::string_view str ) noexcept
+    {
+        const size_t end = m_Xml.find( str, m_Pos );
+        m_Pos            = end == std::string_view::npos ? m_Xml.size() : end + str.size();
+    }
+
+    static std::string_view trim( std::string_view str ) noexcept
+    {
+        while ( !str.empty() && isWhitespace( str.front() ) )
+            str.remove_prefix( 1 );
+        while ( !str.empty() && isWhitespace( str.back() ) )
+            str.remove_suffix( 1 );
+
+        return str;
+    }
+
+    std::string_view m_Xml;
+    size_t           m_Pos = 0;
+    std::string_view m_Name;
+    std::string_view m_Attributes;
+    std::string_view m_Text;
+    bool             m_PendingEnd = false;
+};
+
+/// <summary>
+/// A forward-only JSON reader. Values are reported as tokens as they are encountered in the document,
+/// no document tree is built. Commas and colons are skipped.
+/// </summary>
+class JsonReader
+{
+public:
+    enum class Token
+    {
+        ObjectBegin,
+        ObjectEnd,
+        ArrayBegin,
+        ArrayEnd,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End,
+        Error
+    };
+
+    explicit JsonReader( std::string_view json ) noexcept
+    : m_Json { json }
+    {}
+
+    Token next() noexcept
+    {
+        while ( m_Pos < m_Json.size() && ( isWhitespace( m_Json[m_Pos] ) || m_Json[m_Pos] == ',' || m_Json[m_Pos] == ':' ) )
+            ++m_Pos;
+
+        if ( m_Pos >= m_Json.size() )
+            return Token::End;
+
+        m_Start = m_Pos;
+
+        switch ( m_Json[m_Pos] )
+        {
+        case '{':
+            ++m_Pos;
+            return Token::ObjectBegin;
+        case '}':
+            ++m_Pos;
+            return Token::ObjectEnd;
+        case '[':
+            ++m_Pos;
+            return Token::ArrayBegin;
+        case ']':
+            ++m_Pos;
+            return Token::ArrayEnd;
+        case '"':
+        {
+            size_t end = m_Pos + 1;
+            while ( end < m_Json.size() && m_Json[end] != '"' )
+                end += m_Json[end] == '\\' ? 2 : 1;
+
+            if ( end >= m_Json.size() )
+                return Token::Error;
+
+            m_Value = m_Json.substr( m_Pos + 1, end - m_Pos - 1 );
+            m_Pos   = end + 1;
+            return Token::String;
+        }
+        case 't':
+            return readLiteral( "true", Token::True );
+        case 'f':
+            return readLiteral( "false", Token::False );
+        case 'n':
+            return readLiteral( "null", Token::Null );
+        default:
+        {
+            const size_t end = std::min( m_Json.find_first_not_of( "0123456789+-.eE", m_Pos ), m_Json.size() );
+            if ( end == m_Pos )
+                return Token::Error;
+
+            m_Value = m_Json.substr( m_Pos, end - m_Pos );
+            m_Pos   = end;
+            return Token::Number;
+        }
+        }
+    }
+
+    /// <summary>
+    /// The value of the last string (without quotes or decoding), number, or literal token.
+    /// </summary>
+    std::string_view value() const noexcept
+    {
+        return m_Value;
+    }
+
+    template<typename T>
+    T number( T defaultValue = T {} ) const noexcept
+    {
+        return toNumber<T>( m_Value, defaultValue );
+    }
+
+    /// <summary>
+    /// Skip the remainder of a value that starts with the given token.
+    /// </summary>
+    /// <returns>The raw JSON text of the value.</returns>
+    std::string_view skipValue( Token token ) noexcept
+    {
+        const size_t start = m_Start;
+
+        if ( token == Token::ObjectBegin || token == Token::ArrayBegin )
+        {
+            int depth = 1;
+            while ( depth > 0 )
+            {
+                switch ( next() )
+                {
+                case Token::ObjectBegin:
+                case Token::ArrayBegin:
+                    ++depth;
+                    break;
+                case Token::ObjectEnd:
+                case Token::ArrayEnd:
+                    --depth;
+                    break;
+                case Token::End:
+                case Token::Error:
+                    return {};
+                default:
+                    break;
+                }
+            }
+        }
+
+        return m_Json.substr( start, m_Pos - start );
+    }
+
+private:
+    Token readLiteral( std::string_view literal, Token token ) noexcept
+    {
+        if ( !m_Json.substr( m_Pos ).starts_with( literal ) )
+            return Token::Error;
+
+        m_Value = m_Json.substr( m_Pos, literal.size() );
+        m_Pos += literal.size();
+        return token;
+    }
+
+    std::string_view m_Json;
+    size_t           m_Pos   = 0;
+    size_t           m_Start = 0;
+    std::string_view m_Value;
+};
+
+Compression parseCompression( std::string_view compression ) noexcept
+{
+    if ( compression.empty() )
+        return Compression::None;
+    if ( compression == "zlib" )
+        return Compression::Zlib;
+    if ( compression == "gzip" )
+        return Compression::Gzip;
+
+    return Compression::Unsupported;
+}
+
+bool parseTmxTileset( XmlReader& reader, Tileset& tileset, const std::filesystem::path& basePath );
+bool parseJsonTileset( JsonReader& reader, Tileset& tileset, const std::filesystem::path& basePath );
+
+/// <summary>
+/// Load an external tileset (TSX or JSON) file.
+/// </summary>
+bool loadTileset( const std::filesystem::path& filePath, Tileset& tileset )
+{
+    if ( ++tileset.numSources > MaxTilesetSources )
+    {
+        std::cerr << "ERROR: Too many nested tileset sources: " << filePath.string() << std::endl;
+        return false;
+    }
+
+    const auto contents = ResourceManager::readFile( filePath );
+    if ( !contents )
+    {
+        std::cerr << "ERROR: Could not load tileset: " << filePath.string() << std::endl;
+        return false;
+    }
+
+    const auto extension = filePath.extension();
+    if ( extension == ".json" || extension == ".tsj" )
+    {
+        JsonReader reader { *contents };
+        return reader.next() == JsonReader::Token::ObjectBegin && parseJsonTileset( reader, tileset, filePath.parent_path() );
+    }
+
+    XmlReader reader { *contents };
+    for ( auto token = reader.next(); token != XmlReader::Token::End && token != XmlReader::Token::Error; token = reader.next() )
+    {
+        if ( token == XmlReader::Token::StartElement && reader.name() == "tileset" )
+            return parseTmxTileset( reader, tileset, filePath.parent_path() );
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Parse a &lt;tileset&gt; element. The reader must be positioned on the start element.
+/// </summary>
+bool parseTmxTileset( XmlReader& reader, Tileset& tileset, const std::filesystem::path& basePath )
+{
+    tileset.firstGid = reader.attribute( "firstgid", tileset.firstGid );
+
+    if ( auto source = reader.attribute( "source" ) )
+    {
+        reader.skipElement();
+        return loadTileset( basePath / decodeXml( *source ), tileset );
+    }
+
+    tileset.tileWidth  = reader.attribute( "tilewidth", 0u );
+    tileset.tileHeight = reader.attribute( "tileheight", 0u );
+    tileset.spacing    = reader.attribute( "spacing", 0u );
+    tileset.margin     = reader.attribute( "margin", 0u );
+    tileset.tileCount  = reader.attribute( "tilecount", 0u );
+    tileset.columns    = reader.attribute( "columns", 0u );
+
+    for ( auto token = reader.next(); token != XmlReader::Token::End; token = reader.next() )
+    {
+        if ( token == XmlReader::Token::Error )
+            return false;
+
+        if ( token == XmlReader::Token::EndElement && reader.name() == "tileset" )
+            return true;
+
+        if ( token == XmlReader::Token::StartElement )
+        {
+            if ( reader.name() == "image" )
+            {
+                if ( auto source = reader.attribute( "source" ) )
+                    tileset.image = basePath / decodeXml( *source );
+            }
+            reader.skipElement();
+        }
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Parse a tileset object. The reader must be positioned after the opening brace of the object.
+/// </summary>
+bool parseJsonTileset( JsonReader& reader, Tileset& tileset, const std::filesystem::path& basePath )
+{
+    using Token = JsonReader::Token;
+
+    std::filesystem::path source;
+
+    for ( auto token = reader.next(); token != Token::ObjectEnd; token = reader.next() )
+    {
+        if ( token != Token::String )
+            return false;
+
+        const std::string_view key = reader.value();
+        token                      = reader.next();
+
+        if ( key == "firstgid" )
+            tileset.firstGid = reader.number<uint32_t>( 1 );
+        else if ( key == "source" )
+            source = basePath / decodeJson( reader.value() );
+        else if ( key == "image" )
+            tileset.image = basePath / decodeJson( reader.value() );
+        else if ( key == "tilewidth" )
+            tileset.tileWidth = reader.number<uint32_t>();
+        else if ( key == "tileheight" )
+            tileset.tileHeight = reader.number<uint32_t>();
+        else if ( key == "spacing" )
+            tileset.spacing = reader.number<uint32_t>();
+        else if ( key == "margin" )
+            tileset.margin = reader.number<uint32_t>();
+        else if ( key == "tilecount" )
+            tileset.tileCount = reader.number<uint32_t>();
+        else if ( key == "columns" )
+            tileset.columns = reader.number<uint32_t>();
+        else if ( reader.skipValue( token ).empty() )
+            return false;
+    }
+
+    if ( !source.empty() )
+        return loadTileset( source, tileset );
+
+    return true;
+}
+
+bool parseTmxMap( std::string_view contents, const std::filesystem::path& basePath, MapData& map )
+{
+    using Token = XmlReader::Token;
+
+    XmlReader                reader { contents };
+    std::optional<LayerData> layer;
+
+    for ( auto token = reader.next(); token != Token::End; token = reader.next() )
+    {
+        if ( token == Token::Error )
+            return false;
+
+        if ( token != Token::StartElement )
+            continue;
+
+        const std::string_view name = reader.name();
+        if ( name == "map" )
+        {
+            if ( reader.attribute( "infinite", 0 ) != 0 )
+            {
+                std::cerr << "ERROR: Infinite maps are not supported." << std::endl;
+                return false;
+            }
+
+            map.columns    = reader.attribute( "width", 0u );
+            map.rows       = reader.attribute( "height", 0u );
+            map.tileWidth  = reader.attribute( "tilewidth", 0u );
+            map.tileHeight = reader.attribute( "tileheight", 0u );
+        }
+        else if ( name == "tileset" )
+        {
+            if ( !parseTmxTileset( reader, map.tilesets.emplace_back(), basePath ) )
+                return false;
+        }
+        else if ( name == "layer" )
+        {
+            layer          = LayerData {};
+            layer->name    = decodeXml( reader.attribute( "name" ).value_or( "" ) );
+            layer->columns = reader.attribute( "width", map.columns );
+            layer->rows    = reader.attribute( "height", map.rows );
+            layer->visible = reader.attribute( "visible", 1 ) != 0;
+            layer->opacity = reader.attribute( "opacity", 1.0f );
+        }
+        else if ( name == "data" && layer )
+        {
+            const std::string_view encoding = reader.attribute( "encoding" ).value_or( "" );
+
+            layer->encoding    = encoding == "csv" ? Encoding::Csv : encoding == "base64" ? Encoding::Base64 : Encoding::Xml;
+            layer->compression = parseCompression( reader.attribute( "compression" ).value_or( "" ) );
+            layer->payload     = reader.readContent();
+
+            map.layers.push_back( std::move( *layer ) );
+            layer.reset();
+        }
+        else if ( name == "properties" || name == "objectgroup" || name == "imagelayer" )
+        {
+            reader.skipElement();
+        }
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Parse the layers array of a JSON map. The reader must be positioned after the opening bracket of the array.
+/// The tile layers of group layers are added to the map in order.
+/// </summary>
+bool parseJsonLayers( JsonReader& reader, MapData& map )
+{
+    using Token = JsonReader::Token;
+
+    for ( auto token = reader.next(); token != Token::ArrayEnd; token = reader.next() )
+    {
+        if ( token != Token::ObjectBegin )
+            return false;
+
+        LayerData        layer;
+        std::string_view type;
+
+        for ( token = reader.next(); token != Token::ObjectEnd; token = reader.next() )
+        {
+            if ( token != Token::String )
+                return false;
+
+            const std::string_view key = reader.value();
+            token                      = reader.next();
+
+            if ( key == "type" )
+            {
+                type = reader.value();
+            }
+            else if ( key == "name" )
+            {
+                layer.name = decodeJson( reader.value() );
+            }
+            else if ( key == "width" )
+            {
+                layer.columns = reader.number<uint32_t>();
+            }
+            else if ( key == "height" )
+            {
+                layer.rows = reader.number<uint32_t>();
+            }
+            else if ( key == "visible" )
+            {
+                layer.visible = token == Token::True;
+            }
+            else if ( key == "opacity" )
+            {
+                layer.opacity = reader.number<float>( 1.0f );
+            }
+            else if ( key == "compression" )
+            {
+                layer.compression = parseCompression( reader.value() );
+            }
+            else if ( key == "data" )
+            {
+                // An array of GIDs is decoded the same way as CSV data.
+                layer.encoding = token == Token::ArrayBegin ? Encoding::Csv : Encoding::Base64;
+                layer.payload  = token == Token::ArrayBegin ? reader.skipValue( token ) : reader.value();
+            }
+            else if ( key == "layers" && token == Token::ArrayBegin )
+            {
+                if ( !parseJsonLayers( reader, map ) )
+                    return false;
+            }
+            else if ( key == "chunks" )
+            {
+                std::cerr << "ERROR: Infinite maps are not supported." << std::endl;
+                return false;
+            }
+            else if ( reader.skipValue( token ).empty() )
+            {
+                return false;
+            }
+        }
+
+        if ( type == "tilelayer" && !layer.payload.empty() )
+            map.layers.push_back( std::move( layer ) );
+    }
+
+    return true;
+}
+
+bool parseJsonMap( std::string_view contents, const std::filesystem::path& basePath, MapData& map )
+{
+    using Token = JsonReader::Token;
+
+    JsonReader reader { contents };
+    if ( reader.next() != Token::ObjectBegin )
+        return false;
+
+    // Layers may appear before the map size in the file. Layers without an explicit size
+    // are fixed up after the whole map has been parsed.
+    for ( auto token = reader.next(); token != Token::ObjectEnd; token = reader.next() )
+    {
+        if ( token != Token::String )
+            return false;
+
+        const std::string_view key = reader.value();
+        token                      = reader.next();
+
+        if ( key == "width" )
+        {
+            map.columns = reader.number<uint32_t>();
+        }
+        else if ( key == "height" )
+        {
+            map.rows = reader.number<uint32_t>();
+        }
+        else if ( key == "tilewidth" )
+        {
+            map.tileWidth = reader.number<uint32_t>();
+        }
+        else if ( key == "tileheight" )
+        {
+            map.tileHeight = reader.number<uint32_t>();
+        }
+        else if ( key == "infinite" && token == Token::True )
+        {
+            std::cerr << "ERROR: Infinite maps are not supported." << std::endl;
+            return false;
+        }
+        else if ( key == "layers" && token == Token::ArrayBegin )
+        {
+            if ( !parseJsonLayers( reader, map ) )
+                return false;
+        }
+        else if ( key == "tilesets" && token == Token::ArrayBegin )
+        {
+            for ( token = reader.next(); token == Token::ObjectBegin; token = reader.next() )
+            {
+                if ( !parseJsonTileset( reader, map.tilesets.emplace_back(), basePath ) )
+                    return false;
+            }
+
+            if ( token != Token::ArrayEnd )
+                return false;
+        }
+        else if ( reader.skipValue( token ).empty() )
+        {
+            return false;
+        }
+    }
+
+    for ( LayerData& layer: map.layers )
+    {
+        if ( layer.columns == 0 )
+            layer.columns = map.columns;
+        if ( layer.rows == 0 )
+            layer.rows = map.rows;
+    }
+
+    return true;
+}
+
+std::vector<uint8_t> decodeBase64( std::string_view str )
+{
+    constexpr auto table = [] {
+        std::array<int8_t, 256> table {};
+        table.fill( -1 );
+
+        constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for ( size_t i = 0; i < alphabet.size(); ++i )
+            table[static_cast<uint8_t>( alphabet[i] )] = static_cast<int8_t>( i );
+
+        return table;
+    }();
+
+    std::vector<uint8_t> bytes;
+    bytes.reserve( str.size() * 3 / 4 );
+
+    uint32_t bits     = 0;
+    int      numBits  = 0;
+    for ( const char c: str )
+    {
+        const int8_t value = table[static_cast<uint8_t>( c )];
+        if ( value < 0 )
+            continue;  // Skip whitespace, padding, and escape characters.
+
+        bits = ( bits << 6 ) | static_cast<uint32_t>( value );
+        numBits += 6;
+
+        if ( numBits >= 8 )
+        {
+            numBits -= 8;
+            bytes.push_back( static_cast<uint8_t>( bits >> numBits ) );
+        }
+    }
+
+    return bytes;
+}
+
+/// <summary>
+/// Inflate a gzip stream. stb_image only handles zlib streams, so the gzip header is skipped manually.
+/// </summary>
+int inflateGzip( std::span<const uint8_t> bytes, std::span<uint8_t> out ) noexcept
+{
+    constexpr uint8_t FHCRC    = 0x02;
+    constexpr uint8_t FEXTRA   = 0x04;
+    constexpr uint8_t FNAME    = 0x08;
+    constexpr uint8_t FCOMMENT = 0x10;
+
+    if ( bytes.size() < 18 || bytes[0] != 0x1F || bytes[1] != 0x8B || bytes[2] != 8 )
+        return -1;
+
+    const uint8_t flags = bytes[3];
+    size_t        pos   = 10;
+
+    if ( flags & FEXTRA )
+        pos += 2 + ( bytes[pos] | ( bytes[pos + 1] << 8 ) );
+    if ( flags & FNAME )
+        while ( pos < bytes.size() && bytes[pos++] != 0 ) {}
+    if ( flags & FCOMMENT )
+        while ( pos < bytes.size() && bytes[pos++] != 0 ) {}
+    if ( flags & FHCRC )
+        pos += 2;
+
+    if ( pos >= bytes.size() )
+        return -1;
+
+    return stbi_zlib_decode_noheader_buffer( reinterpret_cast<char*>( out.data() ), static_cast<int>( out.size() ), reinterpret_cast<const char*>( bytes.data() + pos ), static_cast<int>( bytes.size() - pos ) );
+}
+
+/// <summary>
+/// Decode the global tile IDs of a layer.
+/// </summary>
+std::optional<std::vector<uint32_t>> decodeGids( const LayerData& layer )
+{
+    const size_t          numTiles = static_cast<size_t>( layer.columns ) * layer.rows;
+    std::vector<uint32_t> gids;
+    gids.reserve( numTiles );
+
+    switch ( layer.encoding )
+    {
+    case Encoding::Csv:
+    {
+        uint32_t gid      = 0;
+        bool     inNumber = false;
+        for ( const char c: layer.payload )
+        {
+            if ( c >= '0' && c <= '9' )
+            {
+                gid      = gid * 10 + static_cast<uint32_t>( c - '0' );
+                inNumber = true;
+            }
+            else if ( inNumber )
+            {
+                gids.push_back( gid );
+                gid      = 0;
+                inNumber = false;
+            }
+        }
+
+        if ( inNumber )
+            gids.push_back( gid );
+    }
+    break;
+    case Encoding::Xml:
+    {
+        for ( size_t pos = layer.payload.find( "<tile" ); pos != std::string_view::npos; pos = layer.payload.find( "<tile", pos + 1 ) )
+        {
+            const size_t end = std::min( layer.payload.find( '>', pos ), layer.payload.size() );
+            const auto   gid = XmlReader::findAttribute( layer.payload.substr( pos + 5, end - pos - 5 ), "gid" );
+
+            gids.push_back( gid ? toNumber<uint32_t>( *gid ) : 0u );
+        }
+    }
+    break;
+    case Encoding::Base64:
+    {
+        const std::vector<uint8_t> bytes = decodeBase64( layer.payload );
+        std::vector<uint8_t>       inflated;
+        std::span<const uint8_t>   data = bytes;
+
+        if ( layer.compression != Compression::None )
+        {
+            inflated.resize( numTiles * sizeof( uint32_t ) );
+
+            int size = -1;
+            if ( layer.compression == Compression::Zlib )
+                size = stbi_zlib_decode_buffer( reinterpret_cast<char*>( inflated.data() ), static_cast<int>( inflated.size() ), reinterpret_cast<const char*>( bytes.data() ), static_cast<int>( bytes.size() ) );
+            else if ( layer.compression == Compression::Gzip )
+                size = inflateGzip( bytes, inflated );
+
+            if ( size < 0 )
+                return {};
+
+            data = std::span { inflated }.first( static_cast<size_t>( size ) );
+        }
+
+        for ( size_t i = 0; i + 3 < data.size(); i += 4 )
+            gids.push_back( data[i] | ( data[i + 1] << 8 ) | ( data[i + 2] << 16 ) | ( static_cast<uint32_t>( data[i + 3] ) << 24 ) );
+    }
+    break;
+    }
+
+    if ( gids.size() != numTiles )
+        return {};
+
+    return gids;
+}
+
+/// <summary>
+/// Decode the data of a layer into a tile map.
+/// This function is executed on a worker thread.
+/// </summary>
+std::optional<TileMap> decodeLayer( const LayerData& layer, std::span<const TilesetRange> tilesets, const std::shared_ptr<SpriteSheet>& spriteSheet )
+{
+    if ( layer.compression == Compression::Unsupported )
+    {
+        std::cerr << "ERROR: Unsupported compression in layer: " << layer.name << std::endl;
+        return {};
+    }
+
+    const auto gids = decodeGids( layer );
+    if ( !gids )
+    {
+        std::cerr << "ERROR: Could not decode layer: " << layer.name << std::endl;
+        return {};
+    }
+
+    std::vector<int> spriteGrid( gids->size(), -1 );
+
+    const TilesetRange* tileset = nullptr;
+    for ( size_t i = 0; i < gids->size(); ++i )
+    {
+        const uint32_t gid = ( *gids )[i] & GidMask;
+        if ( gid == 0 )
+            continue;
+
+        // Neighboring tiles usually come from the same tileset.
+        if ( !tileset || gid < tileset->firstGid || gid >= tileset->firstGid + tileset->tileCount )
+        {
+            auto iter = std::ranges::upper_bound( tilesets, gid, {}, &TilesetRange::firstGid );
+            tileset   = iter == tilesets.begin() ? nullptr : &*std::prev( iter );
+        }
+
+        if ( tileset && gid < tileset->firstGid + tileset->tileCount )
+            spriteGrid[i] = tileset->firstSprite + static_cast<int>( gid - tileset->firstGid );
+    }
+
+    TileMap tileMap { spriteSheet, layer.columns, layer.rows };
+    tileMap.setSpriteGrid( spriteGrid );
+
+    return tileMap;
+}
+
+}  // namespace
+
+TiledMap::TiledMap( const std::filesystem::path& filePath, const BlendMode& blendMode )
+{
+    const auto contents = ResourceManager::readFile( filePath );
+    if ( !contents )
+    {
+        std::cerr << "ERROR: Could not load: " << filePath.string() << std::endl;
+        return;
+    }
+
+    MapData    map;
+    const auto extension = filePath.extension();
+    const bool parsed    = extension == ".json" || extension == ".tmj" ? parseJsonMap( *contents, filePath.parent_path(), map ) : parseTmxMap( *contents, filePath.parent_path(), map );
+
+    if ( !parsed )
+    {
+        std::cerr << "ERROR: Could not parse Tiled map: " << filePath.string() << std::endl;
+        return;
+    }
+
+    // Merge the tilesets into a single sprite sheet.
+    std::ranges::sort( map.tilesets, {}, &Tileset::firstGid );
+
+    // The tileset ranges and the pending layers only live while the map is loaded, so they are allocated from the arena of the calling thread.
+    FrameArena::Scope scope { FrameArena::getThreadArena() };
+
+    auto                           spriteSheet = std::make_shared<SpriteSheet>();
+    std::pmr::vector<TilesetRange> tilesets { &scope.getArena() };
+
+    for ( Tileset& tileset: map.tilesets )
+    {
+        // All tilesets share one sprite sheet that is drawn on the grid of the map, so the tiles must have the size of the grid cells.
+        if ( tileset.tileWidth != map.tileWidth || tileset.tileHeight != map.tileHeight )
+        {
+            std::cerr << "ERROR: Tileset tile size (" << tileset.tileWidth << "x" << tileset.tileHeight << ") does not match the map tile size (" << map.tileWidth << "x"
+                      << map.tileHeight << "): " << tileset.image.string() << std::endl;
+            continue;
+        }
+
+        const auto image = ResourceManager::loadImage( tileset.image );
+
+        // The tiles must fit in the image.
+        auto isValid = [&] {
+            if ( !image || !*image || tileset.tileWidth == 0 || tileset.tileHeight == 0 )
+                return false;
+
+            const int64_t tileWidth  = tileset.tileWidth;
+            const int64_t tileHeight = tileset.tileHeight;
+            const int64_t spacing    = tileset.spacing;
+            const int64_t margin     = tileset.margin;
+            const int64_t width      = image->getWidth();
+            const int64_t height     = image->getHeight();
+
+            // Older tilesets don't store the number of columns and tiles.
+            if ( tileset.columns == 0 )
+                tileset.columns = static_cast<uint32_t>( std::max<int64_t>( ( width - 2 * margin + spacing ) / ( tileWidth + spacing ), 0 ) );
+            if ( tileset.columns == 0 )
+                return false;
+            if ( tileset.tileCount == 0 )
+                tileset.tileCount = tileset.columns * static_cast<uint32_t>( std::max<int64_t>( ( height - 2 * margin + spacing ) / ( tileHeight + spacing ), 0 ) );
+            if ( tileset.tileCount == 0 )
+                return false;
+
+            // The rightmost and the bottom tile.
+            const int64_t lastColumn = std::min( tileset.tileCount, tileset.columns ) - 1;
+            const int64_t lastRow    = ( tileset.tileCount - 1 ) / tileset.columns;
+
+            return margin + lastColumn * ( tileWidth + spacing ) + tileWidth <= width && margin + lastRow * ( tileHeight + spacing ) + tileHeight <= height;
+        };
+
+        if ( !isValid() )
+        {
+            std::cerr << "ERROR: Unsupported tileset: " << tileset.image.string() << std::endl;
+            continue;
+        }
+
+        const int tileWidth  = static_cast<int>( tileset.tileWidth );
+        const int tileHeight = static_cast<int>( tileset.tileHeight );
+        const int spacing    = static_cast<int>( tileset.spacing );
+        const int margin     = static_cast<int>( tileset.margin );
+
+        tilesets.push_back( { tileset.firstGid, tileset.tileCount, static_cast<int>( spriteSheet->getNumSprites() ) } );
+
+        for ( uint32_t i = 0; i < tileset.tileCount; ++i )
+        {
+            const int   column = static_cast<int>( i % tileset.columns );
+            const int   row    = static_cast<int>( i / tileset.columns );
+            const RectI rect { margin + column * ( tileWidth + spacing ), margin + row * ( tileHeight + spacing ), tileWidth, tileHeight };
+
+            spriteSheet->addSprite( Sprite { image, rect, blendMode } );
+        }
+    }
+
+    // Decode the layers on worker threads.
+    std::pmr::vector<std::future<std::optional<TileMap>>> tileMaps { &scope.getArena() };
+    tileMaps.reserve( map.layers.size() );
+
+    for ( const LayerData& layer: map.layers )
+    {
+        tileMaps.push_back( std::async( std::launch::async, decodeLayer, std::cref( layer ), std::span<const TilesetRange> { tilesets }, std::cref( spriteSheet ) ) );
+    }
+
+    for ( size_t i = 0; i < tileMaps.size(); ++i )
+    {
+        if ( auto tileMap = tileMaps[i].get() )
+            m_Layers.push_back( { std::move( map.layers[i].name ), std::move( *tileMap ), map.layers[i].visible, map.layers[i].opacity } );
+    }
+
+    m_Columns     = map.columns;
+    m_Rows        = map.rows;
+    m_TileWidth   = map.tileWidth;
+    m_TileHeight  = map.tileHeight;
+    m_SpriteSheet = std::move( spriteSheet );
+}
+
+const TiledLayer* TiledMap::findLayer( std::string_view name ) const noexcept
+{
+    const auto iter = std::ranges::find( m_Layers, name, &TiledLayer::name );
+
+    return iter != m_Layers.end() ? &*iter : nullptr;
+}
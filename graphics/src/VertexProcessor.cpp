@@ -0,0 +1,291 @@
+#include <graphics/VertexProcessor.hpp>
+
+#include <algorithm>  // For std::ranges::fill
+
+using namespace cpprast::graphics;
+using namespace cpprast::math;
+
+namespace
+{
+// The transform matrix and the viewport mapping (screen = ndc * scale + offset).
+struct TransformConstants
+{
+    float m[4][4];  // Column-major, like glm.
+    float scaleX;
+    float offsetX;
+    float scaleY;
+    float offsetY;
+    float scaleZ;
+    float offsetZ;
+};
+
+// Pointers to the output streams of the transform.
+struct TransformOutputs
+{
+    float* clipX;
+    float* clipY;
+    float* clipZ;
+    float* clipW;
+    float* screenX;
+    float* screenY;
+    float* screenZ;
+    float* invW;
+};
+
+TransformConstants makeConstants( const glm::mat4& transform, const Viewport& viewport ) noexcept
+{
+    TransformConstants c {};
+    for ( int col = 0; col < 4; ++col )
+    {
+        for ( int row = 0; row < 4; ++row )
+            c.m[col][row] = transform[col][row];
+    }
+
+    // The y-axis of normalized device coordinates points up, the y-axis of the viewport points down.
+    c.scaleX  = viewport.width * 0.5f;
+    c.offsetX = viewport.x + viewport.width * 0.5f;
+    c.scaleY  = viewport.height * -0.5f;
+    c.offsetY = viewport.y + viewport.height * 0.5f;
+    c.scaleZ  = viewport.maxDepth - viewport.minDepth;
+    c.offsetZ = viewport.minDepth;
+
+    return c;
+}
+
+// Perspective divide and viewport mapping of a clip-space position.
+void projectVertex( const TransformConstants& c, float cx, float cy, float cz, float cw, const TransformOutputs& out, size_t i ) noexcept
+{
+    const float invW = 1.0f / cw;
+
+    out.clipX[i]   = cx;
+    out.clipY[i]   = cy;
+    out.clipZ[i]   = cz;
+    out.clipW[i]   = cw;
+    out.screenX[i] = cx * invW * c.scaleX + c.offsetX;
+    out.screenY[i] = cy * invW * c.scaleY + c.offsetY;
+    out.screenZ[i] = cz * invW * c.scaleZ + c.offsetZ;
+    out.invW[i]    = invW;
+}
+
+void transformVertex( const TransformConstants& c, float x, float y, float z, const TransformOutputs& out, size_t i ) noexcept
+{
+    const float cx = c.m[0][0] * x + c.m[1][0] * y + c.m[2][0] * z + c.m[3][0];
+    const float cy = c.m[0][1] * x + c.m[1][1] * y + c.m[2][1] * z + c.m[3][1];
+    const float cz = c.m[0][2] * x + c.m[1][2] * y + c.m[2][2] * z + c.m[3][2];
+    const float cw = c.m[0][3] * x + c.m[1][3] * y + c.m[2][3] * z + c.m[3][3];
+
+    projectVertex( c, cx, cy, cz, cw, out, i );
+}
+
+// Transform count vertices from contiguous input streams to the same positions in the output streams.
+void transformVertices( const TransformConstants& c, const float* x, const float* y, const float* z, size_t count, const TransformOutputs& out ) noexcept
+{
+    size_t i = 0;
+
+#if CPPRAST_SIMD_WIDTH == 8
+    __m256 m[4][4];
+    for ( int col = 0; col < 4; ++col )
+    {
+        for ( int row = 0; row < 4; ++row )
+            m[col][row] = _mm256_set1_ps( c.m[col][row] );
+    }
+
+    const __m256 one     = _mm256_set1_ps( 1.0f );
+    const __m256 scaleX  = _mm256_set1_ps( c.scaleX );
+    const __m256 offsetX = _mm256_set1_ps( c.offsetX );
+    const __m256 scaleY  = _mm256_set1_ps( c.scaleY );
+    const __m256 offsetY = _mm256_set1_ps( c.offsetY );
+    const __m256 scaleZ  = _mm256_set1_ps( c.scaleZ );
+    const __m256 offsetZ = _mm256_set1_ps( c.offsetZ );
+
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const __m256 vx = _mm256_loadu_ps( x + i );
+        const __m256 vy = _mm256_loadu_ps( y + i );
+        const __m256 vz = _mm256_loadu_ps( z + i );
+
+        __m256 clip[4];
+        for ( int row = 0; row < 4; ++row )
+        {
+            __m256 r  = _mm256_add_ps( _mm256_mul_ps( m[0][row], vx ), _mm256_mul_ps( m[1][row], vy ) );
+            r         = _mm256_add_ps( r, _mm256_mul_ps( m[2][row], vz ) );
+            clip[row] = _mm256_add_ps( r, m[3][row] );
+        }
+
+        const __m256 invW = _mm256_div_ps( one, clip[3] );
+
+        _mm256_storeu_ps( out.clipX + i, clip[0] );
+        _mm256_storeu_ps( out.clipY + i, clip[1] );
+        _mm256_storeu_ps( out.clipZ + i, clip[2] );
+        _mm256_storeu_ps( out.clipW + i, clip[3] );
+        _mm256_storeu_ps( out.screenX + i, _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( clip[0], invW ), scaleX ), offsetX ) );
+        _mm256_storeu_ps( out.screenY + i, _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( clip[1], invW ), scaleY ), offsetY ) );
+        _mm256_storeu_ps( out.screenZ + i, _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( clip[2], invW ), scaleZ ), offsetZ ) );
+        _mm256_storeu_ps( out.invW + i, invW );
+    }
+#elif CPPRAST_SIMD_WIDTH == 4
+    __m128 m[4][4];
+    for ( int col = 0; col < 4; ++col )
+    {
+        for ( int row = 0; row < 4; ++row )
+            m[col][row] = _mm_set1_ps( c.m[col][row] );
+    }
+
+    const __m128 one     = _mm_set1_ps( 1.0f );
+    const __m128 scaleX  = _mm_set1_ps( c.scaleX );
+    const __m128 offsetX = _mm_set1_ps( c.offsetX );
+    const __m128 scaleY  = _mm_set1_ps( c.scaleY );
+    const __m128 offsetY = _mm_set1_ps( c.offsetY );
+    const __m128 scaleZ  = _mm_set1_ps( c.scaleZ );
+    const __m128 offsetZ = _mm_set1_ps( c.offsetZ );
+
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        const __m128 vx = _mm_loadu_ps( x + i );
+        const __m128 vy = _mm_loadu_ps( y + i );
+        const __m128 vz = _mm_loadu_ps( z + i );
+
+        __m128 clip[4];
+        for ( int row = 0; row < 4; ++row )
+        {
+            __m128 r  = _mm_add_ps( _mm_mul_ps( m[0][row], vx ), _mm_mul_ps( m[1][row], vy ) );
+            r         = _mm_add_ps( r, _mm_mul_ps( m[2][row], vz ) );
+            clip[row] = _mm_add_ps( r, m[3][row] );
+        }
+
+        const __m128 invW = _mm_div_ps( one, clip[3] );
+
+        _mm_storeu_ps( out.clipX + i, clip[0] );
+        _mm_storeu_ps( out.clipY + i, clip[1] );
+        _mm_storeu_ps( out.clipZ + i, clip[2] );
+        _mm_storeu_ps( out.clipW + i, clip[3] );
+        _mm_storeu_ps( out.screenX + i, _mm_add_ps( _mm_mul_ps( _mm_mul_ps( clip[0], invW ), scaleX ), offsetX ) );
+        _mm_storeu_ps( out.screenY + i, _mm_add_ps( _mm_mul_ps( _mm_mul_ps( clip[1], invW ), scaleY ), offsetY ) );
+        _mm_storeu_ps( out.screenZ + i, _mm_add_ps( _mm_mul_ps( _mm_mul_ps( clip[2], invW ), scaleZ ), offsetZ ) );
+        _mm_storeu_ps( out.invW + i, invW );
+    }
+#endif
+
+    // Scalar tail (or everything, without SIMD support).
+    for ( ; i < count; ++i )
+        transformVertex( c, x[i], y[i], z[i], out, i );
+}
+}  // namespace
+
+void VertexProcessor::setTransform( const glm::mat4& transform, const Viewport& viewport ) noexcept
+{
+    m_Transform = transform;
+    m_Viewport  = viewport;
+
+    invalidate();
+}
+
+glm::vec4 VertexProcessor::project( const glm::vec4& clipPosition ) const noexcept
+{
+    float                  x, y, z, w, screenX, screenY, screenZ, invW;
+    const TransformOutputs out { &x, &y, &z, &w, &screenX, &screenY, &screenZ, &invW };
+
+    projectVertex( makeConstants( m_Transform, m_Viewport ), clipPosition.x, clipPosition.y, clipPosition.z, clipPosition.w, out, 0 );
+
+    return { screenX, screenY, screenZ, invW };
+}
+
+void VertexProcessor::invalidate() noexcept
+{
+    // Reset the stamps when the generation wraps around, so old stamps can't match the new generation.
+    if ( ++m_Generation == 0u )
+    {
+        std::ranges::fill( m_Stamps, 0u );
+        m_Generation = 1u;
+    }
+}
+
+void VertexProcessor::bind( const VertexPositions& positions )
+{
+    assert( positions.y.size() == positions.size() && positions.z.size() == positions.size() );
+
+    if ( positions.x.data() == m_BoundX && positions.size() == m_BoundSize )
+        return;
+
+    m_BoundX    = positions.x.data();
+    m_BoundSize = positions.size();
+
+    for ( auto* stream: { &m_ClipX, &m_ClipY, &m_ClipZ, &m_ClipW, &m_ScreenX, &m_ScreenY, &m_ScreenZ, &m_InvW } )
+        stream->resize( m_BoundSize );
+
+    m_Stamps.resize( m_BoundSize, 0u );
+
+    invalidate();
+}
+
+void VertexProcessor::transform( const VertexPositions& positions )
+{
+    bind( positions );
+
+    const TransformOutputs out {
+        m_ClipX.data(), m_ClipY.data(), m_ClipZ.data(), m_ClipW.data(), m_ScreenX.data(), m_ScreenY.data(), m_ScreenZ.data(), m_InvW.data(),
+    };
+
+    transformVertices( makeConstants( m_Transform, m_Viewport ), positions.x.data(), positions.y.data(), positions.z.data(), positions.size(), out );
+
+    std::ranges::fill( m_Stamps, m_Generation );
+    m_NumTransformed = positions.size();
+}
+
+void VertexProcessor::transform( const VertexPositions& positions, std::span<const uint32_t> indices )
+{
+    bind( positions );
+
+    // Find the vertices that are not in the cache yet. Mark them immediately, so repeated indices are only added once.
+    m_Misses.clear();
+    for ( uint32_t index: indices )
+    {
+        assert( index < m_BoundSize );
+        if ( m_Stamps[index] != m_Generation )
+        {
+            m_Stamps[index] = m_Generation;
+            m_Misses.push_back( index );
+        }
+    }
+
+    const size_t n   = m_Misses.size();
+    m_NumTransformed = n;
+
+    if ( n == 0 )
+        return;
+
+    // Gather the missed vertices into contiguous streams, so they can be transformed in batches.
+    m_Scratch.resize( n * 11 );
+    float* x = m_Scratch.data();
+    float* y = x + n;
+    float* z = y + n;
+
+    for ( size_t i = 0; i < n; ++i )
+    {
+        x[i] = positions.x[m_Misses[i]];
+        y[i] = positions.y[m_Misses[i]];
+        z[i] = positions.z[m_Misses[i]];
+    }
+
+    float* const           results = z + n;
+    const TransformOutputs out {
+        results, results + n, results + 2 * n, results + 3 * n, results + 4 * n, results + 5 * n, results + 6 * n, results + 7 * n,
+    };
+
+    transformVertices( makeConstants( m_Transform, m_Viewport ), x, y, z, n, out );
+
+    // Scatter the results into the cache.
+    for ( size_t i = 0; i < n; ++i )
+    {
+        const uint32_t index = m_Misses[i];
+
+        m_ClipX[index]   = out.clipX[i];
+        m_ClipY[index]   = out.clipY[i];
+        m_ClipZ[index]   = out.clipZ[i];
+        m_ClipW[index]   = out.clipW[i];
+        m_ScreenX[index] = out.screenX[i];
+        m_ScreenY[index] = out.screenY[i];
+        m_ScreenZ[index] = out.screenZ[i];
+        m_InvW[index]    = out.invW[i];
+    }
+}
@@ -0,0 +1,465 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "Simd.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <bit>  // For std::popcount
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// An array of axis-aligned bounding boxes stored as a structure of arrays (min x, min y, max x, max y).
+/// The batch operations process 8 (AVX) or 4 (SSE) boxes per instruction. Without SIMD support they fall back to scalar code.
+///
+/// The arrays are padded to a multiple of the SIMD width with empty (invalid) boxes, which never intersect anything
+/// and don't contribute to the union of the boxes.
+/// </summary>
+class AABBArray
+{
+public:
+    /// <summary>
+    /// The number of boxes that are processed per instruction.
+    /// </summary>
+    static constexpr size_t SimdWidth = CPPRAST_SIMD_WIDTH;
+
+    AABBArray() = default;
+
+    /// <summary>
+    /// Create an array of empty boxes.
+    /// </summary>
+    /// <param name="size">The number of boxes in the array.</param>
+    explicit AABBArray( size_t size )
+    {
+        resize( size );
+    }
+
+    /// <summary>
+    /// Create an array from a span of boxes.
+    /// </summary>
+    /// <param name="boxes">The boxes to copy into the array.</param>
+    explicit AABBArray( std::span<const AABB> boxes )
+    {
+        resize( boxes.size() );
+        for ( size_t i = 0; i < boxes.size(); ++i )
+            set( i, boxes[i] );
+    }
+
+    /// <summary>
+    /// Resize the array. New boxes are empty.
+    /// </summary>
+    /// <param name="size">The new number of boxes in the array.</param>
+    void resize( size_t size )
+    {
+        const size_t paddedSize = ( size + SimdWidth - 1 ) / SimdWidth * SimdWidth;
+
+        // Reset the padding of the previous size, so that the boxes past the end are empty.
+        for ( size_t i = size; i < m_Size; ++i )
+            set( i, AABB {} );
+
+        m_MinX.resize( paddedSize, std::numeric_limits<float>::max() );
+        m_MinY.resize( paddedSize, std::numeric_limits<float>::max() );
+        m_MaxX.resize( paddedSize, std::numeric_limits<float>::lowest() );
+        m_MaxY.resize( paddedSize, std::numeric_limits<float>::lowest() );
+        m_Size = size;
+    }
+
+    /// <summary>
+    /// Append a box to the end of the array.
+    /// </summary>
+    /// <param name="aabb">The box to append.</param>
+    void push_back( const AABB& aabb )
+    {
+        resize( m_Size + 1 );
+        set( m_Size - 1, aabb );
+    }
+
+    /// <summary>
+    /// Remove all boxes. The allocated memory is kept for reuse.
+    /// </summary>
+    void clear() noexcept
+    {
+        resize( 0 );
+    }
+
+    /// <summary>
+    /// Get the number of boxes in the array.
+    /// </summary>
+    size_t size() const noexcept
+    {
+        return m_Size;
+    }
+
+    /// <summary>
+    /// Check if the array is empty.
+    /// </summary>
+    bool empty() const noexcept
+    {
+        return m_Size == 0;
+    }
+
+    /// <summary>
+    /// Get a box.
+    /// </summary>
+    /// <param name="i">The index of the box.</param>
+    /// <returns>The i'th box.</returns>
+    AABB operator[]( size_t i ) const noexcept
+    {
+        assert( i < m_Size );
+
+        // Don't use the 2-point constructor, it would turn an empty box into an infinite one.
+        AABB aabb;
+        aabb.min = { m_MinX[i], m_MinY[i] };
+        aabb.max = { m_MaxX[i], m_MaxY[i] };
+
+        return aabb;
+    }
+
+    /// <summary>
+    /// Set a box.
+    /// </summary>
+    /// <param name="i">The index of the box.</param>
+    /// <param name="aabb">The new value of the box.</param>
+    void set( size_t i, const AABB& aabb ) noexcept
+    {
+        assert( i < m_MinX.size() );
+        m_MinX[i] = aabb.min.x;
+        m_MinY[i] = aabb.min.y;
+        m_MaxX[i] = aabb.max.x;
+        m_MaxY[i] = aabb.max.y;
+    }
+
+    /// <summary>
+    /// Test every box against a single box (for example, the view or clip rectangle).
+    /// The test is inclusive, like <see cref="AABB::intersect"/>.
+    /// </summary>
+    /// <param name="box">The box to test against.</param>
+    /// <param name="mask">Receives one bit per box (bit i % 64 of word i / 64). Must contain at least (size() + 63) / 64 words.</param>
+    /// <returns>The number of boxes that intersect the box.</returns>
+    size_t intersect( const AABB& box, std::span<uint64_t> mask ) const noexcept
+    {
+        assert( mask.size() >= ( m_Size + 63 ) / 64 );
+
+        std::ranges::fill( mask.first( ( m_Size + 63 ) / 64 ), uint64_t { 0 } );
+
+        size_t count = 0;
+#if CPPRAST_SIMD_WIDTH == 8
+        const __m256 boxMinX = _mm256_set1_ps( box.min.x );
+        const __m256 boxMinY = _mm256_set1_ps( box.min.y );
+        const __m256 boxMaxX = _mm256_set1_ps( box.max.x );
+        const __m256 boxMaxY = _mm256_set1_ps( box.max.y );
+
+        for ( size_t i = 0; i < m_Size; i += 8 )
+        {
+            __m256 r = _mm256_cmp_ps( _mm256_loadu_ps( &m_MinX[i] ), boxMaxX, _CMP_LE_OQ );
+            r        = _mm256_and_ps( r, _mm256_cmp_ps( _mm256_loadu_ps( &m_MinY[i] ), boxMaxY, _CMP_LE_OQ ) );
+            r        = _mm256_and_ps( r, _mm256_cmp_ps( _mm256_loadu_ps( &m_MaxX[i] ), boxMinX, _CMP_GE_OQ ) );
+            r        = _mm256_and_ps( r, _mm256_cmp_ps( _mm256_loadu_ps( &m_MaxY[i] ), boxMinY, _CMP_GE_OQ ) );
+
+            const auto bits = static_cast<uint64_t>( _mm256_movemask_ps( r ) );
+            mask[i / 64] |= bits << ( i % 64 );
+        }
+#elif CPPRAST_SIMD_WIDTH == 4
+        const __m128 boxMinX = _mm_set1_ps( box.min.x );
+        const __m128 boxMinY = _mm_set1_ps( box.min.y );
+        const __m128 boxMaxX = _mm_set1_ps( box.max.x );
+        const __m128 boxMaxY = _mm_set1_ps( box.max.y );
+
+        for ( size_t i = 0; i < m_Size; i += 4 )
+        {
+            __m128 r = _mm_cmple_ps( _mm_loadu_ps( &m_MinX[i] ), boxMaxX );
+            r        = _mm_and_ps( r, _mm_cmple_ps( _mm_loadu_ps( &m_MinY[i] ), boxMaxY ) );
+            r        = _mm_and_ps( r, _mm_cmpge_ps( _mm_loadu_ps( &m_MaxX[i] ), boxMinX ) );
+            r        = _mm_and_ps( r, _mm_cmpge_ps( _mm_loadu_ps( &m_MaxY[i] ), boxMinY ) );
+
+            const auto bits = static_cast<uint64_t>( _mm_movemask_ps( r ) );
+            mask[i / 64] |= bits << ( i % 64 );
+        }
+#else
+        for ( size_t i = 0; i < m_Size; ++i )
+        {
+            const bool hit = m_MinX[i] <= box.max.x && m_MinY[i] <= box.max.y && m_MaxX[i] >= box.min.x && m_MaxY[i] >= box.min.y;
+            mask[i / 64] |= static_cast<uint64_t>( hit ) << ( i % 64 );
+        }
+#endif
+        // Clear the bits of the padding boxes (they could only be set by a box that spans the entire float range).
+        if ( m_Size % 64 != 0 )
+            mask[m_Size / 64] &= ( uint64_t { 1 } << ( m_Size % 64 ) ) - 1;
+
+        for ( size_t w = 0; w < ( m_Size + 63 ) / 64; ++w )
+            count += static_cast<size_t>( std::popcount( mask[w] ) );
+
+        return count;
+    }
+
+    /// <summary>
+    /// Translate every box by the same offset.
+    /// </summary>
+    /// <param name="offset">The amount to translate the boxes by.</param>
+    void translate( const glm::vec2& offset ) noexcept
+    {
+        const size_t n = m_MinX.size();
+#if CPPRAST_SIMD_WIDTH == 8
+        const __m256 dx = _mm256_set1_ps( offset.x );
+        const __m256 dy = _mm256_set1_ps( offset.y );
+        for ( size_t i = 0; i < n; i += 8 )
+        {
+            _mm256_storeu_ps( &m_MinX[i], _mm256_add_ps( _mm256_loadu_ps( &m_MinX[i] ), dx ) );
+            _mm256_storeu_ps( &m_MinY[i], _mm256_add_ps( _mm256_loadu_ps( &m_MinY[i] ), dy ) );
+            _mm256_storeu_ps( &m_MaxX[i], _mm256_add_ps( _mm256_loadu_ps( &m_MaxX[i] ), dx ) );
+            _mm256_storeu_ps( &m_MaxY[i], _mm256_add_ps( _mm256_loadu_ps( &m_MaxY[i] ), dy ) );
+        }
+#elif CPPRAST_SIMD_WIDTH == 4
+        const __m128 dx = _mm_set1_ps( offset.x );
+        const __m128 dy = _mm_set1_ps( offset.y );
+        for ( size_t i = 0; i < n; i += 4 )
+        {
+            _mm_storeu_ps( &m_MinX[i], _mm_add_ps( _mm_loadu_ps( &m_MinX[i] ), dx ) );
+            _mm_storeu_ps( &m_MinY[i], _mm_add_ps( _mm_loadu_ps( &m_MinY[i] ), dy ) );
+            _mm_storeu_ps( &m_MaxX[i], _mm_add_ps( _mm_loadu_ps( &m_MaxX[i] ), dx ) );
+            _mm_storeu_ps( &m_MaxY[i], _mm_add_ps( _mm_loadu_ps( &m_MaxY[i] ), dy ) );
+        }
+#else
+        for ( size_t i = 0; i < n; ++i )
+        {
+            m_MinX[i] += offset.x;
+            m_MinY[i] += offset.y;
+            m_MaxX[i] += offset.x;
+            m_MaxY[i] += offset.y;
+        }
+#endif
+        // Translating the padding boxes by a finite amount leaves them empty (min > max), but keep them exact.
+        resetPadding();
+    }
+
+    /// <summary>
+    /// Translate every box by its own offset.
+    /// </summary>
+    /// <param name="offsets">The amount to translate each box by. Must contain size() offsets.</param>
+    void translate( std::span<const glm::vec2> offsets ) noexcept
+    {
+        assert( offsets.size() == m_Size );
+
+        // The offsets are interleaved (x, y), so the boxes are updated in scalar code which the compiler can vectorize.
+        for ( size_t i = 0; i < m_Size; ++i )
+        {
+            m_MinX[i] += offsets[i].x;
+            m_MinY[i] += offsets[i].y;
+            m_MaxX[i] += offsets[i].x;
+            m_MaxY[i] += offsets[i].y;
+        }
+    }
+
+    /// <summary>
+    /// Grow (or shrink, if negative) every box by the same amount on each side.
+    /// </summary>
+    /// <param name="amount">The amount to add to each side of the boxes.</param>
+    void expand( const glm::vec2& amount ) noexcept
+    {
+        const size_t n = m_MinX.size();
+#if CPPRAST_SIMD_WIDTH == 8
+        const __m256 dx = _mm256_set1_ps( amount.x );
+        const __m256 dy = _mm256_set1_ps( amount.y );
+        for ( size_t i = 0; i < n; i += 8 )
+        {
+            _mm256_storeu_ps( &m_MinX[i], _mm256_sub_ps( _mm256_loadu_ps( &m_MinX[i] ), dx ) );
+            _mm256_storeu_ps( &m_MinY[i], _mm256_sub_ps( _mm256_loadu_ps( &m_MinY[i] ), dy ) );
+            _mm256_storeu_ps( &m_MaxX[i], _mm256_add_ps( _mm256_loadu_ps( &m_MaxX[i] ), dx ) );
+            _mm256_storeu_ps( &m_MaxY[i], _mm256_add_ps( _mm256_loadu_ps( &m_MaxY[i] ), dy ) );
+        }
+#elif CPPRAST_SIMD_WIDTH == 4
+        const __m128 dx = _mm_set1_ps( amount.x );
+        const __m128 dy = _mm_set1_ps( amount.y );
+        for ( size_t i = 0; i < n; i += 4 )
+        {
+            _mm_storeu_ps( &m_MinX[i], _mm_sub_ps( _mm_loadu_ps( &m_MinX[i] ), dx ) );
+            _mm_storeu_ps( &m_MinY[i], _mm_sub_ps( _mm_loadu_ps( &m_MinY[i] ), dy ) );
+            _mm_storeu_ps( &m_MaxX[i], _mm_add_ps( _mm_loadu_ps( &m_MaxX[i] ), dx ) );
+            _mm_storeu_ps( &m_MaxY[i], _mm_add_ps( _mm_loadu_ps( &m_MaxY[i] ), dy ) );
+        }
+#else
+        for ( size_t i = 0; i < n; ++i )
+        {
+            m_MinX[i] -= amount.x;
+            m_MinY[i] -= amount.y;
+            m_MaxX[i] += amount.x;
+            m_MaxY[i] += amount.y;
+        }
+#endif
+        resetPadding();
+    }
+
+    /// <summary>
+    /// Expand every box to include another box.
+    /// </summary>
+    /// <param name="boxes">The box to include in each box. Must contain size() boxes.</param>
+    void expand( const AABBArray& boxes ) noexcept
+    {
+        assert( boxes.m_Size == m_Size );
+
+        const size_t n = m_MinX.size();
+#if CPPRAST_SIMD_WIDTH == 8
+        for ( size_t i = 0; i < n; i += 8 )
+        {
+            _mm256_storeu_ps( &m_MinX[i], _mm256_min_ps( _mm256_loadu_ps( &m_MinX[i] ), _mm256_loadu_ps( &boxes.m_MinX[i] ) ) );
+            _mm256_storeu_ps( &m_MinY[i], _mm256_min_ps( _mm256_loadu_ps( &m_MinY[i] ), _mm256_loadu_ps( &boxes.m_MinY[i] ) ) );
+            _mm256_storeu_ps( &m_MaxX[i], _mm256_max_ps( _mm256_loadu_ps( &m_MaxX[i] ), _mm256_loadu_ps( &boxes.m_MaxX[i] ) ) );
+            _mm256_storeu_ps( &m_MaxY[i], _mm256_max_ps( _mm256_loadu_ps( &m_MaxY[i] ), _mm256_loadu_ps( &boxes.m_MaxY[i] ) ) );
+        }
+#elif CPPRAST_SIMD_WIDTH == 4
+        for ( size_t i = 0; i < n; i += 4 )
+        {
+            _mm_storeu_ps( &m_MinX[i], _mm_min_ps( _mm_loadu_ps( &m_MinX[i] ), _mm_loadu_ps( &boxes.m_MinX[i] ) ) );
+            _mm_storeu_ps( &m_MinY[i], _mm_min_ps( _mm_loadu_ps( &m_MinY[i] ), _mm_loadu_ps( &boxes.m_MinY[i] ) ) );
+            _mm_storeu_ps( &m_MaxX[i], _mm_max_ps( _mm_loadu_ps( &m_MaxX[i] ), _mm_loadu_ps( &boxes.m_MaxX[i] ) ) );
+            _mm_storeu_ps( &m_MaxY[i], _mm_max_ps( _mm_loadu_ps( &m_MaxY[i] ), _mm_loadu_ps( &boxes.m_MaxY[i] ) ) );
+        }
+#else
+        for ( size_t i = 0; i < n; ++i )
+        {
+            m_MinX[i] = std::min( m_MinX[i], boxes.m_MinX[i] );
+            m_MinY[i] = std::min( m_MinY[i], boxes.m_MinY[i] );
+            m_MaxX[i] = std::max( m_MaxX[i], boxes.m_MaxX[i] );
+            m_MaxY[i] = std::max( m_MaxY[i], boxes.m_MaxY[i] );
+        }
+#endif
+    }
+
+    /// <summary>
+    /// Compute the union of a range of boxes.
+    /// </summary>
+    /// <param name="first">The index of the first box.</param>
+    /// <param name="count">The number of boxes.</param>
+    /// <returns>The smallest AABB that contains every box in the range (an empty AABB if the range is empty).</returns>
+    AABB getBounds( size_t first, size_t count ) const noexcept
+    {
+        assert( first + count <= m_Size );
+
+        size_t i    = first;
+        size_t last = first + count;
+        AABB   bounds;
+
+        // Scalar head until the index is a multiple of the SIMD width.
+        for ( ; i < last && i % SimdWidth != 0; ++i )
+            bounds.expand( ( *this )[i] );
+
+#if CPPRAST_SIMD_WIDTH == 8
+        __m256 minX = _mm256_set1_ps( bounds.min.x );
+        __m256 minY = _mm256_set1_ps( bounds.min.y );
+        __m256 maxX = _mm256_set1_ps( bounds.max.x );
+        __m256 maxY = _mm256_set1_ps( bounds.max.y );
+
+        for ( ; i + 8 <= last; i += 8 )
+        {
+            minX = _mm256_min_ps( minX, _mm256_loadu_ps( &m_MinX[i] ) );
+            minY = _mm256_min_ps( minY, _mm256_loadu_ps( &m_MinY[i] ) );
+            maxX = _mm256_max_ps( maxX, _mm256_loadu_ps( &m_MaxX[i] ) );
+            maxY = _mm256_max_ps( maxY, _mm256_loadu_ps( &m_MaxY[i] ) );
+        }
+
+        alignas( 32 ) float lanes[4][8];
+        _mm256_store_ps( lanes[0], minX );
+        _mm256_store_ps( lanes[1], minY );
+        _mm256_store_ps( lanes[2], maxX );
+        _mm256_store_ps( lanes[3], maxY );
+        for ( int l = 0; l < 8; ++l )
+        {
+            bounds.min = glm::min( bounds.min, glm::vec2 { lanes[0][l], lanes[1][l] } );
+            bounds.max = glm::max( bounds.max, glm::vec2 { lanes[2][l], lanes[3][l] } );
+        }
+#elif CPPRAST_SIMD_WIDTH == 4
+        __m128 minX = _mm_set1_ps( bounds.min.x );
+        __m128 minY = _mm_set1_ps( bounds.min.y );
+        __m128 maxX = _mm_set1_ps( bounds.max.x );
+        __m128 maxY = _mm_set1_ps( bounds.max.y );
+
+        for ( ; i + 4 <= last; i += 4 )
+        {
+            minX = _mm_min_ps( minX, _mm_loadu_ps( &m_MinX[i] ) );
+            minY = _mm_min_ps( minY, _mm_loadu_ps( &m_MinY[i] ) );
+            maxX = _mm_max_ps( maxX, _mm_loadu_ps( &m_MaxX[i] ) );
+            maxY = _mm_max_ps( maxY, _mm_loadu_ps( &m_MaxY[i] ) );
+        }
+
+        alignas( 16 ) float lanes[4][4];
+        _mm_store_ps( lanes[0], minX );
+        _mm_store_ps( lanes[1], minY );
+        _mm_store_ps( lanes[2], maxX );
+        _mm_store_ps( lanes[3], maxY );
+        for ( int l = 0; l < 4; ++l )
+        {
+            bounds.min = glm::min( bounds.min, glm::vec2 { lanes[0][l], lanes[1][l] } );
+            bounds.max = glm::max( bounds.max, glm::vec2 { lanes[2][l], lanes[3][l] } );
+        }
+#endif
+        // Scalar tail.
+        for ( ; i < last; ++i )
+            bounds.expand( ( *this )[i] );
+
+        return bounds;
+    }
+
+    /// <summary>
+    /// Compute the union of all boxes.
+    /// </summary>
+    AABB getBounds() const noexcept
+    {
+        return getBounds( 0, m_Size );
+    }
+
+    /// <summary>
+    /// Get the minimum x coordinates of the boxes (including the padding).
+    /// </summary>
+    std::span<const float> getMinX() const noexcept
+    {
+        return m_MinX;
+    }
+
+    /// <summary>
+    /// Get the minimum y coordinates of the boxes (including the padding).
+    /// </summary>
+    std::span<const float> getMinY() const noexcept
+    {
+        return m_MinY;
+    }
+
+    /// <summary>
+    /// Get the maximum x coordinates of the boxes (including the padding).
+    /// </summary>
+    std::span<const float> getMaxX() const noexcept
+    {
+        return m_MaxX;
+    }
+
+    /// <summary>
+    /// Get the maximum y coordinates of the boxes (including the padding).
+    /// </summary>
+    std::span<const float> getMaxY() const noexcept
+    {
+        return m_MaxY;
+    }
+
+private:
+    void resetPadding() noexcept
+    {
+        for ( size_t i = m_Size; i < m_MinX.size(); ++i )
+            set( i, AABB {} );
+    }
+
+    size_t             m_Size = 0u;
+    std::vector<float> m_MinX;
+    std::vector<float> m_MinY;
+    std::vector<float> m_MaxX;
+    std::vector<float> m_MaxY;
+};
+}  // namespace math
+}  // namespace cpprast
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>  // For std::ranges::fill
+#include <bit>        // For std::countr_zero
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A 2D grid of bits. Each row is padded to a whole number of 64-bit words
+/// so rows can be scanned a word (64 cells) at a time.
+/// </summary>
+class BitGrid
+{
+public:
+    /// <summary>
+    /// Default constructor. Creates an empty 0x0 grid.
+    /// </summary>
+    BitGrid() = default;
+
+    /// <summary>
+    /// Create a grid with the given dimensions.
+    /// </summary>
+    /// <param name="width">The number of columns in the grid.</param>
+    /// <param name="height">The number of rows in the grid.</param>
+    /// <param name="value">(Optional) The initial value of every cell. Default: false.</param>
+    BitGrid( uint32_t width, uint32_t height, bool value = false )
+    : m_Width { width }
+    , m_Height { height }
+    , m_WordsPerRow { ( width + 63u ) / 64u }
+    , m_Words( static_cast<size_t>( m_WordsPerRow ) * height, 0 )
+    {
+        fill( value );
+    }
+
+    /// <summary>
+    /// Get the value of a cell. Out-of-bounds cells are `false`.
+    /// </summary>
+    /// <param name="x">The column of the cell.</param>
+    /// <param name="y">The row of the cell.</param>
+    /// <returns>The value of the cell.</returns>
+    bool get( int x, int y ) const noexcept
+    {
+        if ( x < 0 || y < 0 || static_cast<uint32_t>( x ) >= m_Width || static_cast<uint32_t>( y ) >= m_Height )
+            return false;
+
+        return ( row( static_cast<uint32_t>( y ) )[x >> 6] >> ( x & 63 ) ) & 1u;
+    }
+
+    /// <summary>
+    /// Set the value of a cell.
+    /// </summary>
+    /// <param name="x">The column of the cell.</param>
+    /// <param name="y">The row of the cell.</param>
+    /// <param name="value">The new value of the cell.</param>
+    void set( uint32_t x, uint32_t y, bool value ) noexcept
+    {
+        assert( x < m_Width );
+        assert( y < m_Height );
+
+        const uint64_t bit  = uint64_t { 1 } << ( x & 63 );
+        uint64_t&      word = m_Words[static_cast<size_t>( y ) * m_WordsPerRow + ( x >> 6 )];
+
+        word = value ? word | bit : word & ~bit;
+    }
+
+    /// <summary>
+    /// Set every cell of the grid to the same value.
+    /// </summary>
+    /// <param name="value">The new value of the cells.</param>
+    void fill( bool value ) noexcept
+    {
+        std::ranges::fill( m_Words, value ? ~uint64_t { 0 } : uint64_t { 0 } );
+
+        // Keep the padding bits at the end of each row cleared.
+        if ( value && ( m_Width & 63 ) != 0 )
+        {
+            const uint64_t lastWordMask = ( uint64_t { 1 } << ( m_Width & 63 ) ) - 1;
+            for ( uint32_t y = 0; y < m_Height; ++y )
+                m_Words[static_cast<size_t>( y ) * m_WordsPerRow + m_WordsPerRow - 1] &= lastWordMask;
+        }
+    }
+
+    /// <summary>
+    /// Check if any cell in a rectangular region is set.
+    /// The region is clamped to the bounds of the grid.
+    /// </summary>
+    /// <param name="x0">The first column of the region.</param>
+    /// <param name="y0">The first row of the region.</param>
+    /// <param name="x1">The last column of the region (inclusive).</param>
+    /// <param name="y1">The last row of the region (inclusive).</param>
+    /// <returns>true if any cell in the region is set.</returns>
+    bool any( int x0, int y0, int x1, int y1 ) const noexcept
+    {
+        bool found = false;
+        forEachSet( x0, y0, x1, y1, [&found]( uint32_t, uint32_t ) {
+            found = true;
+            return false;
+        } );
+
+        return found;
+    }
+
+    /// <summary>
+    /// Invoke a function for every set cell in a rectangular region (in row-major order).
+    /// The region is clamped to the bounds of the grid. Empty words are skipped 64 cells at a time.
+    /// </summary>
+    /// <param name="x0">The first column of the region.</param>
+    /// <param name="y0">The first row of the region.</param>
+    /// <param name="x1">The last column of the region (inclusive).</param>
+    /// <param name="y1">The last row of the region (inclusive).</param>
+    /// <param name="func">The function to invoke with the column and row of each set cell. Return `false` to stop iterating.</param>
+    template<typename Func>
+    void forEachSet( int x0, int y0, int x1, int y1, Func&& func ) const
+    {
+        x0 = std::max( x0, 0 );
+        y0 = std::max( y0, 0 );
+        x1 = std::min( x1, static_cast<int>( m_Width ) - 1 );
+        y1 = std::min( y1, static_cast<int>( m_Height ) - 1 );
+
+        if ( x0 > x1 || y0 > y1 )
+            return;
+
+        const uint32_t firstWord = static_cast<uint32_t>( x0 ) >> 6;
+        const uint32_t lastWord  = static_cast<uint32_t>( x1 ) >> 6;
+        const uint64_t firstMask = ~uint64_t { 0 } << ( x0 & 63 );
+        const uint64_t lastMask  = ~uint64_t { 0 } >> ( 63 - ( x1 & 63 ) );
+
+        for ( uint32_t y = static_cast<uint32_t>( y0 ); y <= static_cast<uint32_t>( y1 ); ++y )
+        {
+            const uint64_t* words = row( y );
+            for ( uint32_t w = firstWord; w <= lastWord; ++w )
+            {
+                uint64_t word = words[w];
+                if ( w == firstWord )
+                    word &= firstMask;
+                if ( w == lastWord )
+                    word &= lastMask;
+
+                while ( word )
+                {
+                    const uint32_t x = w * 64 + static_cast<uint32_t>( std::countr_zero( word ) );
+                    if ( !func( x, y ) )
+                        return;
+
+                    word &= word - 1;  // Clear the lowest set bit.
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Get the words of a row of the grid.
+    /// </summary>
+    /// <param name="y">The row to retrieve.</param>
+    /// <returns>A pointer to the first word of the row.</returns>
+    const uint64_t* row( uint32_t y ) const noexcept
+    {
+        assert( y < m_Height );
+        return m_Words.data() + static_cast<size_t>( y ) * m_WordsPerRow;
+    }
+
+    /// <summary>
+    /// Get the number of columns in the grid.
+    /// </summary>
+    uint32_t getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    /// <summary>
+    /// Get the number of rows in the grid.
+    /// </summary>
+    uint32_t getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Get the number of 64-bit words used to store a single row.
+    /// </summary>
+    uint32_t getWordsPerRow() const noexcept
+    {
+        return m_WordsPerRow;
+    }
+
+    /// <summary>
+    /// Get all words of the grid.
+    /// </summary>
+    std::span<const uint64_t> getWords() const noexcept
+    {
+        return m_Words;
+    }
+
+private:
+    uint32_t              m_Width       = 0u;
+    uint32_t              m_Height      = 0u;
+    uint32_t              m_WordsPerRow = 0u;
+    std::vector<uint64_t> m_Words;
+};
+}  // namespace math
+}  // namespace cpprast
@@ -0,0 +1,606 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "Rect.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <compare>   // For operator<=>
+#include <concepts>  // For std::integral, std::floating_point
+#include <cstdint>   // For int32_t, int64_t
+#include <limits>
+#include <utility>   // For std::cmp_less, std::cmp_greater
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A signed fixed-point number stored in a 32-bit integer.
+/// The lower FracBits bits store the fraction, the remaining bits store the (two's complement) integer part.
+///
+/// Fixed-point arithmetic is exact and doesn't depend on the floating-point mode of the compiler or CPU,
+/// so the results of the rasterizer are bit-reproducible across machines.
+/// </summary>
+/// <typeparam name="FracBits">The number of fractional bits.</typeparam>
+template<int FracBits>
+class Fixed
+{
+public:
+    static_assert( FracBits > 0 && FracBits < 31, "The number of fractional bits must be in the range [1 ... 30]." );
+
+    /// <summary>
+    /// The number of fractional bits.
+    /// </summary>
+    static constexpr int FractionalBits = FracBits;
+
+    /// <summary>
+    /// The raw value of 1.
+    /// </summary>
+    static constexpr int32_t One = int32_t { 1 } << FracBits;
+
+    /// <summary>
+    /// The raw value of the fractional bits.
+    /// </summary>
+    static constexpr int32_t FractionMask = One - 1;
+
+    /// <summary>
+    /// Default constructor. Creates 0.
+    /// </summary>
+    constexpr Fixed() noexcept = default;
+
+    /// <summary>
+    /// Construct a fixed-point number from an integer.
+    /// Values outside of the range of the fixed-point number saturate to <see cref="lowest"/> or <see cref="max"/>.
+    /// </summary>
+    /// <param name="value">The integer value.</param>
+    template<std::integral T>
+    constexpr explicit Fixed( T value ) noexcept
+    : m_Raw { saturateInteger( value ) }
+    {}
+
+    /// <summary>
+    /// Construct a fixed-point number from a floating-point number. The value is rounded to the nearest fixed-point value.
+    /// Values outside of the range of the fixed-point number saturate to <see cref="lowest"/> or <see cref="max"/> (NaN converts to 0).
+    /// Use <see cref="isRepresentable"/> to check the range.
+    /// </summary>
+    /// <param name="value">The floating-point value.</param>
+    template<std::floating_point T>
+    constexpr explicit Fixed( T value ) noexcept
+    : m_Raw { saturate( scale( value ) ) }
+    {}
+
+    /// <summary>
+    /// Convert a fixed-point number with a different number of fractional bits.
+    /// Converting to fewer fractional bits rounds towards negative infinity.
+    /// </summary>
+    /// <param name="other">The fixed-point number to convert.</param>
+    template<int OtherFracBits>
+    constexpr explicit Fixed( Fixed<OtherFracBits> other ) noexcept
+    {
+        if constexpr ( OtherFracBits > FracBits )
+            m_Raw = other.raw() >> ( OtherFracBits - FracBits );
+        else
+            m_Raw = static_cast<int32_t>( static_cast<uint32_t>( other.raw() ) << ( FracBits - OtherFracBits ) );
+    }
+
+    /// <summary>
+    /// Create a fixed-point number from its raw (scaled) value.
+    /// </summary>
+    /// <param name="raw">The raw value.</param>
+    /// <returns>The fixed-point number.</returns>
+    static constexpr Fixed fromRaw( int32_t raw ) noexcept
+    {
+        Fixed f;
+        f.m_Raw = raw;
+        return f;
+    }
+
+    /// <summary>
+    /// Check if a floating-point number can be converted without saturating.
+    /// </summary>
+    /// <param name="value">The floating-point value.</param>
+    /// <returns>true if the rounded value is in the range of the fixed-point number.</returns>
+    template<std::floating_point T>
+    static constexpr bool isRepresentable( T value ) noexcept
+    {
+        const double scaled = scale( value );
+        return scaled > MinScaled && scaled < MaxScaled;
+    }
+
+    /// <summary>
+    /// Get the raw (scaled) value.
+    /// </summary>
+    constexpr int32_t raw() const noexcept
+    {
+        return m_Raw;
+    }
+
+    /// <summary>
+    /// Convert to a floating-point number.
+    /// </summary>
+    constexpr float toFloat() const noexcept
+    {
+        return static_cast<float>( m_Raw ) * ( 1.0f / static_cast<float>( One ) );
+    }
+
+    /// <summary>
+    /// Round towards negative infinity.
+    /// </summary>
+    constexpr int floor() const noexcept
+    {
+        return m_Raw >> FracBits;
+    }
+
+    /// <summary>
+    /// Round towards positive infinity.
+    /// </summary>
+    constexpr int ceil() const noexcept
+    {
+        return static_cast<int32_t>( ( static_cast<int64_t>( m_Raw ) + FractionMask ) >> FracBits );
+    }
+
+    /// <summary>
+    /// Round to the nearest integer (halfway values are rounded up).
+    /// </summary>
+    constexpr int round() const noexcept
+    {
+        return static_cast<int32_t>( ( static_cast<int64_t>( m_Raw ) + ( One >> 1 ) ) >> FracBits );
+    }
+
+    /// <summary>
+    /// Get the fractional part. The result is always in the range [0 ... 1).
+    /// </summary>
+    constexpr Fixed frac() const noexcept
+    {
+        return fromRaw( m_Raw & FractionMask );
+    }
+
+    /// <summary>
+    /// Convert to an integer by rounding towards negative infinity.
+    /// </summary>
+    constexpr explicit operator int() const noexcept
+    {
+        return floor();
+    }
+
+    /// <summary>
+    /// Convert to a floating-point number.
+    /// </summary>
+    constexpr explicit operator float() const noexcept
+    {
+        return toFloat();
+    }
+
+    constexpr auto operator<=>( const Fixed& ) const noexcept = default;
+
+    constexpr Fixed operator-() const noexcept
+    {
+        return fromRaw( -m_Raw );
+    }
+
+    constexpr Fixed operator+( Fixed rhs ) const noexcept
+    {
+        return fromRaw( m_Raw + rhs.m_Raw );
+    }
+
+    constexpr Fixed operator-( Fixed rhs ) const noexcept
+    {
+        return fromRaw( m_Raw - rhs.m_Raw );
+    }
+
+    /// <summary>
+    /// Multiply two fixed-point numbers. The product is computed with 64-bit precision and rounded towards negative infinity.
+    /// </summary>
+    constexpr Fixed operator*( Fixed rhs ) const noexcept
+    {
+        return fromRaw( static_cast<int32_t>( ( static_cast<int64_t>( m_Raw ) * rhs.m_Raw ) >> FracBits ) );
+    }
+
+    /// <summary>
+    /// Divide two fixed-point numbers. The quotient is computed with 64-bit precision and rounded towards 0.
+    /// </summary>
+    constexpr Fixed operator/( Fixed rhs ) const noexcept
+    {
+        return fromRaw( static_cast<int32_t>( ( static_cast<int64_t>( m_Raw ) * One ) / rhs.m_Raw ) );
+    }
+
+    /// <summary>
+    /// Multiply by an integer. The product is computed with 64-bit precision and saturates to <see cref="lowest"/> or <see cref="max"/>.
+    /// </summary>
+    constexpr Fixed operator*( int rhs ) const noexcept
+    {
+        return fromRaw( saturate( static_cast<int64_t>( m_Raw ) * rhs ) );
+    }
+
+    constexpr Fixed operator/( int rhs ) const noexcept
+    {
+        return fromRaw( m_Raw / rhs );
+    }
+
+    constexpr Fixed& operator+=( Fixed rhs ) noexcept
+    {
+        return *this = *this + rhs;
+    }
+
+    constexpr Fixed& operator-=( Fixed rhs ) noexcept
+    {
+        return *this = *this - rhs;
+    }
+
+    constexpr Fixed& operator*=( Fixed rhs ) noexcept
+    {
+        return *this = *this * rhs;
+    }
+
+    constexpr Fixed& operator/=( Fixed rhs ) noexcept
+    {
+        return *this = *this / rhs;
+    }
+
+    constexpr Fixed& operator*=( int rhs ) noexcept
+    {
+        return *this = *this * rhs;
+    }
+
+    constexpr Fixed& operator/=( int rhs ) noexcept
+    {
+        return *this = *this / rhs;
+    }
+
+    /// <summary>
+    /// The largest representable value.
+    /// </summary>
+    static constexpr Fixed max() noexcept
+    {
+        return fromRaw( std::numeric_limits<int32_t>::max() );
+    }
+
+    /// <summary>
+    /// The smallest (most negative) representable value.
+    /// </summary>
+    static constexpr Fixed lowest() noexcept
+    {
+        return fromRaw( std::numeric_limits<int32_t>::lowest() );
+    }
+
+private:
+    // The scaled values that round to one past the range of the raw value. Every 32-bit integer is exact in double.
+    static constexpr double MinScaled = static_cast<double>( std::numeric_limits<int32_t>::lowest() ) - 1.0;
+    static constexpr double MaxScaled = static_cast<double>( std::numeric_limits<int32_t>::max() ) + 1.0;
+
+    // The range of integers that can be converted without saturating.
+    static constexpr int32_t MinInteger = std::numeric_limits<int32_t>::lowest() >> FracBits;
+    static constexpr int32_t MaxInteger = std::numeric_limits<int32_t>::max() >> FracBits;
+
+    // Scale a floating-point number to the raw range, and offset it so truncating it rounds to the nearest value.
+    template<std::floating_point T>
+    static constexpr double scale( T value ) noexcept
+    {
+        return static_cast<double>( value ) * One + ( value < T( 0 ) ? -0.5 : 0.5 );
+    }
+
+    // Convert a scaled value to a raw value, saturating values that are out of range.
+    static constexpr int32_t saturate( double scaled ) noexcept
+    {
+        if ( scaled <= MinScaled )
+            return std::numeric_limits<int32_t>::lowest();
+        if ( scaled >= MaxScaled )
+            return std::numeric_limits<int32_t>::max();
+        if ( scaled != scaled )  // NaN
+            return 0;
+
+        return static_cast<int32_t>( scaled );
+    }
+
+    // Convert an integer to a raw value, saturating values that are out of range.
+    template<std::integral T>
+    static constexpr int32_t saturateInteger( T value ) noexcept
+    {
+        if ( std::cmp_less( value, MinInteger ) )
+            return std::numeric_limits<int32_t>::lowest();
+        if ( std::cmp_greater( value, MaxInteger ) )
+            return std::numeric_limits<int32_t>::max();
+
+        return static_cast<int32_t>( static_cast<uint32_t>( value ) << FracBits );
+    }
+
+    // Clamp a 64-bit raw value to the range of the raw value.
+    static constexpr int32_t saturate( int64_t raw ) noexcept
+    {
+        if ( raw < std::numeric_limits<int32_t>::lowest() )
+            return std::numeric_limits<int32_t>::lowest();
+        if ( raw > std::numeric_limits<int32_t>::max() )
+            return std::numeric_limits<int32_t>::max();
+
+        return static_cast<int32_t>( raw );
+    }
+
+    int32_t m_Raw = 0;
+};
+
+template<int FracBits>
+constexpr Fixed<FracBits> operator*( int lhs, Fixed<FracBits> rhs ) noexcept
+{
+    return rhs * lhs;
+}
+
+/// <summary>
+/// A 2D vector of fixed-point numbers.
+/// </summary>
+/// <typeparam name="FracBits">The number of fractional bits.</typeparam>
+template<int FracBits>
+struct FixedVec2
+{
+    using value_type = Fixed<FracBits>;
+
+    /// <summary>
+    /// Default constructor. Creates (0, 0).
+    /// </summary>
+    constexpr FixedVec2() noexcept = default;
+
+    constexpr FixedVec2( value_type x, value_type y ) noexcept
+    : x { x }
+    , y { y }
+    {}
+
+    /// <summary>
+    /// Construct a fixed-point vector from an integer vector. Components outside of the range of the fixed-point number saturate.
+    /// </summary>
+    constexpr explicit FixedVec2( const glm::ivec2& v ) noexcept
+    : x { v.x }
+    , y { v.y }
+    {}
+
+    /// <summary>
+    /// Construct a fixed-point vector from a floating-point vector. The components are rounded to the nearest fixed-point value.
+    /// </summary>
+    constexpr explicit FixedVec2( const glm::vec2& v ) noexcept
+    : x { v.x }
+    , y { v.y }
+    {}
+
+    /// <summary>
+    /// Convert a fixed-point vector with a different number of fractional bits.
+    /// </summary>
+    template<int OtherFracBits>
+    constexpr explicit FixedVec2( const FixedVec2<OtherFracBits>& v ) noexcept
+    : x { v.x }
+    , y { v.y }
+    {}
+
+    /// <summary>
+    /// Convert to a floating-point vector.
+    /// </summary>
+    constexpr glm::vec2 toVec2() const noexcept
+    {
+        return { x.toFloat(), y.toFloat() };
+    }
+
+    /// <summary>
+    /// Round the components towards negative infinity.
+    /// </summary>
+    constexpr glm::ivec2 floor() const noexcept
+    {
+        return { x.floor(), y.floor() };
+    }
+
+    /// <summary>
+    /// Round the components towards positive infinity.
+    /// </summary>
+    constexpr glm::ivec2 ceil() const noexcept
+    {
+        return { x.ceil(), y.ceil() };
+    }
+
+    /// <summary>
+    /// Round the components to the nearest integer.
+    /// </summary>
+    constexpr glm::ivec2 round() const noexcept
+    {
+        return { x.round(), y.round() };
+    }
+
+    constexpr bool operator==( const FixedVec2& ) const noexcept = default;
+
+    constexpr FixedVec2 operator-() const noexcept
+    {
+        return { -x, -y };
+    }
+
+    constexpr FixedVec2 operator+( const FixedVec2& rhs ) const noexcept
+    {
+        return { x + rhs.x, y + rhs.y };
+    }
+
+    constexpr FixedVec2 operator-( const FixedVec2& rhs ) const noexcept
+    {
+        return { x - rhs.x, y - rhs.y };
+    }
+
+    constexpr FixedVec2 operator*( value_type rhs ) const noexcept
+    {
+        return { x * rhs, y * rhs };
+    }
+
+    constexpr FixedVec2 operator*( int rhs ) const noexcept
+    {
+        return { x * rhs, y * rhs };
+    }
+
+    constexpr FixedVec2& operator+=( const FixedVec2& rhs ) noexcept
+    {
+        return *this = *this + rhs;
+    }
+
+    constexpr FixedVec2& operator-=( const FixedVec2& rhs ) noexcept
+    {
+        return *this = *this - rhs;
+    }
+
+    value_type x;
+    value_type y;
+};
+
+/// <summary>
+/// The 2D cross product (the z component of the 3D cross product) of two fixed-point vectors.
+/// The result is computed with 64-bit precision and has 2 * FracBits fractional bits, so it is exact.
+/// This is the edge function of the triangle rasterizer.
+/// </summary>
+/// <param name="a">The first vector.</param>
+/// <param name="b">The second vector.</param>
+/// <returns>The raw cross product with 2 * FracBits fractional bits.</returns>
+template<int FracBits>
+constexpr int64_t cross( const FixedVec2<FracBits>& a, const FixedVec2<FracBits>& b ) noexcept
+{
+    return static_cast<int64_t>( a.x.raw() ) * b.y.raw() - static_cast<int64_t>( a.y.raw() ) * b.x.raw();
+}
+
+/// <summary>
+/// An axis-aligned bounding box with fixed-point coordinates.
+/// </summary>
+/// <typeparam name="FracBits">The number of fractional bits.</typeparam>
+template<int FracBits>
+struct FixedAABB
+{
+    using value_type = Fixed<FracBits>;
+    using vec_type   = FixedVec2<FracBits>;
+
+    /// <summary>
+    /// Default constructor. Creates an empty (invalid) AABB.
+    /// </summary>
+    constexpr FixedAABB() noexcept = default;
+
+    /// <summary>
+    /// Construct an axis-aligned bounding box from 2 points.
+    /// </summary>
+    constexpr FixedAABB( const vec_type& a, const vec_type& b ) noexcept
+    : min { a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y }
+    , max { a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y }
+    {}
+
+    /// <summary>
+    /// Construct a fixed-point AABB from a floating-point AABB.
+    /// </summary>
+    constexpr explicit FixedAABB( const AABB& aabb ) noexcept
+    : min { aabb.min }
+    , max { aabb.max }
+    {}
+
+    /// <summary>
+    /// Construct a fixed-point AABB from a rectangle.
+    /// </summary>
+    template<typename T>
+    constexpr explicit FixedAABB( const Rect<T>& rect ) noexcept
+    : min { value_type { rect.left }, value_type { rect.top } }
+    , max { value_type { rect.left + rect.width }, value_type { rect.top + rect.height } }
+    {}
+
+    /// <summary>
+    /// Convert to a floating-point AABB.
+    /// </summary>
+    AABB toAABB() const noexcept
+    {
+        AABB aabb;
+        aabb.min = min.toVec2();
+        aabb.max = max.toVec2();
+        return aabb;
+    }
+
+    /// <summary>
+    /// Check to see if this is a valid AABB. The min point of a valid AABB is less than the max point.
+    /// </summary>
+    constexpr bool isValid() const noexcept
+    {
+        return min.x < max.x && min.y < max.y;
+    }
+
+    constexpr value_type width() const noexcept
+    {
+        return max.x - min.x;
+    }
+
+    constexpr value_type height() const noexcept
+    {
+        return max.y - min.y;
+    }
+
+    /// <summary>
+    /// Expand the AABB to include a given point.
+    /// </summary>
+    constexpr FixedAABB& expand( const vec_type& p ) noexcept
+    {
+        min = { p.x < min.x ? p.x : min.x, p.y < min.y ? p.y : min.y };
+        max = { p.x > max.x ? p.x : max.x, p.y > max.y ? p.y : max.y };
+
+        return *this;
+    }
+
+    /// <summary>
+    /// Return this AABB clamped to another. The result may be invalid if the AABBs don't overlap.
+    /// </summary>
+    constexpr FixedAABB clamped( const FixedAABB& aabb ) const noexcept
+    {
+        FixedAABB result;
+        result.min = { min.x > aabb.min.x ? min.x : aabb.min.x, min.y > aabb.min.y ? min.y : aabb.min.y };
+        result.max = { max.x < aabb.max.x ? max.x : aabb.max.x, max.y < aabb.max.y ? max.y : aabb.max.y };
+        return result;
+    }
+
+    /// <summary>
+    /// Check to see if another AABB intersects with this one.
+    /// </summary>
+    constexpr bool intersect( const FixedAABB& aabb ) const noexcept
+    {
+        return min.x <= aabb.max.x && min.y <= aabb.max.y && max.x >= aabb.min.x && max.y >= aabb.min.y;
+    }
+
+    /// <summary>
+    /// Test whether a point is contained in this AABB.
+    /// </summary>
+    constexpr bool contains( const vec_type& p ) const noexcept
+    {
+        return p.x >= min.x && p.y >= min.y && p.x <= max.x && p.y <= max.y;
+    }
+
+    /// <summary>
+    /// Get the range of pixels whose centers (at x + 0.5, y + 0.5) are inside the AABB, following the top-left rule:
+    /// a pixel center on the min edge is inside, a pixel center on the max edge is outside.
+    /// </summary>
+    /// <returns>The pixel range. The width or height is 0 if no pixel centers are covered.</returns>
+    constexpr RectI getPixelRect() const noexcept
+    {
+        const value_type half = value_type::fromRaw( value_type::One >> 1 );
+
+        const int x0 = ( min.x - half ).ceil();
+        const int y0 = ( min.y - half ).ceil();
+        const int x1 = ( max.x - half ).ceil();
+        const int y1 = ( max.y - half ).ceil();
+
+        return RectI { x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0 };
+    }
+
+    vec_type min { value_type::max(), value_type::max() };
+    vec_type max { value_type::lowest(), value_type::lowest() };
+};
+
+/// <summary>
+/// 16.16 fixed-point number. Used for texture coordinates and their per-pixel gradients.
+/// </summary>
+using Fixed16_16 = Fixed<16>;
+
+/// <summary>
+/// 28.4 fixed-point number. Used for sub-pixel screen positions: 4 bits of sub-pixel precision
+/// leave enough headroom for exact edge functions of triangles with 64-bit intermediates.
+/// </summary>
+using Fixed28_4 = Fixed<4>;
+
+using FixedVec2_16_16 = FixedVec2<16>;
+using FixedVec2_28_4  = FixedVec2<4>;
+using FixedAABB_16_16 = FixedAABB<16>;
+using FixedAABB_28_4  = FixedAABB<4>;
+using FixedRect_16_16 = Rect<Fixed16_16>;
+using FixedRect_28_4  = Rect<Fixed28_4>;
+
+}  // namespace math
+}  // namespace cpprast
@@ -0,0 +1,351 @@
+#pragma once
+
+#include "AABB.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A loose quadtree that stores AABBs with user ids.
+///
+/// The tree is stored implicitly as a grid of nodes per level (level L has 2^L x 2^L nodes).
+/// The bounds of every node are expanded by half the node size on each side (looseness factor 2), so an object
+/// is stored in a single node: the node that contains its center on the deepest level that is at least as large as the object.
+/// Objects that are not contained in the bounds of the tree are kept in a separate list that is tested by every query.
+///
+/// The objects of a node are kept in an intrusive linked list, so once the structure has grown to its working set
+/// inserting, moving and removing objects doesn't allocate memory. Queries don't modify the tree and can run concurrently.
+/// </summary>
+class LooseQuadtree
+{
+public:
+    /// <summary>
+    /// A handle to an object in the quadtree.
+    /// </summary>
+    using Handle = uint32_t;
+
+    static constexpr Handle InvalidHandle = UINT32_MAX;
+
+    /// <summary>
+    /// Create a loose quadtree.
+    /// </summary>
+    /// <param name="bounds">The bounds of the tree (for example, the bounds of the level).</param>
+    /// <param name="maxDepth">(Optional) The deepest level of the tree. Default: 6.</param>
+    explicit LooseQuadtree( const AABB& bounds, uint32_t maxDepth = 6u )
+    : m_Bounds { bounds }
+    , m_MaxDepth { std::min( maxDepth, 12u ) }
+    , m_LevelCounts( m_MaxDepth + 1, 0u )
+    {
+        assert( bounds.isValid() );
+
+        // Level L starts at (4^L - 1) / 3 in the array of nodes.
+        const size_t numNodes = ( ( size_t { 1 } << ( 2 * ( m_MaxDepth + 1 ) ) ) - 1 ) / 3;
+        m_Nodes.resize( numNodes, InvalidHandle );
+    }
+
+    /// <summary>
+    /// Insert an object.
+    /// </summary>
+    /// <param name="aabb">The bounds of the object.</param>
+    /// <param name="userId">The user id that is reported by queries.</param>
+    /// <returns>The handle of the object.</returns>
+    Handle insert( const AABB& aabb, uint32_t userId )
+    {
+        Handle handle;
+        if ( !m_FreeHandles.empty() )
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<Handle>( m_Objects.size() );
+            m_Objects.emplace_back();
+        }
+
+        Object& object = m_Objects[handle];
+        object.aabb    = aabb;
+        object.userId  = userId;
+
+        link( handle, getNode( aabb ) );
+        ++m_Size;
+
+        return handle;
+    }
+
+    /// <summary>
+    /// Move (or resize) an object.
+    /// The object is only relinked if it moved to a different node.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    /// <param name="aabb">The new bounds of the object.</param>
+    void move( Handle handle, const AABB& aabb )
+    {
+        assert( handle < m_Objects.size() && m_Objects[handle].node != FreeNode );
+
+        Object&        object = m_Objects[handle];
+        const uint32_t node   = getNode( aabb );
+
+        object.aabb = aabb;
+
+        if ( node != object.node )
+        {
+            unlink( handle );
+            link( handle, node );
+        }
+    }
+
+    /// <summary>
+    /// Remove an object. The handle may be reused by the next insertion.
+    /// </summary>
+    /// <param name="handle">The handle of the object to remove.</param>
+    void remove( Handle handle )
+    {
+        assert( handle < m_Objects.size() && m_Objects[handle].node != FreeNode );
+
+        unlink( handle );
+        m_Objects[handle].node = FreeNode;
+        m_FreeHandles.push_back( handle );
+        --m_Size;
+    }
+
+    /// <summary>
+    /// Remove all objects. The allocated memory is kept for reuse.
+    /// </summary>
+    void clear() noexcept
+    {
+        std::ranges::fill( m_Nodes, InvalidHandle );
+        std::ranges::fill( m_LevelCounts, 0u );
+        m_Outside = InvalidHandle;
+        m_Objects.clear();
+        m_FreeHandles.clear();
+        m_Size = 0;
+    }
+
+    /// <summary>
+    /// Find all objects that intersect a region.
+    /// </summary>
+    /// <param name="region">The region to search (for example, the view rectangle).</param>
+    /// <param name="func">The function to invoke with the user id of every object that intersects the region.</param>
+    template<typename Func>
+    void query( const AABB& region, Func&& func ) const
+    {
+        forEachIntersecting( region, [&]( Handle handle ) {
+            func( m_Objects[handle].userId );
+        } );
+    }
+
+    /// <summary>
+    /// Find all pairs of objects that intersect each other.
+    /// </summary>
+    /// <param name="func">The function to invoke with the user ids of every pair of intersecting objects.</param>
+    template<typename Func>
+    void forEachPair( Func&& func ) const
+    {
+        for ( Handle a = 0; a < m_Objects.size(); ++a )
+        {
+            const Object& objectA = m_Objects[a];
+            if ( objectA.node == FreeNode )
+                continue;
+
+            // Every pair is found twice (once from each object). Only report it from the object with the lowest handle.
+            forEachIntersecting( objectA.aabb, [&]( Handle b ) {
+                if ( b > a )
+                    func( objectA.userId, m_Objects[b].userId );
+            } );
+        }
+    }
+
+    /// <summary>
+    /// Get the bounds of an object.
+    /// </summary>
+    const AABB& getAABB( Handle handle ) const noexcept
+    {
+        assert( handle < m_Objects.size() );
+        return m_Objects[handle].aabb;
+    }
+
+    /// <summary>
+    /// Get the user id of an object.
+    /// </summary>
+    uint32_t getUserId( Handle handle ) const noexcept
+    {
+        assert( handle < m_Objects.size() );
+        return m_Objects[handle].userId;
+    }
+
+    /// <summary>
+    /// Get the number of objects in the quadtree.
+    /// </summary>
+    size_t size() const noexcept
+    {
+        return m_Size;
+    }
+
+    /// <summary>
+    /// Get the bounds of the quadtree.
+    /// </summary>
+    const AABB& getBounds() const noexcept
+    {
+        return m_Bounds;
+    }
+
+private:
+    static constexpr uint32_t OutsideNode = UINT32_MAX - 1;  // The object is not contained in the bounds of the tree.
+    static constexpr uint32_t FreeNode    = UINT32_MAX;      // The object was removed.
+
+    struct Object
+    {
+        AABB     aabb;
+        uint32_t userId = 0u;
+        uint32_t node   = FreeNode;  // The node that the object is linked to.
+        Handle   prev   = InvalidHandle;
+        Handle   next   = InvalidHandle;
+    };
+
+    static size_t getLevelOffset( uint32_t level ) noexcept
+    {
+        return ( ( size_t { 1 } << ( 2 * level ) ) - 1 ) / 3;
+    }
+
+    static uint32_t getLevel( size_t node ) noexcept
+    {
+        uint32_t level = 0;
+        while ( getLevelOffset( level + 1 ) <= node )
+            ++level;
+
+        return level;
+    }
+
+    glm::vec2 getNodeSize( uint32_t level ) const noexcept
+    {
+        return m_Bounds.size() / static_cast<float>( 1u << level );
+    }
+
+    // Find the node that an object is stored in.
+    uint32_t getNode( const AABB& aabb ) const noexcept
+    {
+        const glm::vec2 center = aabb.center();
+        const glm::vec2 size   = aabb.size();
+
+        if ( !m_Bounds.contains( center ) )
+            return OutsideNode;
+
+        // Find the deepest level where the node is at least as large as the object.
+        uint32_t level = 0;
+        while ( level < m_MaxDepth )
+        {
+            const glm::vec2 nodeSize = getNodeSize( level + 1 );
+            if ( size.x > nodeSize.x || size.y > nodeSize.y )
+                break;
+
+            ++level;
+        }
+
+        const glm::vec2 nodeSize = getNodeSize( level );
+        const int       n        = 1 << level;
+        const int       x        = std::clamp( static_cast<int>( ( center.x - m_Bounds.min.x ) / nodeSize.x ), 0, n - 1 );
+        const int       y        = std::clamp( static_cast<int>( ( center.y - m_Bounds.min.y ) / nodeSize.y ), 0, n - 1 );
+
+        return static_cast<uint32_t>( getLevelOffset( level ) + static_cast<size_t>( y ) * n + x );
+    }
+
+    Handle& getHead( uint32_t node ) noexcept
+    {
+        return node == OutsideNode ? m_Outside : m_Nodes[node];
+    }
+
+    void link( Handle handle, uint32_t node )
+    {
+        Object& object = m_Objects[handle];
+        Handle& head   = getHead( node );
+
+        object.node = node;
+        object.prev = InvalidHandle;
+        object.next = head;
+
+        if ( head != InvalidHandle )
+            m_Objects[head].prev = handle;
+
+        head = handle;
+
+        if ( node != OutsideNode )
+            ++m_LevelCounts[getLevel( node )];
+    }
+
+    void unlink( Handle handle )
+    {
+        Object& object = m_Objects[handle];
+
+        if ( object.prev != InvalidHandle )
+            m_Objects[object.prev].next = object.next;
+        else
+            getHead( object.node ) = object.next;
+
+        if ( object.next != InvalidHandle )
+            m_Objects[object.next].prev = object.prev;
+
+        if ( object.node != OutsideNode )
+            --m_LevelCounts[getLevel( object.node )];
+    }
+
+    template<typename Func>
+    void forEachIntersecting( const AABB& region, Func&& func ) const
+    {
+        for ( Handle h = m_Outside; h != InvalidHandle; h = m_Objects[h].next )
+        {
+            if ( m_Objects[h].aabb.intersect( region ) )
+                func( h );
+        }
+
+        for ( uint32_t level = 0; level <= m_MaxDepth; ++level )
+        {
+            if ( m_LevelCounts[level] == 0 )
+                continue;
+
+            // The loose bounds of a node extend half a node past the node on each side.
+            const glm::vec2 nodeSize = getNodeSize( level );
+            const glm::vec2 first    = glm::floor( ( region.min - m_Bounds.min ) / nodeSize - 0.5f );
+            const glm::vec2 last     = glm::floor( ( region.max - m_Bounds.min ) / nodeSize + 0.5f );
+            const float     n        = static_cast<float>( 1u << level );
+
+            const int x0 = static_cast<int>( std::clamp( first.x, 0.0f, n ) );
+            const int y0 = static_cast<int>( std::clamp( first.y, 0.0f, n ) );
+            const int x1 = static_cast<int>( std::clamp( last.x, -1.0f, n - 1.0f ) );
+            const int y1 = static_cast<int>( std::clamp( last.y, -1.0f, n - 1.0f ) );
+
+            const Handle* nodes = m_Nodes.data() + getLevelOffset( level );
+            for ( int y = y0; y <= y1; ++y )
+            {
+                for ( int x = x0; x <= x1; ++x )
+                {
+                    for ( Handle h = nodes[static_cast<size_t>( y ) * static_cast<size_t>( n ) + x]; h != InvalidHandle; h = m_Objects[h].next )
+                    {
+                        if ( m_Objects[h].aabb.intersect( region ) )
+                            func( h );
+                    }
+                }
+            }
+        }
+    }
+
+    AABB                  m_Bounds;
+    uint32_t              m_MaxDepth;
+    std::vector<uint32_t> m_LevelCounts;  // The number of objects stored on each level. Empty levels are skipped by queries.
+    std::vector<Handle>   m_Nodes;        // The head of the list of objects of every node (all levels).
+    Handle                m_Outside = InvalidHandle;
+    std::vector<Object>   m_Objects;
+    std::vector<Handle>   m_FreeHandles;
+    size_t                m_Size = 0u;
+};
+}  // namespace math
+}  // namespace cpprast
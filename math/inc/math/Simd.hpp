@@ -0,0 +1,14 @@
+#pragma once
+
+// Select the SIMD instruction set for the batch operations of the math and graphics libraries.
+// AVX processes 8 floats per instruction, SSE processes 4. Without SIMD support, the batch operations fall back to scalar code.
+// AVX is enabled with the CPPRAST_ENABLE_AVX2 CMake option (SSE2 is always available on x86-64).
+#if defined( __AVX__ )
+    #include <immintrin.h>
+    #define CPPRAST_SIMD_WIDTH 8
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #include <emmintrin.h>
+    #define CPPRAST_SIMD_WIDTH 4
+#else
+    #define CPPRAST_SIMD_WIDTH 1
+#endif
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "AABB.hpp"
+
+#include <glm/vec2.hpp>
+
+#include <algorithm>
+#include <bit>  // For std::bit_ceil
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A uniform grid of cells, hashed into a fixed number of buckets, that stores AABBs with user ids.
+/// An AABB is stored in every cell it overlaps. Objects that span many cells are better stored in a <see cref="LooseQuadtree"/>.
+///
+/// Every object is reported at most once per query without keeping any per-query state: an object (or a pair of objects)
+/// is only reported from the first cell of the overlap between the cells of the object and the cells of the query.
+/// This makes concurrent queries safe (as long as the structure is not modified at the same time).
+///
+/// Removed objects and cell entries are recycled, so once the structure has grown to its working set
+/// inserting, moving and removing objects doesn't allocate memory.
+/// </summary>
+class SpatialHash
+{
+public:
+    /// <summary>
+    /// A handle to an object in the spatial hash.
+    /// </summary>
+    using Handle = uint32_t;
+
+    static constexpr Handle InvalidHandle = UINT32_MAX;
+
+    /// <summary>
+    /// Create a spatial hash.
+    /// </summary>
+    /// <param name="cellSize">The size of the cells of the grid. Should be about the size of the typical object.</param>
+    /// <param name="numBuckets">(Optional) The number of hash buckets. Rounded up to a power of two. Default: 4096.</param>
+    explicit SpatialHash( float cellSize, uint32_t numBuckets = 4096u )
+    : m_InvCellSize { 1.0f / cellSize }
+    , m_Buckets( std::bit_ceil( std::max( numBuckets, 1u ) ) )
+    {
+        assert( cellSize > 0.0f );
+    }
+
+    /// <summary>
+    /// Insert an object.
+    /// </summary>
+    /// <param name="aabb">The bounds of the object.</param>
+    /// <param name="userId">The user id that is reported by queries.</param>
+    /// <returns>The handle of the object.</returns>
+    Handle insert( const AABB& aabb, uint32_t userId )
+    {
+        Handle handle;
+        if ( !m_FreeHandles.empty() )
+        {
+            handle = m_FreeHandles.back();
+            m_FreeHandles.pop_back();
+        }
+        else
+        {
+            handle = static_cast<Handle>( m_Objects.size() );
+            m_Objects.emplace_back();
+        }
+
+        Object& object = m_Objects[handle];
+        object.aabb    = aabb;
+        object.userId  = userId;
+        object.alive   = true;
+        object.first   = getCell( aabb.min );
+        object.last    = getCell( aabb.max );
+
+        addEntries( handle );
+        ++m_Size;
+
+        return handle;
+    }
+
+    /// <summary>
+    /// Move (or resize) an object.
+    /// The cells of the object are only updated if the object moved to a different set of cells.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    /// <param name="aabb">The new bounds of the object.</param>
+    void move( Handle handle, const AABB& aabb )
+    {
+        assert( handle < m_Objects.size() && m_Objects[handle].alive );
+
+        Object&          object = m_Objects[handle];
+        const glm::ivec2 first  = getCell( aabb.min );
+        const glm::ivec2 last   = getCell( aabb.max );
+
+        object.aabb = aabb;
+
+        if ( first != object.first || last != object.last )
+        {
+            removeEntries( handle );
+            object.first = first;
+            object.last  = last;
+            addEntries( handle );
+        }
+    }
+
+    /// <summary>
+    /// Remove an object. The handle may be reused by the next insertion.
+    /// </summary>
+    /// <param name="handle">The handle of the object to remove.</param>
+    void remove( Handle handle )
+    {
+        assert( handle < m_Objects.size() && m_Objects[handle].alive );
+
+        removeEntries( handle );
+        m_Objects[handle].alive = false;
+        m_FreeHandles.push_back( handle );
+        --m_Size;
+    }
+
+    /// <summary>
+    /// Remove all objects. The allocated memory is kept for reuse.
+    /// </summary>
+    void clear() noexcept
+    {
+        for ( auto& bucket: m_Buckets )
+            bucket.clear();
+
+        m_Objects.clear();
+        m_FreeHandles.clear();
+        m_Size = 0;
+    }
+
+    /// <summary>
+    /// Find all objects that intersect a region.
+    /// </summary>
+    /// <param name="region">The region to search (for example, the view rectangle).</param>
+    /// <param name="func">The function to invoke with the user id of every object that intersects the region.</param>
+    template<typename Func>
+    void query( const AABB& region, Func&& func ) const
+    {
+        const glm::ivec2 first = getCell( region.min );
+        const glm::ivec2 last  = getCell( region.max );
+
+        for ( int y = first.y; y <= last.y; ++y )
+        {
+            for ( int x = first.x; x <= last.x; ++x )
+            {
+                for ( const Entry& entry: m_Buckets[getBucket( x, y )] )
+                {
+                    // The bucket may contain entries of other cells that map to the same bucket.
+                    if ( entry.x != x || entry.y != y )
+                        continue;
+
+                    const Object& object = m_Objects[entry.handle];
+
+                    // Only report the object from the first cell that is shared by the object and the region.
+                    if ( x != std::max( first.x, object.first.x ) || y != std::max( first.y, object.first.y ) )
+                        continue;
+
+                    if ( object.aabb.intersect( region ) )
+                        func( object.userId );
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Find all pairs of objects that intersect each other.
+    /// </summary>
+    /// <param name="func">The function to invoke with the user ids of every pair of intersecting objects.</param>
+    template<typename Func>
+    void forEachPair( Func&& func ) const
+    {
+        for ( const auto& bucket: m_Buckets )
+        {
+            for ( size_t i = 0; i < bucket.size(); ++i )
+            {
+                const Entry&  a       = bucket[i];
+                const Object& objectA = m_Objects[a.handle];
+
+                for ( size_t j = i + 1; j < bucket.size(); ++j )
+                {
+                    const Entry& b = bucket[j];
+                    if ( a.x != b.x || a.y != b.y )
+                        continue;
+
+                    const Object& objectB = m_Objects[b.handle];
+
+                    // Only report the pair from the first cell that is shared by both objects.
+                    if ( a.x != std::max( objectA.first.x, objectB.first.x ) || a.y != std::max( objectA.first.y, objectB.first.y ) )
+                        continue;
+
+                    if ( objectA.aabb.intersect( objectB.aabb ) )
+                        func( objectA.userId, objectB.userId );
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Get the bounds of an object.
+    /// </summary>
+    const AABB& getAABB( Handle handle ) const noexcept
+    {
+        assert( handle < m_Objects.size() );
+        return m_Objects[handle].aabb;
+    }
+
+    /// <summary>
+    /// Get the user id of an object.
+    /// </summary>
+    uint32_t getUserId( Handle handle ) const noexcept
+    {
+        assert( handle < m_Objects.size() );
+        return m_Objects[handle].userId;
+    }
+
+    /// <summary>
+    /// Get the number of objects in the spatial hash.
+    /// </summary>
+    size_t size() const noexcept
+    {
+        return m_Size;
+    }
+
+    /// <summary>
+    /// Get the size of the cells of the grid.
+    /// </summary>
+    float getCellSize() const noexcept
+    {
+        return 1.0f / m_InvCellSize;
+    }
+
+private:
+    struct Object
+    {
+        AABB       aabb;
+        glm::ivec2 first { 0 };  // The first cell that is overlapped by the object.
+        glm::ivec2 last { -1 };  // The last cell (inclusive) that is overlapped by the object.
+        uint32_t   userId = 0u;
+        bool       alive  = false;
+    };
+
+    struct Entry
+    {
+        Handle  handle;
+        int32_t x;
+        int32_t y;
+    };
+
+    glm::ivec2 getCell( const glm::vec2& p ) const noexcept
+    {
+        // Limit the cell coordinates to avoid overflowing an int for points that are very far away.
+        constexpr float limit = static_cast<float>( 1 << 24 );
+
+        return { static_cast<int>( std::clamp( std::floor( p.x * m_InvCellSize ), -limit, limit ) ),
+                 static_cast<int>( std::clamp( std::floor( p.y * m_InvCellSize ), -limit, limit ) ) };
+    }
+
+    size_t getBucket( int x, int y ) const noexcept
+    {
+        const uint32_t h = ( static_cast<uint32_t>( x ) * 73856093u ) ^ ( static_cast<uint32_t>( y ) * 19349663u );
+        return h & ( m_Buckets.size() - 1 );
+    }
+
+    void addEntries( Handle handle )
+    {
+        const Object& object = m_Objects[handle];
+        for ( int y = object.first.y; y <= object.last.y; ++y )
+        {
+            for ( int x = object.first.x; x <= object.last.x; ++x )
+                m_Buckets[getBucket( x, y )].push_back( { handle, x, y } );
+        }
+    }
+
+    void removeEntries( Handle handle )
+    {
+        const Object& object = m_Objects[handle];
+        for ( int y = object.first.y; y <= object.last.y; ++y )
+        {
+            for ( int x = object.first.x; x <= object.last.x; ++x )
+            {
+                auto& bucket = m_Buckets[getBucket( x, y )];
+                auto  iter   = std::ranges::find_if( bucket, [&]( const Entry& e ) { return e.handle == handle && e.x == x && e.y == y; } );
+
+                assert( iter != bucket.end() );
+
+                // The order of the entries in a bucket doesn't matter.
+                *iter = bucket.back();
+                bucket.pop_back();
+            }
+        }
+    }
+
+    float                           m_InvCellSize;
+    std::vector<std::vector<Entry>> m_Buckets;
+    std::vector<Object>             m_Objects;
+    std::vector<Handle>             m_FreeHandles;
+    size_t                          m_Size = 0u;
+};
+}  // namespace math
+}  // namespace cpprast
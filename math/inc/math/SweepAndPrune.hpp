@@ -0,0 +1,149 @@
+#pragma once
+
+#include "AABB.hpp"
+#include "WorkerPool.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A sort-and-sweep broadphase that finds the pairs of overlapping AABBs.
+///
+/// The boxes are kept sorted by their minimum x coordinate. The order is restored with an insertion sort on every
+/// update, which is close to linear when the boxes only move a little between updates (frame coherence).
+/// The sorted boxes are then swept to find the pairs that overlap, and the pairs are compared with the
+/// previous update to report the pairs that started and stopped overlapping.
+///
+/// The sweep can be split over multiple threads: the sorted array is divided into segments along the x-axis,
+/// and every thread sweeps the boxes that start in its segment. The threads are started by the first update that
+/// uses them, and are kept for later updates.
+///
+/// Once the broadphase has grown to its working set (and number of threads), updating it doesn't allocate memory.
+/// </summary>
+class SweepAndPrune
+{
+public:
+    /// <summary>
+    /// A handle to an object in the broadphase.
+    /// </summary>
+    using Handle = uint32_t;
+
+    /// <summary>
+    /// A pair of user ids.
+    /// </summary>
+    using Pair = std::pair<uint32_t, uint32_t>;
+
+    /// <summary>
+    /// Insert an object. The object takes part in the next update.
+    /// </summary>
+    /// <param name="aabb">The bounds of the object.</param>
+    /// <param name="userId">The user id that is reported in pairs.</param>
+    /// <returns>The handle of the object.</returns>
+    Handle insert( const AABB& aabb, uint32_t userId );
+
+    /// <summary>
+    /// Move (or resize) an object. The new bounds are used by the next update.
+    /// </summary>
+    /// <param name="handle">The handle of the object.</param>
+    /// <param name="aabb">The new bounds of the object.</param>
+    void move( Handle handle, const AABB& aabb ) noexcept;
+
+    /// <summary>
+    /// Remove an object. Its pairs are reported as removed by the next update.
+    /// The handle may be reused after the next update.
+    /// </summary>
+    /// <param name="handle">The handle of the object to remove.</param>
+    void remove( Handle handle );
+
+    /// <summary>
+    /// Sort the boxes and find the overlapping pairs.
+    /// </summary>
+    /// <param name="numThreads">(Optional) The number of threads to sweep the boxes with. Default: 1 (the calling thread, no worker threads are started).</param>
+    void update( uint32_t numThreads = 1u );
+
+    /// <summary>
+    /// Get the pairs of objects that overlap (as of the last update).
+    /// </summary>
+    std::span<const Pair> getPairs() const noexcept
+    {
+        return m_Pairs;
+    }
+
+    /// <summary>
+    /// Get the pairs of objects that started overlapping in the last update.
+    /// </summary>
+    std::span<const Pair> getAddedPairs() const noexcept
+    {
+        return m_AddedPairs;
+    }
+
+    /// <summary>
+    /// Get the pairs of objects that stopped overlapping (or were removed) in the last update.
+    /// </summary>
+    std::span<const Pair> getRemovedPairs() const noexcept
+    {
+        return m_RemovedPairs;
+    }
+
+    /// <summary>
+    /// Get the bounds of an object.
+    /// </summary>
+    const AABB& getAABB( Handle handle ) const noexcept
+    {
+        return m_Objects[handle].aabb;
+    }
+
+    /// <summary>
+    /// Get the number of objects in the broadphase.
+    /// </summary>
+    size_t size() const noexcept
+    {
+        return m_Objects.size() - m_FreeHandles.size() - m_RemovedHandles.size();
+    }
+
+private:
+    struct Object
+    {
+        AABB     aabb;
+        uint32_t userId = 0u;
+        bool     alive  = false;
+    };
+
+    // The sorted copy of the bounds that is swept. Stored by value so the sweep doesn't need to look up the objects.
+    struct Entry
+    {
+        float  minX;
+        float  maxX;
+        float  minY;
+        float  maxY;
+        Handle handle;
+    };
+
+    // Sweep the entries [begin, end) and append the keys of the overlapping pairs.
+    void sweep( size_t begin, size_t end, std::vector<uint64_t>& pairs ) const;
+
+    std::vector<Object> m_Objects;
+    std::vector<Entry>  m_Entries;          // Sorted by minX.
+    std::vector<Handle> m_InsertedHandles;  // Objects that were inserted since the last update.
+    std::vector<Handle> m_RemovedHandles;   // Objects that were removed since the last update.
+    std::vector<Handle> m_FreeHandles;
+
+    std::unique_ptr<WorkerPool>        m_Workers;       // Created by the first multithreaded update.
+    std::vector<std::vector<uint64_t>> m_SegmentPairs;  // The pairs found by each thread.
+    std::vector<uint64_t>              m_PairKeys;      // The sorted keys (handle << 32 | handle) of the overlapping pairs.
+    std::vector<uint64_t>              m_PrevPairKeys;
+    std::vector<uint64_t>              m_Scratch;
+
+    std::vector<Pair> m_Pairs;
+    std::vector<Pair> m_AddedPairs;
+    std::vector<Pair> m_RemovedPairs;
+};
+}  // namespace math
+}  // namespace cpprast
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>  // For std::addressof
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cpprast
+{
+inline namespace math
+{
+/// <summary>
+/// A set of persistent threads that run the parts of a job in parallel.
+///
+/// The threads are started when the pool grows, and wait for work between jobs. Once the pool has grown to the
+/// number of threads it's used with, running a job doesn't allocate memory or start threads.
+///
+/// A pool runs one job at a time and must only be used from one thread.
+/// </summary>
+class WorkerPool
+{
+public:
+    /// <summary>
+    /// Create a worker pool.
+    /// </summary>
+    /// <param name="numThreads">(Optional) The number of threads to run jobs with, including the calling thread. Default: 1 (no worker threads).</param>
+    explicit WorkerPool( uint32_t numThreads = 1u );
+
+    /// <summary>
+    /// Stop and join the worker threads.
+    /// </summary>
+    ~WorkerPool();
+
+    WorkerPool( const WorkerPool& )            = delete;
+    WorkerPool& operator=( const WorkerPool& ) = delete;
+
+    /// <summary>
+    /// Start worker threads so that jobs can run on (at least) the given number of threads. The pool never shrinks.
+    /// </summary>
+    /// <param name="numThreads">The number of threads, including the calling thread.</param>
+    void reserve( uint32_t numThreads );
+
+    /// <summary>
+    /// Get the number of threads that jobs can run on without starting new threads (including the calling thread).
+    /// </summary>
+    uint32_t getNumThreads() const noexcept
+    {
+        return static_cast<uint32_t>( m_Workers.size() ) + 1u;
+    }
+
+    /// <summary>
+    /// Run a job on multiple threads and wait for it to finish.
+    /// The job is called once for every part, the first part runs on the calling thread.
+    /// The pool grows if it has fewer threads than parts.
+    /// </summary>
+    /// <param name="numParts">The number of parts of the job.</param>
+    /// <param name="job">The function that runs a part of the job: void( uint32_t part ). It must not throw.</param>
+    template<typename Job>
+    void run( uint32_t numParts, Job&& job )
+    {
+        using JobType = std::remove_reference_t<Job>;
+
+        run( numParts, []( void* context, uint32_t part ) { ( *static_cast<JobType*>( context ) )( part ); },
+             const_cast<void*>( static_cast<const void*>( std::addressof( job ) ) ) );
+    }
+
+    /// <summary>
+    /// Run a job on multiple threads and wait for it to finish.
+    /// </summary>
+    /// <param name="numParts">The number of parts of the job.</param>
+    /// <param name="invoke">The function that runs a part of the job. It must not throw.</param>
+    /// <param name="context">The context that is passed to the function.</param>
+    void run( uint32_t numParts, void ( *invoke )( void* context, uint32_t part ), void* context );
+
+private:
+    // The loop of a worker thread. The worker runs the part of every job that matches its index.
+    void work( uint32_t part, uint64_t generation );
+
+    std::vector<std::jthread> m_Workers;
+
+    std::mutex              m_Mutex;
+    std::condition_variable m_JobReady;
+    std::condition_variable m_JobDone;
+
+    void ( *m_Invoke )( void*, uint32_t ) = nullptr;
+    void*    m_Context                    = nullptr;
+    uint32_t m_NumParts                   = 0u;
+    uint32_t m_Pending                    = 0u;  // The number of parts that are still running on worker threads.
+    uint64_t m_Generation                 = 0u;  // Incremented for every job, so the workers can tell a new job from a spurious wakeup.
+    bool     m_Stop                       = false;
+};
+}  // namespace math
+}  // namespace cpprast
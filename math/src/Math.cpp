@@ -1,3 +1,9 @@
 #include <math/AABB.hpp>
+#include <math/AABBArray.hpp>
+#include <math/BitGrid.hpp>
+#include <math/FixedPoint.hpp>
+#include <math/LooseQuadtree.hpp>
 #include <math/Math.hpp>
+#include <math/Simd.hpp>
+#include <math/SpatialHash.hpp>
 #include <math/Viewport.hpp>
\ No newline at end of file
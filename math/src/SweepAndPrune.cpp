@@ -0,0 +1,170 @@
+#include <math/SweepAndPrune.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>  // For std::back_inserter
+
+using namespace cpprast::math;
+
+namespace
+{
+constexpr uint64_t makeKey( uint32_t a, uint32_t b ) noexcept
+{
+    return a < b ? ( uint64_t { a } << 32 ) | b : ( uint64_t { b } << 32 ) | a;
+}
+}  // namespace
+
+SweepAndPrune::Handle SweepAndPrune::insert( const AABB& aabb, uint32_t userId )
+{
+    Handle handle;
+    if ( !m_FreeHandles.empty() )
+    {
+        handle = m_FreeHandles.back();
+        m_FreeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<Handle>( m_Objects.size() );
+        m_Objects.emplace_back();
+    }
+
+    m_Objects[handle] = { aabb, userId, true };
+    m_InsertedHandles.push_back( handle );
+
+    return handle;
+}
+
+void SweepAndPrune::move( Handle handle, const AABB& aabb ) noexcept
+{
+    assert( handle < m_Objects.size() && m_Objects[handle].alive );
+    m_Objects[handle].aabb = aabb;
+}
+
+void SweepAndPrune::remove( Handle handle )
+{
+    assert( handle < m_Objects.size() && m_Objects[handle].alive );
+
+    // The handle is only recycled after the next update so that the removed pairs can still report its user id.
+    m_Objects[handle].alive = false;
+    m_RemovedHandles.push_back( handle );
+}
+
+void SweepAndPrune::sweep( size_t begin, size_t end, std::vector<uint64_t>& pairs ) const
+{
+    const size_t numEntries = m_Entries.size();
+    for ( size_t i = begin; i < end; ++i )
+    {
+        const Entry& a = m_Entries[i];
+
+        // Only the boxes that start before this box ends can overlap it.
+        for ( size_t j = i + 1; j < numEntries && m_Entries[j].minX <= a.maxX; ++j )
+        {
+            const Entry& b = m_Entries[j];
+            if ( a.minY <= b.maxY && a.maxY >= b.minY )
+                pairs.push_back( makeKey( a.handle, b.handle ) );
+        }
+    }
+}
+
+void SweepAndPrune::update( uint32_t numThreads )
+{
+    // Remove the entries of removed objects (the remaining entries stay sorted).
+    if ( !m_RemovedHandles.empty() )
+        std::erase_if( m_Entries, [this]( const Entry& e ) { return !m_Objects[e.handle].alive; } );
+
+    // Refresh the bounds of the entries from the objects.
+    for ( Entry& e: m_Entries )
+    {
+        const AABB& aabb = m_Objects[e.handle].aabb;
+        e                = { aabb.min.x, aabb.max.x, aabb.min.y, aabb.max.y, e.handle };
+    }
+
+    const size_t numSorted = m_Entries.size();
+    for ( Handle handle: m_InsertedHandles )
+    {
+        // An object can be inserted and removed again before an update.
+        if ( !m_Objects[handle].alive )
+            continue;
+
+        const AABB& aabb = m_Objects[handle].aabb;
+        m_Entries.push_back( { aabb.min.x, aabb.max.x, aabb.min.y, aabb.max.y, handle } );
+    }
+
+    // New entries can be anywhere in the order, so a full sort is cheaper if there are many of them.
+    // Otherwise restore the order with an insertion sort, which is close to linear if the boxes didn't move much.
+    const size_t numInserted = m_Entries.size() - numSorted;
+    if ( numInserted > 64 && numInserted > numSorted / 16 )
+    {
+        std::ranges::sort( m_Entries, {}, &Entry::minX );
+    }
+    else
+    {
+        for ( size_t i = 1; i < m_Entries.size(); ++i )
+        {
+            const Entry e = m_Entries[i];
+            size_t      j = i;
+            for ( ; j > 0 && m_Entries[j - 1].minX > e.minX; --j )
+                m_Entries[j] = m_Entries[j - 1];
+
+            m_Entries[j] = e;
+        }
+    }
+
+    // Sweep the sorted boxes. Every thread sweeps the boxes that start in its own segment.
+    numThreads = std::clamp<uint32_t>( numThreads, 1u, static_cast<uint32_t>( std::max<size_t>( m_Entries.size() / 256, 1 ) ) );
+    m_SegmentPairs.resize( std::max<size_t>( m_SegmentPairs.size(), numThreads ) );
+
+    const size_t segmentSize  = ( m_Entries.size() + numThreads - 1 ) / numThreads;
+    auto         sweepSegment = [this, segmentSize]( uint32_t segment ) {
+        const size_t begin = std::min( segment * segmentSize, m_Entries.size() );
+        const size_t end   = std::min( begin + segmentSize, m_Entries.size() );
+
+        m_SegmentPairs[segment].clear();
+        sweep( begin, end, m_SegmentPairs[segment] );
+    };
+
+    if ( numThreads > 1 )
+    {
+        if ( !m_Workers )
+            m_Workers = std::make_unique<WorkerPool>();
+
+        m_Workers->run( numThreads, sweepSegment );
+    }
+    else
+    {
+        sweepSegment( 0 );
+    }
+
+    // Gather and sort the pairs so they can be compared with the previous update.
+    std::swap( m_PairKeys, m_PrevPairKeys );
+    m_PairKeys.clear();
+    for ( uint32_t segment = 0; segment < numThreads; ++segment )
+        m_PairKeys.insert( m_PairKeys.end(), m_SegmentPairs[segment].begin(), m_SegmentPairs[segment].end() );
+
+    std::ranges::sort( m_PairKeys );
+
+    auto toPair = [this]( uint64_t key ) {
+        return Pair { m_Objects[static_cast<uint32_t>( key >> 32 )].userId, m_Objects[static_cast<uint32_t>( key )].userId };
+    };
+
+    m_Pairs.clear();
+    for ( uint64_t key: m_PairKeys )
+        m_Pairs.push_back( toPair( key ) );
+
+    m_AddedPairs.clear();
+    m_Scratch.clear();
+    std::ranges::set_difference( m_PairKeys, m_PrevPairKeys, std::back_inserter( m_Scratch ) );
+    for ( uint64_t key: m_Scratch )
+        m_AddedPairs.push_back( toPair( key ) );
+
+    m_RemovedPairs.clear();
+    m_Scratch.clear();
+    std::ranges::set_difference( m_PrevPairKeys, m_PairKeys, std::back_inserter( m_Scratch ) );
+    for ( uint64_t key: m_Scratch )
+        m_RemovedPairs.push_back( toPair( key ) );
+
+    // The removed pairs have been reported, so the handles of removed objects can be reused.
+    m_FreeHandles.insert( m_FreeHandles.end(), m_RemovedHandles.begin(), m_RemovedHandles.end() );
+    m_RemovedHandles.clear();
+    m_InsertedHandles.clear();
+}
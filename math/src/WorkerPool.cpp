@@ -0,0 +1,91 @@
+#include <math/WorkerPool.hpp>
+
+#include <cassert>
+
+using namespace cpprast::math;
+
+WorkerPool::WorkerPool( uint32_t numThreads )
+{
+    reserve( numThreads );
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::scoped_lock lock { m_Mutex };
+        m_Stop = true;
+    }
+    m_JobReady.notify_all();
+
+    // Joins the worker threads.
+    m_Workers.clear();
+}
+
+void WorkerPool::reserve( uint32_t numThreads )
+{
+    if ( numThreads <= getNumThreads() )
+        return;
+
+    // No job is running (the pool is only used from one thread), so the generation can't change while the workers start.
+    m_Workers.reserve( numThreads - 1 );
+    while ( getNumThreads() < numThreads )
+        m_Workers.emplace_back( &WorkerPool::work, this, getNumThreads(), m_Generation );
+}
+
+void WorkerPool::run( uint32_t numParts, void ( *invoke )( void* context, uint32_t part ), void* context )
+{
+    if ( numParts == 0 )
+        return;
+
+    if ( numParts > 1 )
+    {
+        reserve( numParts );
+
+        {
+            std::scoped_lock lock { m_Mutex };
+            m_Invoke   = invoke;
+            m_Context  = context;
+            m_NumParts = numParts;
+            m_Pending  = numParts - 1;
+            ++m_Generation;
+        }
+        m_JobReady.notify_all();
+    }
+
+    invoke( context, 0 );
+
+    if ( numParts > 1 )
+    {
+        std::unique_lock lock { m_Mutex };
+        m_JobDone.wait( lock, [this] { return m_Pending == 0; } );
+    }
+}
+
+void WorkerPool::work( uint32_t part, uint64_t generation )
+{
+    std::unique_lock lock { m_Mutex };
+
+    while ( true )
+    {
+        m_JobReady.wait( lock, [this, generation] { return m_Stop || m_Generation != generation; } );
+        if ( m_Stop )
+            return;
+
+        generation = m_Generation;
+
+        // Jobs with fewer parts than threads leave the last workers idle.
+        if ( part >= m_NumParts )
+            continue;
+
+        auto* const invoke  = m_Invoke;
+        void* const context = m_Context;
+
+        lock.unlock();
+        invoke( context, part );
+        lock.lock();
+
+        assert( m_Pending > 0 );
+        if ( --m_Pending == 0 )
+            m_JobDone.notify_one();
+    }
+}
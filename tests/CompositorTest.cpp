@@ -0,0 +1,89 @@
+#include <graphics/Compositor.hpp>
+
+#include <cstdio>
+#include <cstdlib>  // For std::abs, EXIT_SUCCESS, EXIT_FAILURE
+#include <memory>
+
+using namespace cpprast;
+
+namespace
+{
+int g_Failures = 0;
+
+// Colors are blended with 8-bit fixed-point math, so compositing a layer and drawing directly can round differently.
+constexpr int Tolerance = 2;
+
+void checkColor( const char* name, const Color& actual, const Color& expected )
+{
+    const bool equal = std::abs( actual.channels.r - expected.channels.r ) <= Tolerance && std::abs( actual.channels.g - expected.channels.g ) <= Tolerance &&
+                       std::abs( actual.channels.b - expected.channels.b ) <= Tolerance && std::abs( actual.channels.a - expected.channels.a ) <= Tolerance;
+
+    if ( !equal )
+    {
+        std::printf( "FAILED: %s: expected (%d, %d, %d, %d), got (%d, %d, %d, %d)\n", name, expected.channels.r, expected.channels.g, expected.channels.b, expected.channels.a,
+                     actual.channels.r, actual.channels.g, actual.channels.b, actual.channels.a );
+        ++g_Failures;
+    }
+}
+
+std::shared_ptr<Image> makeImage( uint32_t width, uint32_t height, const Color& color )
+{
+    return std::make_shared<Image>( width, height, color );
+}
+
+// A translucent sprite that overlaps an opaque sprite in a layer must composite like drawing both sprites directly on the target.
+void testTranslucentOverOpaque()
+{
+    constexpr uint32_t Width  = 16;
+    constexpr uint32_t Height = 8;
+
+    const Color  background { 20, 40, 60, 255 };
+    const Sprite opaque { makeImage( 8, 8, Color { 200, 0, 0, 255 } ), BlendMode::AlphaBlendLayer };
+    const Sprite translucent { makeImage( 8, 8, Color { 0, 0, 255, 128 } ), BlendMode::AlphaBlendLayer };
+
+    auto drawSprites = [&]( Rasterizer& rasterizer ) {
+        rasterizer.drawSprite( opaque, 0, 0 );
+        rasterizer.drawSprite( translucent, 4, 0 );
+    };
+
+    // The reference: draw the sprites with regular alpha blending directly over the background.
+    Image      expected { Width, Height, background };
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &expected;
+    rasterizer.drawSprite( Sprite { opaque.getImage(), BlendMode::AlphaBlend }, 0, 0 );
+    rasterizer.drawSprite( Sprite { translucent.getImage(), BlendMode::AlphaBlend }, 4, 0 );
+
+    Compositor compositor;
+    compositor.addLayer( drawSprites );
+
+    Image target { Width, Height };
+    compositor.composite( target, background );
+
+    // AlphaBlend writes the alpha of the sprite to the reference, but the composited target is opaque (like the background).
+    auto opaqueColor = []( Color color ) {
+        color.channels.a = 255;
+        return color;
+    };
+
+    checkColor( "opaque", target( 2, 2 ), opaqueColor( expected( 2, 2 ) ) );
+    checkColor( "translucent over opaque", target( 6, 2 ), opaqueColor( expected( 6, 2 ) ) );
+    checkColor( "translucent over background", target( 10, 2 ), opaqueColor( expected( 10, 2 ) ) );
+    checkColor( "background", target( 14, 2 ), opaqueColor( expected( 14, 2 ) ) );
+
+    // The layer is opaque where the translucent sprite overlaps the opaque sprite, and translucent where it doesn't.
+    const Image& layer = compositor.getLayer( 0 ).getImage();
+    checkColor( "layer: translucent over opaque", layer( 6, 2 ), Color { 99, 0, 128, 255 } );
+    checkColor( "layer: translucent", layer( 10, 2 ), Color { 0, 0, 128, 128 } );
+}
+}  // namespace
+
+int main()
+{
+    testTranslucentOverOpaque();
+
+    if ( g_Failures > 0 )
+        return EXIT_FAILURE;
+
+    std::printf( "All tests passed.\n" );
+    return EXIT_SUCCESS;
+}